@@ -31,18 +31,17 @@ RLLearner::RLLearner(ALEInterface& ale, Parameters *param){
 		actions = ale.getLegalActionSet();
 	}
 	numActions = actions.size();
+	rng = Random(param->getSeed());
 }
 
 int RLLearner::epsilonGreedy(vector<double> &QValues){
 	randomActionTaken = 0;
 
-	int action = Mathematics::argmax(QValues);
+	int action = Mathematics::argmax(QValues, rng);
 	//With probability epsilon: a <- random action in A(s)
-	int random = rand();
-	if((random % int(nearbyint(1.0/epsilon))) == 0) {
-	//if((rand()%int(1.0/epsilon)) == 0){
+	if(rng.nextDouble() < epsilon){
 		randomActionTaken = 1;
-		action = rand() % numActions;
+		action = rng.nextInt(numActions);
 	}
 	return action;
 }
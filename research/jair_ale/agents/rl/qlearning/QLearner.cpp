@@ -126,7 +126,7 @@ void QLearner::experienceReplay(int maxFeatVectorNorm){
 	int nextAction, mSample;
 	for(int i = 0; i < BATCH_SIZE; i++){
 
-		mSample = rand() % min((unsigned long) MEMORY_SIZE, idxExperience);
+		mSample = rng.nextInt(min((unsigned long) MEMORY_SIZE, idxExperience));
 		int a    = memory[mSample].action;
 
 		updateQValues(memory[mSample].F, Q, w);
@@ -139,7 +139,7 @@ void QLearner::experienceReplay(int maxFeatVectorNorm){
 				Qnext[j] = 0;
 			}
 		}
-		nextAction = Mathematics::argmax(Qnext);
+		nextAction = Mathematics::argmax(Qnext, rng);
 		delta = memory[mSample].reward + gamma * Qnext[nextAction] - Q[a];
 		
 	
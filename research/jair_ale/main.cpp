@@ -44,7 +44,6 @@ void printBasicInfo(Parameters param){
 int main(int argc, char** argv){
 	//Reading parameters from file defined as input in the run command:
 	Parameters param(argc, argv);
-	srand(param.getSeed());
 	//Using RAM features:
 	BPROFeatures features(&param);
 	//BasicFeatures features(&param);
@@ -12,7 +12,6 @@
 
 #include "OptionSarsa.hpp"
 #include "../../../../src/common/Timer.hpp"
-#include "../../../../src/features/RAMFeatures.hpp"
 
 OptionSarsa::OptionSarsa(ALEInterface& ale, Features *features, Parameters *param) : RLLearner(ale, features, param) {
 	delta = 0.0;
@@ -166,32 +165,15 @@ void OptionSarsa::loadWeights(){
 	}
 }
 
-void OptionSarsa::updateTransitionVector(vector<bool> F, vector<bool> Fnext, vector<int>& transitions){
-	transitions.clear();
-	int numTransitionFeatures = F.size();
-	for(int i = 0; i < F.size(); i++){
-		if(!F[i] && Fnext[i]){ //0->1
-			transitions.push_back(i);
-		}
-		else if(F[i] && !Fnext[i]){ //1->0
-			transitions.push_back(i + numTransitionFeatures - 1);
-		}
-	}
-}
-
 void OptionSarsa::learnPolicy(ALEInterface& ale, Features *features){
 	
 	struct timeval tvBegin, tvEnd, tvDiff;
-	vector<double> reward;
+	vector<double> reward(2, 0.0);
 	double elapsedTime;
 	double cumReward = 0, prevCumReward = 0;
 	double cumIntrReward = 0, prevCumIntrReward = 0;
 	unsigned int maxFeatVectorNorm = 1;
 	sawFirstReward = 0; firstReward = 1.0;
-	//For the use of options:
-	RAMFeatures ramFeatures;
-	vector<bool> FRam, FnextRam;
-	vector<int> transitions;
 
 	//Repeat (for each episode):
 	int episode, totalNumberFrames = 0;
@@ -206,9 +188,7 @@ void OptionSarsa::learnPolicy(ALEInterface& ale, Features *features){
 			nonZeroElig[a].clear();
 		}
 		F.clear();
-		FRam.clear();
 		features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), F);
-		ramFeatures.getCompleteFeatureVector(ale.getScreen(), ale.getRAM(), FRam);
 		updateQValues(F, Q);
 		currentAction = epsilonGreedy(Q);
 		//Repeat(for each step of episode) until game is over:
@@ -216,25 +196,19 @@ void OptionSarsa::learnPolicy(ALEInterface& ale, Features *features){
 
 		//This also stops when the maximum number of steps per episode is reached
 		while(!ale.game_over()){
-			reward.clear();
-			reward.push_back(0.0);
-			reward.push_back(0.0);
 			updateQValues(F, Q);			
 
 			sanityCheck();
 			//Take action, observe reward and next state:
-			act(ale, currentAction, transitions, reward);
+			act(ale, currentAction, reward);
 			cumIntrReward += reward[0];
 			cumReward  += reward[1];
 			if(!ale.game_over()){
 				//Obtain active features in the new state:
 				Fnext.clear();
-				FnextRam.clear();
 				features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
-				ramFeatures.getCompleteFeatureVector(ale.getScreen(), ale.getRAM(), FnextRam);
 				updateQValues(Fnext, Qnext);     //Update Q-values for the new active features
 				nextAction = epsilonGreedy(Qnext);
-				updateTransitionVector(FRam, FnextRam, transitions);
 			}
 			else{
 				nextAction = 0;
@@ -258,8 +232,7 @@ void OptionSarsa::learnPolicy(ALEInterface& ale, Features *features){
 					w[a][idx] = w[a][idx] + (alpha/maxFeatVectorNorm) * delta * e[a][idx];
 				}
 			}
-			F = Fnext;
-			FRam = FnextRam;
+			F.swap(Fnext);
 			currentAction = nextAction;
 		}
 		gettimeofday(&tvEnd, NULL);
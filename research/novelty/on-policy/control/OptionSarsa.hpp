@@ -68,8 +68,6 @@ class OptionSarsa : public RLLearner{
  		* Loads the weights saved in a file. Each line will contain a weight.
  		*/		
 		void loadWeights();
-
-		void updateTransitionVector(vector<bool> F, vector<bool> Fnext, vector<int>& transitions);
 	public:
 		OptionSarsa(ALEInterface& ale, Features *features, Parameters *param);
 		/**
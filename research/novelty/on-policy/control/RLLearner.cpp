@@ -9,6 +9,7 @@
 #endif
 
 #include <fstream>
+#include <string.h>
 
 RLLearner::RLLearner(ALEInterface& ale, Features *features, Parameters *param){
 	randomActionTaken   = 0;
@@ -30,11 +31,13 @@ RLLearner::RLLearner(ALEInterface& ale, Features *features, Parameters *param){
 		actions = ale.getLegalActionSet();
 	}
 	numActions = actions.size();
+	rng = Random(param->getSeed());
 
 	//Reading file containing the vector that describes the reward for the option learning
 	//The first X positions encode the transition 0->1 and the other X encode 1->0.
 	pathToRewardDescription = param->getOptionRewardPath();
 	std::ifstream infile1(pathToRewardDescription);
+	vector<double> option, mean, std;
 	double value;
 	while(infile1 >> value){
 		option.push_back(value);
@@ -48,18 +51,58 @@ RLLearner::RLLearner(ALEInterface& ale, Features *features, Parameters *param){
 	while(infile3 >> value){
 		std.push_back(value);
 	}
+
+	//Folding the standardization into one weight per transition. Constant coordinates have
+	//std 0 and are not scaled, as done by the StandardScaler used to compute the option:
+	transitionWeights.assign(2 * RAM_BITS, 0.0);
+	transitionBias = 0.0;
+	for(unsigned int i = 0; i < option.size() && i < transitionWeights.size(); i++){
+		double scale = i < std.size() && std[i] != 0 ? std[i] : 1.0;
+		double center = i < mean.size() ? mean[i] : 0.0;
+		transitionWeights[i] = option[i] / scale;
+		transitionBias -= option[i] * center / scale;
+	}
+	memset(ramBefore, 0, sizeof(ramBefore));
+	memset(ramAfter, 0, sizeof(ramAfter));
+}
+
+void RLLearner::packRAM(const ALERAM &ram, uint64_t *words){
+	for(int w = 0; w < RAM_WORDS; w++){
+		uint64_t word = 0;
+		for(int k = 0; k < 8; k++){
+			word |= (uint64_t) ram.get(8 * w + k) << (8 * k);
+		}
+		words[w] = word;
+	}
+}
+
+double RLLearner::getOptionReward(){
+	double r = transitionBias;
+	for(int w = 0; w < RAM_WORDS; w++){
+		uint64_t flipped = ramBefore[w] ^ ramAfter[w];
+		uint64_t turnedOn = flipped & ramAfter[w];
+		uint64_t turnedOff = flipped & ramBefore[w];
+		//Only the bits that flipped, a few per frame, are visited:
+		while(turnedOn){
+			r += transitionWeights[64 * w + __builtin_ctzll(turnedOn)];
+			turnedOn &= turnedOn - 1;
+		}
+		while(turnedOff){
+			r += transitionWeights[RAM_BITS + 64 * w + __builtin_ctzll(turnedOff)];
+			turnedOff &= turnedOff - 1;
+		}
+	}
+	return r;
 }
 
 int RLLearner::epsilonGreedy(vector<double> &QValues){
 	randomActionTaken = 0;
 
-	int action = Mathematics::argmax(QValues);
+	int action = Mathematics::argmax(QValues, rng);
 	//With probability epsilon: a <- random action in A(s)
-	int random = rand();
-	if((random % int(nearbyint(1.0/epsilon))) == 0) {
-	//if((rand()%int(1.0/epsilon)) == 0){
+	if(rng.nextDouble() < epsilon){
 		randomActionTaken = 1;
-		action = rand() % numActions;
+		action = rng.nextInt(numActions);
 	}
 	return action;
 }
@@ -69,13 +112,10 @@ int RLLearner::epsilonGreedy(vector<double> &QValues){
  * pass aditional information to the running algorithm (like 'real score' if one
  * is using a surrogate reward function).
  */
-void RLLearner::act(ALEInterface& ale, int action, vector<int>& transitions, vector<double> &reward){
+void RLLearner::act(ALEInterface& ale, int action, vector<double> &reward){
 	double r_alg = 0.0, r_real = 0.0;
-	
-	for(int i = 0; i < transitions.size(); i++){
-		transitions[i] = (transitions[i] - mean[i])/std[i];
-	}
 
+	packRAM(ale.getRAM(), ramBefore);
 	r_real = ale.act(actions[action]);
 	if(toUseOnlyRewardSign){
 		if(r_real > 0){ 
@@ -85,9 +125,8 @@ void RLLearner::act(ALEInterface& ale, int action, vector<int>& transitions, vec
 			r_alg = -1.0;
 		}
 	} else{
-		for(int i = 0; i < transitions.size(); i++){
-			r_alg += option[transitions[i]];
-		}
+		packRAM(ale.getRAM(), ramAfter);
+		r_alg = getOptionReward();
 		/*
 		if(r_alg != 0.0){
 			if(!sawFirstReward){
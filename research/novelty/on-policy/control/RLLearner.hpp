@@ -10,20 +10,34 @@
 #define AGENT_H
 #include "Agent.hpp"
 #endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../../../src/common/Random.hpp"
+#endif
+#include <stdint.h>
+
+//The RAM is seen as 1024 bits, packed in 16 words of 64 bits:
+#define RAM_BITS  1024
+#define RAM_WORDS 16
 
 class RLLearner : public Agent{
 	protected:
 		ActionVect actions;
 
-		vector<double> option;
-		vector<double> mean;
-		vector<double> std;
+		//The option's reward is the dot product between the option and the standardized transition
+		//vector, (x - mean) / std. Since x is binary it is a constant plus the sum of option / std
+		//over the bits that flipped; the first RAM_BITS positions encode 0->1, the others 1->0.
+		vector<double> transitionWeights; //option[i] / std[i]
+		double transitionBias;            //Sum of -option[i] * mean[i] / std[i]
+		uint64_t ramBefore[RAM_WORDS];    //RAM before the last action taken
+		uint64_t ramAfter[RAM_WORDS];     //RAM after the last action taken
 		string pathToRewardDescription;
 		string pathToStatsDescription;
 
 		double gamma, epsilon;
 		double firstReward;
 		bool   sawFirstReward;
+		Random rng;                     //Random number generator of this agent, seeded with the seed from the command line
 
 		int    toUseOnlyRewardSign, toBeOptimistic;
 		int    randomActionTaken, numActions;
@@ -32,7 +46,8 @@ class RLLearner : public Agent{
 
 		/**
  		* It acts in the environment and makes the proper operations in the reward signal (normalizing,
- 		* being optimistic, etc).
+ 		* being optimistic, etc). The reward given to the algorithm is the option's reward for the RAM
+ 		* bits that flipped when taking the action.
  		*
  		* @param ALEInterface& ale Arcade Learning Environment interface: object used to define agents'
  		*        actions, obtain simulator screen, RAM, etc.
@@ -43,7 +58,18 @@ class RLLearner : public Agent{
  		* the reward to be used by the RL algorithm is returned; in the second position, the game score is
  		* returned.
  		*/
-		void act(ALEInterface& ale, int action, vector<int> &transitions, vector<double> &reward);
+		void act(ALEInterface& ale, int action, vector<double> &reward);
+		/**
+ 		* Packs the RAM in words, bit b of byte j being the bit 8 * j + b, as in RAMFeatures.
+ 		*
+ 		* @param ALERAM& ram RAM of the emulator
+ 		* @param uint64_t* words array of RAM_WORDS words that receives the bits
+ 		*/
+		void packRAM(const ALERAM &ram, uint64_t *words);
+		/**
+ 		* @return double option's reward for the transition between the RAMs in ramBefore and ramAfter
+ 		*/
+		double getOptionReward();
 
 		/**
  		* Implementation of an epsilon-greedy function. Epsilon is defined in the constructor,
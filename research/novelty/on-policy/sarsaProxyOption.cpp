@@ -32,7 +32,6 @@ void printBasicInfo(Parameters param){
 int main(int argc, char** argv){
 	//Reading parameters from file defined as input in the run command:
 	Parameters param(argc, argv);
-	srand(param.getSeed());
 
 	//Using B-PRO features:
 	BPROFeatures features(&param);
@@ -0,0 +1,90 @@
+/****************************************************************************************
+** Detection of rare transitions of the RAM bits.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef NOVELTY_TRACKER_H
+#define NOVELTY_TRACKER_H
+#include "NoveltyTracker.hpp"
+#endif
+#include <string.h>
+#include <algorithm>
+
+NoveltyTracker::NoveltyTracker(double threshold, bool toReportAll){
+	this->threshold = threshold;
+	this->toReportAll = toReportAll;
+	numTransitions.assign(NUM_TRANSITIONS, 0);
+	reset();
+}
+
+void NoveltyTracker::reset(){
+	std::fill(numTransitions.begin(), numTransitions.end(), 0);
+	memset(ramWords, 0, sizeof(ramWords));
+	latest = 0;
+	frame = 0;
+}
+
+void NoveltyTracker::packRAM(const ALERAM &ram, uint64_t *words){
+	for(int w = 0; w < RAM_WORDS; w++){
+		uint64_t word = 0;
+		for(int k = 0; k < 8; k++){
+			word |= (uint64_t) ram.get(8 * w + k) << (8 * k);
+		}
+		words[w] = word;
+	}
+}
+
+int NoveltyTracker::update(const ALERAM &ram){
+	frame++;
+	latest = 1 - latest;
+	packRAM(ram, ramWords[latest]);
+	const uint64_t *previous = ramWords[1 - latest];
+	const uint64_t *current = ramWords[latest];
+
+	int numEvents = 0;
+	bool isAnyRelevant = false;
+	//Transitions 0->1 come first, so the events are sorted:
+	for(int direction = 0; direction < 2; direction++){
+		for(int w = 0; w < RAM_WORDS; w++){
+			uint64_t flipped = previous[w] ^ current[w];
+			flipped &= direction == 0 ? current[w] : previous[w];
+			while(flipped){
+				int i = direction * RAM_BITS + 64 * w + __builtin_ctzll(flipped);
+				flipped &= flipped - 1;
+				numTransitions[i]++;
+				bool isRelevant = frame > FRAMES_TO_WAIT && double(numTransitions[i]) / frame < threshold;
+				isAnyRelevant = isAnyRelevant || isRelevant;
+				if(toReportAll || isRelevant){
+					events[numEvents++] = i;
+				}
+			}
+		}
+	}
+	return isAnyRelevant ? numEvents : 0;
+}
+
+const int* NoveltyTracker::getEvents(){
+	return events;
+}
+
+int NoveltyTracker::playRandomGame(ALEInterface &ale, Random &rng,
+	const std::function<void(const int*, int)> &onEvents){
+	reset();
+	ale.reset_game();
+
+	int reward = 0;
+	while(!ale.game_over()){
+		int nextAction = rng.nextInt(NUM_ACTS);
+		for(int i = 0; i < FRAME_SKIP; i++){
+			reward += ale.act((Action) nextAction);
+			int numEvents = update(ale.getRAM());
+			if(numEvents > 0){
+				onEvents(events, numEvents);
+			}
+		}
+	}
+	return reward;
+}
@@ -0,0 +1,97 @@
+/****************************************************************************************
+** Detection of rare transitions of the RAM bits, shared by the tools that generate the
+** samples used to discover options (generateSamples and eigenOptions).
+**
+** Each bit of the RAM can flip 0->1 or 1->0, which gives 2048 possible transitions: the
+** first 1024 encode 0->1 and the others 1->0, bit b of byte j being the bit 8 * j + b, as
+** in RAMFeatures. The frequency of a transition in a game is the number of frames in which
+** it happened divided by the number of frames so far. A transition is relevant when its
+** frequency is below a threshold, after the first FRAMES_TO_WAIT frames of the game.
+**
+** The RAM is packed in 64-bit words and compared with XOR, so only the counters of the
+** bits that flipped are updated, and the frequency is only computed for them.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../../src/common/Random.hpp"
+#endif
+#include <stdint.h>
+#include <vector>
+#include <functional>
+
+#define RAM_BITS 1024
+#define RAM_WORDS 16
+#define NUM_TRANSITIONS (2 * RAM_BITS)
+//Random play, as in the data in research/novelty/data:
+#define NUM_ACTS 18
+#define FRAME_SKIP 5
+//Frames of a game after which frequencies are considered meaningful:
+#define FRAMES_TO_WAIT 300
+
+class NoveltyTracker{
+	private:
+		double threshold;                   //Transitions with a smaller frequency are relevant
+		bool toReportAll;                   //Whether transitions that are not relevant are reported too
+		std::vector<int> numTransitions;    //Number of times each transition happened in the current game
+		int events[NUM_TRANSITIONS];        //Transitions reported in the last frame, sorted
+		uint64_t ramWords[2][RAM_WORDS];    //Packed RAMs of the last two frames
+		int latest;                         //Index of the last frame in ramWords
+		int frame;                          //Frames of the current game
+
+		/**
+ 		* Constructor declared as private to force the user to inform the threshold.
+ 		*/
+		NoveltyTracker();
+	public:
+		/**
+ 		* Constructor.
+ 		*
+ 		* @param double threshold transitions with a smaller frequency are relevant
+ 		* @param bool toReportAll whether, in a frame with a relevant transition, the transitions
+ 		*        that are not relevant are reported as well
+ 		*/
+		NoveltyTracker(double threshold, bool toReportAll);
+		/**
+ 		* Starts a new game: the counters are zeroed and the next frame is compared to a RAM
+ 		* with all bits off.
+ 		*/
+		void reset();
+		/**
+ 		* Compares the RAM of a new frame to the one of the previous frame.
+ 		*
+ 		* @param ALERAM& ram RAM of the new frame
+ 		*
+ 		* @return int number of transitions reported, 0 if none of them is relevant
+ 		*/
+		int update(const ALERAM &ram);
+		/**
+ 		* @return const int* transitions reported by the last call to update, in increasing order
+ 		*/
+		const int* getEvents();
+		/**
+ 		* Packs the RAM in RAM_WORDS words, bit b of byte j being the bit 8 * j + b.
+ 		*
+ 		* @param ALERAM& ram RAM of the emulator
+ 		* @param uint64_t* words array of RAM_WORDS words that receives the bits
+ 		*/
+		static void packRAM(const ALERAM &ram, uint64_t *words);
+		/**
+ 		* Plays a game taking a random action every FRAME_SKIP frames, from NUM_ACTS actions,
+ 		* and reports every frame with relevant transitions.
+ 		*
+ 		* @param ALEInterface& ale emulator with the ROM loaded, the game is reset first
+ 		* @param Random& rng generator that chooses the actions
+ 		* @param std::function<void(const int*, int)> onEvents function called with the
+ 		*        transitions reported and their number
+ 		*
+ 		* @return int score of the game
+ 		*/
+		int playRandomGame(ALEInterface &ale, Random &rng, const std::function<void(const int*, int)> &onEvents);
+};
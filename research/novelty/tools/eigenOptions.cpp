@@ -0,0 +1,510 @@
+/****************************************************************************************
+** Discovers eigen-options from the transitions of the RAM bits, without writing the
+** samples to disk. It does what generateSamples followed by dumpTopKEigenVectors.py does:
+** the frames with rare transitions (see NoveltyTracker.hpp) are the samples, each one
+** being the binary vector of the transitions reported, and the top eigenvectors of the
+** covariance of the standardized samples are the options.
+**
+** The samples are streamed from one of the sources below into counters of how many times
+** each transition, and each pair of transitions, was reported. Since a frame only has a
+** few transitions this takes a few operations per frame, and the counters are enough to
+** compute the mean, the standard deviation and the covariance exactly. The eigenvectors
+** are then found by subspace iteration, restricted to the transitions that were seen.
+**   -r ROM:    random play, seeds 1 to n, as generateSamples, in parallel threads;
+**   -i CORPUS: RAMs recorded while learning (see src/environment/FrameCorpus.hpp), seen as
+**              a single game whose frames are the agent's steps;
+**   -e CSV:    a file written by generateSamples (<prefix>_bits.csv).
+**
+** The output has the layout of dumpTopKEigenVectors.py, which is what OptionSarsa reads:
+** <prefix>_0.out ... <prefix>_<k-1>.out, <prefix>_mean.out and <prefix>_std.out, with one
+** value per line.
+**
+** Usage: ./eigenOptions -r pong.bin -t 0.01 -c 0 -k 5 -o ../data/eigenvalues/pong_bits_centered
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+
+#include "../../../src/common/Graphics.hpp"
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../../src/common/Random.hpp"
+#endif
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "../../../src/common/ThreadPool.hpp"
+#endif
+#ifndef FRAME_CORPUS_H
+#define FRAME_CORPUS_H
+#include "../../../src/environment/FrameCorpus.hpp"
+#endif
+#ifndef NOVELTY_TRACKER_H
+#define NOVELTY_TRACKER_H
+#include "NoveltyTracker.hpp"
+#endif
+
+#define OVERSAMPLING 10         //Extra vectors in the subspace iteration, they speed up the convergence
+#define MAX_ITERATIONS 1000
+#define TOLERANCE 1e-9          //Residual of the eigenvectors, relative to the largest eigenvalue
+
+using namespace std;
+
+string romPath, corpusPath, eventsPath;
+string outputPath;
+double freqThreshold = 0.0;
+int toReportAll = -1;
+int numEigenvectors = 5;
+int numGames = 300;
+int numThreads = 0;
+
+/**
+* Number of times each transition and each pair of transitions was reported. Counters of
+* different threads are merged by adding them, so the result does not depend on the order
+* in which the samples were seen.
+*/
+class TransitionStatistics{
+	public:
+		long long numSamples;
+		vector<long long> counts;       //Samples in which each transition was reported
+		vector<uint32_t> pairs;         //Samples in which i and j > i were reported, upper triangle
+
+		TransitionStatistics() : numSamples(0), counts(NUM_TRANSITIONS, 0),
+			pairs((size_t) NUM_TRANSITIONS * (NUM_TRANSITIONS + 1) / 2, 0){}
+
+		static size_t pairIndex(int i, int j){
+			return (size_t) i * NUM_TRANSITIONS - (size_t) i * (i - 1) / 2 + (j - i);
+		}
+		/**
+		* Adds a sample, whose transitions must be sorted and without repetitions.
+		*/
+		void add(const int *events, int numEvents){
+			numSamples++;
+			for(int a = 0; a < numEvents; a++){
+				counts[events[a]]++;
+				size_t row = pairIndex(events[a], events[a]);
+				for(int b = a + 1; b < numEvents; b++){
+					pairs[row + events[b] - events[a]]++;
+				}
+			}
+		}
+		void merge(const TransitionStatistics &other){
+			numSamples += other.numSamples;
+			for(int i = 0; i < NUM_TRANSITIONS; i++){
+				counts[i] += other.counts[i];
+			}
+			for(size_t i = 0; i < pairs.size(); i++){
+				pairs[i] += other.pairs[i];
+			}
+		}
+};
+
+void printHelp(char** argv){
+	printf("Usage:    %s (-r <ROM> | -i <CORPUS> | -e <EVENTS_CSV>) -o <OUTPUT_FILE_PREFIX> [OPTIONS]\n", argv[0]);
+	printf("   -r     path to the rom to be played at random by the agent.\n");
+	printf("   -i     path to a corpus of frames recorded while learning.\n");
+	printf("   -e     path to the _bits.csv file written by generateSamples.\n");
+	printf("   -o     %s[REQUIRED]%s prefix of the files to be written with the options and statistics.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -t     threshold to consider the transitions as 'novel', required with -r and -i.\n");
+	printf("   -c     to report transitions that are not relevant as well [0 or 1], required with -r and -i.\n");
+	printf("   -k     number of eigenvectors to be written (default: 5).\n");
+	printf("   -n     number of games played with -r, with seeds 1 to n (default: 300).\n");
+	printf("   -j     number of threads playing with -r (default: number of cores).\n");
+	printf("   -h     print this help and exit\n");
+	printf("\n");
+}
+
+void readParameters(int argc, char** argv){
+	int option = 0;
+	while ((option = getopt(argc, argv, "r:i:e:o:t:c:k:n:j:h")) != -1){
+		switch(option){
+			case 'r':
+				romPath = optarg;
+				break;
+			case 'i':
+				corpusPath = optarg;
+				break;
+			case 'e':
+				eventsPath = optarg;
+				break;
+			case 'o':
+				outputPath = optarg;
+				break;
+			case 't':
+				freqThreshold = atof(optarg);
+				break;
+			case 'c':
+				toReportAll = atoi(optarg);
+				break;
+			case 'k':
+				numEigenvectors = atoi(optarg);
+				break;
+			case 'n':
+				numGames = atoi(optarg);
+				break;
+			case 'j':
+				numThreads = atoi(optarg);
+				break;
+			case 'h':
+				printHelp(argv);
+				exit(-1);
+			default:
+				fprintf(stderr, "Try `%s -h' for more information.\n", argv[0]);
+				exit(-1);
+		}
+	}
+	if(numThreads <= 0){
+		numThreads = max(1, (int) std::thread::hardware_concurrency());
+	}
+
+	int numSources = !romPath.empty() + !corpusPath.empty() + !eventsPath.empty();
+	bool needsTracker = eventsPath.empty();
+	if(numSources != 1 || outputPath.compare("") == 0 || numEigenvectors <= 0 || numGames <= 0
+		|| (needsTracker && (freqThreshold <= 0.0 || (toReportAll != 1 && toReportAll != 0)))){
+		printHelp(argv);
+		exit(1);
+	}
+}
+
+void addFromPlay(TransitionStatistics &statistics){
+	ThreadPool pool(numThreads);
+	vector<ALEInterface*> emulators(numThreads);
+	vector<NoveltyTracker*> trackers(numThreads);
+	vector<TransitionStatistics*> partial(numThreads);
+	for(int w = 0; w < numThreads; w++){
+		emulators[w] = new ALEInterface(0);
+		emulators[w]->setInt("random_seed", 1);
+		emulators[w]->setFloat("stochasticity", 0.00);
+		emulators[w]->loadROM(romPath.c_str());
+		trackers[w] = new NoveltyTracker(freqThreshold, toReportAll == 1);
+		partial[w] = new TransitionStatistics();
+	}
+	pool.parallelFor(numGames, [&](int gameId, int worker){
+		Random rng(gameId + 1);
+		trackers[worker]->playRandomGame(*emulators[worker], rng,
+			[&](const int *events, int numEvents){ partial[worker]->add(events, numEvents); });
+	});
+	for(int w = 0; w < numThreads; w++){
+		statistics.merge(*partial[w]);
+		delete partial[w];
+		delete trackers[w];
+		delete emulators[w];
+	}
+}
+
+bool addFromCorpus(TransitionStatistics &statistics){
+	FrameCorpusReader corpus(corpusPath);
+	if(!corpus.isOpen()){
+		return false;
+	}
+	ALEScreen screen(corpus.getHeight(), corpus.getWidth());
+	ALERAM ram;
+	int action, reward;
+	NoveltyTracker tracker(freqThreshold, toReportAll == 1);
+	while(corpus.next(screen, ram, action, reward)){
+		int numEvents = tracker.update(ram);
+		if(numEvents > 0){
+			statistics.add(tracker.getEvents(), numEvents);
+		}
+	}
+	return true;
+}
+
+bool addFromCSV(TransitionStatistics &statistics){
+	std::ifstream file(eventsPath.c_str());
+	if(!file.is_open()){
+		return false;
+	}
+	string line, value;
+	vector<int> events;
+	while(getline(file, line)){
+		events.clear();
+		std::stringstream ss(line);
+		while(getline(ss, value, ',')){
+			int i = atoi(value.c_str());
+			if(!value.empty() && i >= 0 && i < NUM_TRANSITIONS){
+				events.push_back(i);
+			}
+		}
+		sort(events.begin(), events.end());
+		events.erase(unique(events.begin(), events.end()), events.end());
+		statistics.add(events.empty() ? NULL : &events[0], events.size());
+	}
+	return true;
+}
+
+/**
+* Eigendecomposition of a small symmetric matrix with the cyclic Jacobi method.
+*
+* @param vector<double>& B n x n matrix, row-major, destroyed
+* @param int n order of the matrix
+* @param vector<double>& values receives the eigenvalues
+* @param vector<double>& vectors receives the eigenvectors, column j being the j-th one
+*/
+void jacobiEigen(vector<double> &B, int n, vector<double> &values, vector<double> &vectors){
+	vectors.assign(n * n, 0.0);
+	for(int i = 0; i < n; i++){
+		vectors[i * n + i] = 1.0;
+	}
+	for(int sweep = 0; sweep < 100; sweep++){
+		double offDiagonal = 0.0, norm = 0.0;
+		for(int i = 0; i < n; i++){
+			for(int j = 0; j < n; j++){
+				norm += B[i * n + j] * B[i * n + j];
+				offDiagonal += i != j ? B[i * n + j] * B[i * n + j] : 0.0;
+			}
+		}
+		if(offDiagonal <= 1e-30 * norm || offDiagonal == 0.0){
+			break;
+		}
+		for(int p = 0; p < n; p++){
+			for(int q = p + 1; q < n; q++){
+				if(B[p * n + q] == 0.0){
+					continue;
+				}
+				double theta = (B[q * n + q] - B[p * n + p]) / (2 * B[p * n + q]);
+				double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1));
+				double c = 1 / sqrt(t * t + 1), s = t * c;
+				for(int k = 0; k < n; k++){
+					double bkp = B[k * n + p], bkq = B[k * n + q];
+					B[k * n + p] = c * bkp - s * bkq;
+					B[k * n + q] = s * bkp + c * bkq;
+				}
+				for(int k = 0; k < n; k++){
+					double bpk = B[p * n + k], bqk = B[q * n + k];
+					B[p * n + k] = c * bpk - s * bqk;
+					B[q * n + k] = s * bpk + c * bqk;
+				}
+				for(int k = 0; k < n; k++){
+					double vkp = vectors[k * n + p], vkq = vectors[k * n + q];
+					vectors[k * n + p] = c * vkp - s * vkq;
+					vectors[k * n + q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+	values.resize(n);
+	for(int i = 0; i < n; i++){
+		values[i] = B[i * n + i];
+	}
+}
+
+/**
+* Orthonormalizes the columns of a d x m matrix (row-major) with modified Gram-Schmidt,
+* applied twice for stability. Columns that become null are replaced by random ones.
+*/
+void orthonormalize(vector<double> &Q, int d, int m, Random &rng){
+	for(int j = 0; j < m; j++){
+		for(int attempt = 0; attempt < 10; attempt++){
+			for(int pass = 0; pass < 2; pass++){
+				for(int i = 0; i < j; i++){
+					double dot = 0.0;
+					for(int r = 0; r < d; r++){
+						dot += Q[r * m + i] * Q[r * m + j];
+					}
+					for(int r = 0; r < d; r++){
+						Q[r * m + j] -= dot * Q[r * m + i];
+					}
+				}
+			}
+			double norm = 0.0;
+			for(int r = 0; r < d; r++){
+				norm += Q[r * m + j] * Q[r * m + j];
+			}
+			norm = sqrt(norm);
+			if(norm > 1e-10){
+				for(int r = 0; r < d; r++){
+					Q[r * m + j] /= norm;
+				}
+				break;
+			}
+			for(int r = 0; r < d; r++){
+				Q[r * m + j] = rng.nextDouble() - 0.5;
+			}
+		}
+	}
+}
+
+/**
+* Finds the top eigenvectors of a symmetric d x d matrix by subspace iteration followed by
+* Rayleigh-Ritz: the subspace is multiplied by the matrix until the residuals of the first
+* k Ritz vectors are small.
+*
+* @param vector<double>& A d x d matrix, row-major
+* @param int d order of the matrix
+* @param int k number of eigenvectors wanted
+* @param vector<double>& values receives the k largest eigenvalues, in decreasing order
+* @param vector<double>& vectors receives the k eigenvectors, d x k row-major
+*/
+void topEigenvectors(const vector<double> &A, int d, int k, vector<double> &values, vector<double> &vectors){
+	int m = min(d, k + OVERSAMPLING);
+	Random rng(1);
+	vector<double> Q(d * m), Z(d * m), B(m * m), ritzValues, U;
+	//If the subspace is the whole space a single Rayleigh-Ritz step is exact:
+	for(int r = 0; r < d; r++){
+		for(int j = 0; j < m; j++){
+			Q[r * m + j] = m == d ? (r == j) : rng.nextDouble() - 0.5;
+		}
+	}
+	orthonormalize(Q, d, m, rng);
+
+	vector<int> order(m);
+	for(int iteration = 0; iteration < MAX_ITERATIONS; iteration++){
+		//Z = A Q
+		fill(Z.begin(), Z.end(), 0.0);
+		for(int r = 0; r < d; r++){
+			for(int c = 0; c < d; c++){
+				double a = A[(size_t) r * d + c];
+				if(a == 0.0){
+					continue;
+				}
+				for(int j = 0; j < m; j++){
+					Z[r * m + j] += a * Q[c * m + j];
+				}
+			}
+		}
+		//B = Q' Z
+		for(int i = 0; i < m; i++){
+			for(int j = 0; j < m; j++){
+				double dot = 0.0;
+				for(int r = 0; r < d; r++){
+					dot += Q[r * m + i] * Z[r * m + j];
+				}
+				B[i * m + j] = dot;
+			}
+		}
+		jacobiEigen(B, m, ritzValues, U);
+		for(int j = 0; j < m; j++){
+			order[j] = j;
+		}
+		sort(order.begin(), order.end(), [&](int a, int b){ return ritzValues[a] > ritzValues[b]; });
+
+		//Ritz vectors Q U and their residuals Z U - theta Q U:
+		values.assign(k, 0.0);
+		vectors.assign(d * k, 0.0);
+		double maxResidual = 0.0;
+		for(int j = 0; j < k; j++){
+			int col = order[j];
+			values[j] = ritzValues[col];
+			double residual = 0.0;
+			for(int r = 0; r < d; r++){
+				double v = 0.0, av = 0.0;
+				for(int i = 0; i < m; i++){
+					v += Q[r * m + i] * U[i * m + col];
+					av += Z[r * m + i] * U[i * m + col];
+				}
+				vectors[r * k + j] = v;
+				residual += (av - values[j] * v) * (av - values[j] * v);
+			}
+			maxResidual = max(maxResidual, sqrt(residual));
+		}
+		if(m == d || maxResidual <= TOLERANCE * max(fabs(values[0]), 1e-12)){
+			printf("Eigenvectors found after %d iterations.\n", iteration + 1);
+			break;
+		}
+		Q.swap(Z);
+		orthonormalize(Q, d, m, rng);
+		if(iteration == MAX_ITERATIONS - 1){
+			printf("The eigenvectors did not converge, residual: %g.\n", maxResidual);
+		}
+	}
+}
+
+bool writeVector(const string &path, const vector<double> &values){
+	FILE *file = fopen(path.c_str(), "w");
+	if(file == NULL){
+		printf("Unable to open the file '%s' to be written.\n", path.c_str());
+		return false;
+	}
+	for(unsigned int i = 0; i < values.size(); i++){
+		fprintf(file, "%.12g\n", values[i]);
+	}
+	fclose(file);
+	return true;
+}
+
+int main(int argc, char** argv){
+	readParameters(argc, argv);
+
+	TransitionStatistics statistics;
+	if(!romPath.empty()){
+		addFromPlay(statistics);
+	}
+	else if(!corpusPath.empty() ? !addFromCorpus(statistics) : !addFromCSV(statistics)){
+		fprintf(stderr, "Unable to read '%s'.\n", (corpusPath + eventsPath).c_str());
+		return -1;
+	}
+	long long n = statistics.numSamples;
+	printf("%lld samples.\n", n);
+	if(n < 2){
+		fprintf(stderr, "At least two samples are necessary to estimate the covariance.\n");
+		return -1;
+	}
+
+	//Statistics of StandardScaler: the population standard deviation, 1 if it is zero:
+	vector<double> mean(NUM_TRANSITIONS), std(NUM_TRANSITIONS);
+	vector<int> active;     //Transitions that are not constant, the others have null covariance
+	for(int i = 0; i < NUM_TRANSITIONS; i++){
+		mean[i] = double(statistics.counts[i]) / n;
+		double variance = mean[i] * (1 - mean[i]);
+		std[i] = variance > 0 ? sqrt(variance) : 1.0;
+		if(statistics.counts[i] > 0 && statistics.counts[i] < n){
+			active.push_back(i);
+		}
+	}
+
+	//Covariance of the standardized samples, with the n - 1 normalization of np.cov:
+	int d = active.size();
+	vector<double> A((size_t) d * d);
+	for(int r = 0; r < d; r++){
+		for(int c = r; c < d; c++){
+			int i = active[r], j = active[c];
+			double both = r == c ? statistics.counts[i] : statistics.pairs[TransitionStatistics::pairIndex(i, j)];
+			double value = (both / n - mean[i] * mean[j]) / (std[i] * std[j]) * n / (n - 1);
+			A[(size_t) r * d + c] = A[(size_t) c * d + r] = value;
+		}
+	}
+
+	int k = min(numEigenvectors, d);
+	vector<double> values, vectors;
+	if(k > 0){
+		topEigenvectors(A, d, k, values, vectors);
+	}
+
+	bool isWritten = writeVector(outputPath + "_mean.out", mean) && writeVector(outputPath + "_std.out", std);
+	for(int j = 0; j < numEigenvectors && isWritten; j++){
+		vector<double> option(NUM_TRANSITIONS, 0.0);
+		if(j < k){
+			//The sign is arbitrary, the largest component is made positive so the output is stable:
+			int largest = 0;
+			for(int r = 0; r < d; r++){
+				option[active[r]] = vectors[r * k + j];
+				largest = fabs(vectors[r * k + j]) > fabs(vectors[largest * k + j]) ? r : largest;
+			}
+			if(vectors[largest * k + j] < 0){
+				for(int r = 0; r < d; r++){
+					option[active[r]] = -option[active[r]];
+				}
+			}
+			printf("%d) %g\n", j + 1, values[j]);
+		}
+		stringstream ss;
+		ss << outputPath << "_" << j << ".out";
+		isWritten = writeVector(ss.str(), option);
+	}
+	return isWritten ? 0 : -1;
+}
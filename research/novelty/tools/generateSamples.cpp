@@ -7,35 +7,59 @@
 *** TODO: Right now it is implemented to just use RAM features. If one wants  **
 *** to use screen-based features, this has to be implemented, because some    **
 *** additional information (e.g. num tiles, backgrounds) should be provided.  **
+***                                                                           **
+*** Several ROMs can be given at once. The games of each ROM are played in    **
+*** parallel, one emulator per thread, and their events are written in the   **
+*** order of the seeds, so the output does not depend on the number of        **
+*** threads.                                                                  **
 *******************************************************************************/
 
 #include <getopt.h>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <thread>
 
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
 #include <ale_interface.hpp>
+#endif
 
 #include "../../../src/common/Graphics.hpp"
-#include "../../../src/features/RAMFeatures.hpp"
-
-//Features:
-#define NUM_BYTE 128
-#define NUM_BITS 1024
-//Agent's:
-#define NUM_ACTS 18
-#define FRAME_SKIP 5
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../../src/common/Random.hpp"
+#endif
+#include "../../../src/common/AsyncFileWriter.hpp"
+#include "../../../src/common/ThreadPool.hpp"
+#ifndef NOVELTY_TRACKER_H
+#define NOVELTY_TRACKER_H
+#include "NoveltyTracker.hpp"
+#endif
+
 //Colours:
 #define KRED  "\x1B[31m"
 #define KNRM  "\x1B[0m"
-//Average:
-#define FRAMES_TO_WAIT 300
 
 double freqThreshold = 0.0;
 
-string romPath;
+vector<string> romPaths;
 string outputPath;
 
-vector<double> frequency;         //[0:1023] transitions 0->1; [1024:2048] transitions 1->0
 int toReportAll = -1;
+int numGames = 300;
+int numThreads = 0;
+
+/**
+* Output of a game, kept in memory until the games with smaller seeds are written.
+*/
+struct GameEvents{
+	string bits;
+	string bytes;
+	int score;
+	bool isDone;
+};
 
 /**
 * Prints the instructions related to the program's parameters in a friendly mode
@@ -43,11 +67,15 @@ int toReportAll = -1;
 * @param char** argv received from the command line
 */
 void printHelp(char** argv){
-	printf("Usage:    %s./generateSamples -r <ROM> -f <FREQ_FILE> -t <ACTIONS_FILE> -n <FREQ_THRESHOLD> -o <OUTPUT_FILE_PREFIX> \n", argv[0]);
-	printf("   -r     %s[REQUIRED]%s path to the rom to be played by the agent.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
-	printf("   -o     %s[REQUIRED]%s path to the file to be written with the output.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("Usage:    %s -r <ROM> [-r <ROM> ...] -t <FREQ_THRESHOLD> -c <0|1> -o <OUTPUT_FILE_PREFIX> [-n <NUM_GAMES>] [-j <NUM_THREADS>] [<ROM> ...]\n", argv[0]);
+	printf("   -r     %s[REQUIRED]%s path to the rom to be played by the agent, it can be repeated.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -o     %s[REQUIRED]%s prefix of the files to be written with the output. With a single ROM the\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("          files are <prefix>_bits.csv and <prefix>_bytes.csv; with several ROMs the name of the\n");
+	printf("          game (followed by _all if -c is 1) is appended to the prefix, e.g. <prefix>pong_bits.csv.\n");
 	printf("   -t     %s[REQUIRED]%s threshold to consider the transitions as 'novel'.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
 	printf("   -c     %s[REQUIRED]%s to report transitions that are not relevant as well [0 or 1].\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -n     number of games played for each ROM, with seeds 1 to n (default: 300).\n");
+	printf("   -j     number of threads (default: number of cores).\n");
 	printf("   -h     print this help and exit\n");
 	printf("\n");
 }
@@ -60,14 +88,14 @@ void printHelp(char** argv){
 */
 void readParameters(int argc, char** argv){
 	int option = 0;
-	while ((option = getopt(argc, argv, "r:o:t:c:h")) != -1)
+	while ((option = getopt(argc, argv, "r:o:t:c:n:j:h")) != -1)
 	{
 		if (option == -1){
 			break;
 		}
 		switch(option){
 			case 'r': //Rom to be loaded
-				romPath = optarg;
+				romPaths.push_back(optarg);
 				break;
 			case 'o': //File where the samples should be saved
 				outputPath = optarg;
@@ -77,6 +105,12 @@ void readParameters(int argc, char** argv){
 				break;
 			case 'c': //Threshold to start considering a transition interesting
 				toReportAll = atoi(optarg);
+				break;
+			case 'n': //Number of games played for each ROM
+				numGames = atoi(optarg);
+				break;
+			case 'j': //Number of threads playing games
+				numThreads = atoi(optarg);
 				break;				
 			case 'h': //Asking for help about the parameters
 				printHelp(argv);
@@ -93,115 +127,122 @@ void readParameters(int argc, char** argv){
 		}
 	}
 	
+	//ROMs can also be listed after the options:
+	for(int i = optind; i < argc; i++){
+		romPaths.push_back(argv[i]);
+	}
+	if(numThreads <= 0){
+		numThreads = std::max(1, (int) std::thread::hardware_concurrency());
+	}
+
 	//Check whether all required information is available in the command line:
-	if(romPath.compare("") == 0 || outputPath.compare("") == 0
+	if(romPaths.empty() || outputPath.compare("") == 0 || numGames <= 0
 		|| freqThreshold <= 0.0 || (toReportAll != 1 && toReportAll != 0)){
 			printHelp(argv);
 			exit(1);
 	}
 }
 
-void updateAverage(vector<bool> Fprev, vector<bool> F, int frame, int gameId){
-	assert (Fprev.size() == F.size());
-	assert (F.size() == NUM_BITS);
-	
-	bool toPrint = false;
-
-	vector<int> tempVector(2 * NUM_BITS, 0);
-
-	for(int i = 0; i < NUM_BITS; i++){
-		if(!Fprev[i] && F[i]){ // 0->1
-			frequency[i] = (frequency[i] * (frame - 1) + 1) / frame;
-			tempVector[i] = 1;
-			if(frame > FRAMES_TO_WAIT && frequency[i] < freqThreshold){
-				tempVector[i] = 2; //1 denotes flip, 2 denotes relevant flip
-				toPrint = true;
-			}
-		} else{
-			frequency[i] = (frequency[i] * (frame - 1) + 0) / frame;
-		}		
-		if(Fprev[i] && !F[i]){ // 1->0
-			frequency[i + NUM_BITS] = (frequency[i + NUM_BITS] * (frame - 1) + 1) / frame;
-			tempVector[i + NUM_BITS] = 1;
-			if(frame > FRAMES_TO_WAIT && frequency[i + NUM_BITS] < freqThreshold){
-				tempVector[i + NUM_BITS] = 2;
-				toPrint = true;
-			}
-		} else{
-			frequency[i + NUM_BITS] = (frequency[i + NUM_BITS] * (frame - 1) + 0) / frame;
+/**
+* Appends the transitions reported in a frame to the lines of the game: the transitions
+* themselves and the bytes of the RAM they belong to.
+*
+* @param int* events transitions reported, sorted
+* @param int numEvents number of transitions reported
+* @param GameEvents& output object whose lines receive the events reported
+*/
+void appendEvents(const int *events, int numEvents, GameEvents &output){
+	char line[16];
+	int previousByte = -1;
+	for(int e = 0; e < numEvents; e++){
+		int length = snprintf(line, sizeof(line), "%d,", events[e]);
+		output.bits.append(line, length);
+		//Events are sorted, so repeated bytes are consecutive:
+		if(events[e] / 8 != previousByte){
+			previousByte = events[e] / 8;
+			length = snprintf(line, sizeof(line), "%d,", previousByte);
+			output.bytes.append(line, length);
 		}
 	}
+	output.bits += '\n';
+	output.bytes += '\n';
+}
 
-	ofstream myFileBits, myFileBytes;
-	myFileBytes.open (outputPath + "_bytes.csv", ios::app);
-	myFileBits.open (outputPath + "_bits.csv", ios::app);
-	vector<int> bytesToPrint;
-	if(toPrint){
-		for(int i = 0; i < tempVector.size(); i++){
-			if(toReportAll == 1 && tempVector[i] != 0){
-				myFileBits << i << ",";
-				bytesToPrint.push_back(int(i/8));
-			}
-			if(toReportAll == 0 && tempVector[i] == 2){
-				myFileBits << i << ",";
-				bytesToPrint.push_back(int(i/8));
-			}			
-		}
-		myFileBits << endl;
-		//Erase repeated elements:
-		bytesToPrint.erase( unique( bytesToPrint.begin(), bytesToPrint.end() ), bytesToPrint.end() );
-		for(int j = 0; j < bytesToPrint.size(); j++){
-			myFileBytes << bytesToPrint[j] << ",";
-		}
-		myFileBytes << endl;
-		bytesToPrint.clear();
+/**
+* Plays numGames games of a ROM in parallel and writes their events, in the order of the seeds.
+*
+* @param string romPath path to the ROM
+* @param string prefix prefix of the files to be written
+* @param ThreadPool& pool threads that play the games
+* @param vector<ALEInterface*>& emulators one emulator per thread
+* @param vector<NoveltyTracker*>& trackers counters of each thread
+*/
+void playROM(const string &romPath, const string &prefix, ThreadPool &pool, vector<ALEInterface*> &emulators,
+	vector<NoveltyTracker*> &trackers){
+	//The ROM is loaded by the main thread, the ALE is not known to be thread safe when doing so:
+	for(unsigned int w = 0; w < emulators.size(); w++){
+		emulators[w]->loadROM(romPath.c_str());
 	}
-	myFileBytes.close();
-	myFileBits.close();
-}
+	AsyncFileWriter bitsWriter(prefix + "_bits.csv");
+	AsyncFileWriter bytesWriter(prefix + "_bytes.csv");
 
-void playGame(ALEInterface& ale, Features *features, int gameId){
-	vector<bool> F(NUM_BITS, 0); //Set of active features
-	vector<bool> Fprev;
-	ale.reset_game();
-
-	int frame = 0;
-	int reward = 0;
-	while(!ale.game_over()){
-		int nextAction = rand() % NUM_ACTS;
-		for(int i = 0; i < FRAME_SKIP; i++){
-			reward += ale.act((Action) nextAction);
-			frame++;
-			Fprev.swap(F);
-			F.clear();
-			features->getCompleteFeatureVector(ale.getScreen(), ale.getRAM(), F);
-			F.pop_back();
-			updateAverage(Fprev, F, frame, gameId);
-		}
+	vector<GameEvents> games(numGames);
+	for(int i = 0; i < numGames; i++){
+		games[i].isDone = false;
 	}
-	printf("%d) Final score: %d\n", gameId+1, reward);
+	int nextToWrite = 0;
+	std::mutex mutex;
+	pool.parallelFor(numGames, [&](int gameId, int worker){
+		Random rng(gameId + 1);
+		GameEvents output;
+		output.score = trackers[worker]->playRandomGame(*emulators[worker], rng,
+			[&](const int *events, int numEvents){ appendEvents(events, numEvents, output); });
+
+		//Games are picked in order, so only a few of them wait for the previous ones to be written:
+		std::lock_guard<std::mutex> lock(mutex);
+		games[gameId].bits.swap(output.bits);
+		games[gameId].bytes.swap(output.bytes);
+		games[gameId].score = output.score;
+		games[gameId].isDone = true;
+		while(nextToWrite < numGames && games[nextToWrite].isDone){
+			GameEvents &game = games[nextToWrite];
+			bitsWriter.write(game.bits.data(), game.bits.size());
+			bytesWriter.write(game.bytes.data(), game.bytes.size());
+			string().swap(game.bits);
+			string().swap(game.bytes);
+			printf("%d) Final score: %d\n", nextToWrite + 1, game.score);
+			nextToWrite++;
+		}
+	});
 }
 
-
 int main(int argc, char** argv){
-	int numGames = 300;
 	readParameters(argc, argv);
 
-	ALEInterface ale(0);
-	RAMFeatures features;
-	ale.setInt("random_seed", 1);
-	ale.setFloat("stochasticity", 0.00);
-	ale.loadROM(romPath.c_str());
-
-	for(int i = 0; i < 2 * NUM_BITS; i++){
-		frequency.push_back(0.0);
+	ThreadPool pool(numThreads);
+	vector<ALEInterface*> emulators(numThreads);
+	vector<NoveltyTracker*> trackers(numThreads);
+	for(int w = 0; w < numThreads; w++){
+		emulators[w] = new ALEInterface(0);
+		emulators[w]->setInt("random_seed", 1);
+		emulators[w]->setFloat("stochasticity", 0.00);
+		trackers[w] = new NoveltyTracker(freqThreshold, toReportAll == 1);
 	}
 
-	//int seed = atoi(argv[7]);
-	for(int seed = 1; seed < numGames + 1; seed++){
-		srand(seed);
-		playGame(ale, &features, (seed-1));
+	for(unsigned int r = 0; r < romPaths.size(); r++){
+		string prefix = outputPath;
+		if(romPaths.size() > 1){
+			string game = romPaths[r].substr(romPaths[r].find_last_of("/") + 1);
+			game = game.substr(0, game.find_last_of("."));
+			prefix += game + (toReportAll == 1 ? "_all" : "");
+			printf("%s\n", game.c_str());
+		}
+		playROM(romPaths[r], prefix, pool, emulators, trackers);
 	}
 
+	for(int w = 0; w < numThreads; w++){
+		delete emulators[w];
+		delete trackers[w];
+	}
 	return 0;
 }
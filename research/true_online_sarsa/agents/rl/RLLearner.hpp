@@ -10,6 +10,10 @@
 #define AGENT_H
 #include "../../../../src/agents/Agent.hpp"
 #endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../../../src/common/Random.hpp"
+#endif
 
 class RLLearner : public Agent{
 	protected:
@@ -18,6 +22,7 @@ class RLLearner : public Agent{
 		double gamma, epsilon;
 		double firstReward;
 		bool   sawFirstReward;
+		Random rng;                     //Random number generator of this agent, seeded with the seed from the command line
 
 		int    frame, toUseOnlyRewardSign, toBeOptimistic;
 		int    randomActionTaken, numActions, numStepsPerAction;
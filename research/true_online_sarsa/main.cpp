@@ -44,7 +44,6 @@ int main(int argc, char** argv){
 	//Reading parameters from file defined as input in the run command:
 	Parameters param(argc, argv);
 	printf("\nSeed: %d\n\n", param.getSeed());
-	srand(param.getSeed());
 	//Using RAM features:
 	BasicFeatures features(&param);
 	//Reporting parameters read:
@@ -12,6 +12,7 @@
 #include <climits>
 
 ConstantAgent::ConstantAgent(Parameters *param){
+	this->param = param;
 	maxStepsInEpisode = param->getEpisodeLength();
 	numEpisodesToEval = param->getNumEpisodesEval();
 }
@@ -19,8 +20,6 @@ ConstantAgent::ConstantAgent(Parameters *param){
 //I assumed one episode was representative.
 //I don't want to run all actions for several episodes due to efficiency.
 void ConstantAgent::learnPolicy(ALEInterface& ale, Features *features){
-	int reward = 0;
-	int cumulativeReward = 0;
 	int numActions;
 	//It makes no sense to try ilegal actions:
 	ActionVect actions;
@@ -29,22 +28,26 @@ void ConstantAgent::learnPolicy(ALEInterface& ale, Features *features){
 	printf("Number of Actions: %d\n\n", numActions);
 	int best = 0;
 	int bestReward = INT_MIN;
-	//For each action evaluate the return when executing only it:
-	for(int a = 0; a < numActions; a++){
+	//All actions are tried from the same state, in parallel:
+	ale.reset_game();
+	SnapshotPool snapshots(param, param->getNumThreads());
+	int start = snapshots.save(ale);
+	vector<int> returns(numActions, 0);
+	snapshots.runBranches(start, numActions, [&](int a, ALEInterface &branch){
 		int step = 0;
-		while(!ale.game_over() && step < maxStepsInEpisode) {
-			reward = ale.act(actions[a]);
-			cumulativeReward += reward;
+		while(!branch.game_over() && step < maxStepsInEpisode) {
+			returns[a] += branch.act(actions[a]);
 			step++;
 		}
+	});
+	//For each action evaluate the return when executing only it:
+	for(int a = 0; a < numActions; a++){
 		//Keeping track of best action:
-		if(cumulativeReward > bestReward){
-			bestReward = cumulativeReward;
+		if(returns[a] > bestReward){
+			bestReward = returns[a];
 			best = a;
 		}
-		printf("Action %d, Cumulative Reward: %d\n", a, cumulativeReward);
-		cumulativeReward = 0;
-		ale.reset_game(); //Start the game again when the episode is over
+		printf("Action %d, Cumulative Reward: %d\n", a, returns[a]);
 	}
 	bestAction = best;
 }
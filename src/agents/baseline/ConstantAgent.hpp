@@ -12,9 +12,14 @@
 #define AGENT_H
 #include "../Agent.hpp"
 #endif
+#ifndef SNAPSHOT_POOL_H
+#define SNAPSHOT_POOL_H
+#include "../../environment/SnapshotPool.hpp"
+#endif
 
 class ConstantAgent : public Agent{
 	private:
+		Parameters *param;              //Used to create the emulators that try the actions in parallel
 		int bestAction;
 		int maxStepsInEpisode;
 		int numEpisodesToEval;
@@ -34,7 +39,8 @@ class ConstantAgent : public Agent{
  		* This method returns the action that obtains a larger return after a whole episode.
  		* It is implemented assuming that the "best" action is consistent for multiple runs,
  		* therefore each action is tried for one complete episode and the action with maximum
- 		* return is returned.
+ 		* return is returned. The episodes start from a snapshot of the game after a reset and
+ 		* are played in parallel, by NUM_THREADS threads.
  		*
  		* @param ALEInterface& ale Arcade Learning Environment interface: object used to define agents'
  		*        actions, obtain simulator screen, RAM, etc.
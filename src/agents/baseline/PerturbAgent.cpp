@@ -13,16 +13,16 @@
 #include <climits>
 
 PerturbAgent::PerturbAgent(Parameters *param){
+	this->param = param;
 	maxStepsInEpisode = param->getEpisodeLength();
 	numEpisodesToEval = param->getNumEpisodesEval();
+	rng = Random(param->getSeed());
 	epsilon = param->getEpsilon();
 }
 
 //I assumed one episode was representative.
 //I don't want to run all actions for several episodes due to efficiency.
 void PerturbAgent::learnPolicy(ALEInterface& ale, Features *features){
-	int reward = 0;
-	int cumulativeReward = 0;
 	int numActions;
 	//It makes no sense to try ilegal actions:
 	ActionVect actions;
@@ -31,21 +31,25 @@ void PerturbAgent::learnPolicy(ALEInterface& ale, Features *features){
 	printf("Number of Actions: %d\n\n", numActions);
 	int best = 0;
 	int bestReward = INT_MIN;
-	//For each action evaluate the return when executing only it:
-	for(int a = 0; a < numActions; a++){
+	//All actions are tried from the same state, in parallel:
+	ale.reset_game();
+	SnapshotPool snapshots(param, param->getNumThreads());
+	int start = snapshots.save(ale);
+	vector<int> returns(numActions, 0);
+	snapshots.runBranches(start, numActions, [&](int a, ALEInterface &branch){
 		int step = 0;
-		while(!ale.game_over() && step < maxStepsInEpisode) {
-			reward = ale.act(actions[a]);
-			cumulativeReward += reward;
+		while(!branch.game_over() && step < maxStepsInEpisode) {
+			returns[a] += branch.act(actions[a]);
 			step++;
 		}
+	});
+	//For each action evaluate the return when executing only it:
+	for(int a = 0; a < numActions; a++){
 		//Keeping track of best action:
-		if(cumulativeReward > bestReward){
-			bestReward = cumulativeReward;
+		if(returns[a] > bestReward){
+			bestReward = returns[a];
 			best = a;
 		}
-		cumulativeReward = 0;
-		ale.reset_game();		
 	}
 	bestAction = best;
 }
@@ -63,13 +67,13 @@ void PerturbAgent::evaluatePolicy(ALEInterface& ale, Features *features){
 	for(int episode = 0; episode < numEpisodesToEval; episode++){
 		int step = 0;
 		while(!ale.game_over() && step < maxStepsInEpisode) {
-			if((rand() % 100) < 100 * (1 - epsilon)){
+			if(rng.nextDouble() >= epsilon){
 				//Act as the best action
 				reward = ale.act(actions[bestAction]);
 			}
 			else{
 				//Act randomly
-				reward = ale.act(actions[rand()%actions.size()]);
+				reward = ale.act(actions[rng.nextInt(actions.size())]);
 			}
 			cumulativeReward += reward;
 			step++;
@@ -13,12 +13,22 @@
 #define AGENT_H
 #include "../Agent.hpp"
 #endif
+#ifndef SNAPSHOT_POOL_H
+#define SNAPSHOT_POOL_H
+#include "../../environment/SnapshotPool.hpp"
+#endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../common/Random.hpp"
+#endif
 
 class PerturbAgent : public Agent{
 	private:
+		Parameters *param;              //Used to create the emulators that try the actions in parallel
 		int bestAction;
 		int maxStepsInEpisode;
 		int numEpisodesToEval;
+		Random rng;                     //Random number generator of this agent
 		double epsilon;
 		/** 
 		* Constructor to prohibit the creation of an object without the parameters values.
@@ -36,7 +46,8 @@ class PerturbAgent : public Agent{
  		* This method returns the action that obtains a larger return after a whole episode.
  		* It is implemented assuming that the "best" action is consistent for multiple runs,
  		* therefore each action is tried for one complete episode and the action with maximum
- 		* return is returned.
+ 		* return is returned. The episodes start from a snapshot of the game after a reset and
+ 		* are played in parallel, by NUM_THREADS threads.
  		*
  		* @param ALEInterface& ale Arcade Learning Environment interface: object used to define agents'
  		*        actions, obtain simulator screen, RAM, etc.
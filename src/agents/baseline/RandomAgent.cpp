@@ -13,6 +13,7 @@
 RandomAgent::RandomAgent(Parameters *param){
 	maxStepsInEpisode = param->getEpisodeLength();
 	numEpisodesToEval = param->getNumEpisodesEval();
+	rng = Random(param->getSeed());
 	useMinActions = param->isMinimalAction();
 }
 
@@ -37,7 +38,7 @@ void RandomAgent::evaluatePolicy(ALEInterface& ale, Features *features){
 	for(int episode = 0; episode < numEpisodesToEval; episode++){
 		int step = 0;
 		while(!ale.game_over() && step < maxStepsInEpisode) {
-			reward = ale.act(actions[rand()%numActions]);
+			reward = ale.act(actions[rng.nextInt(numActions)]);
 			cumulativeReward += reward;
 			step++;
 		}
@@ -12,11 +12,16 @@
 #define AGENT_H
 #include "../Agent.hpp"
 #endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../common/Random.hpp"
+#endif
 
 class RandomAgent : public Agent{
 	private:
 		int maxStepsInEpisode;
 		int numEpisodesToEval;
+		Random rng;                     //Random number generator of this agent
 		int useMinActions;
 		/** 
 		* Constructor to prohibit the creation of an object without the parameters values.
@@ -24,6 +24,11 @@ HumanAgent::HumanAgent(Parameters *param){
 	numEpisodesToEval = param->getNumEpisodesEval();
     toSaveTrajectory  = param->getToSaveTrajectory();
     trajectoryFile    = param->getSaveTrajectoryPath();
+    trajectoryWriter  = NULL;
+    if(toSaveTrajectory){
+        trajectoryWriter = new TrajectoryWriter(trajectoryFile, param->getSeed(), param->getNumStepsPerAction(),
+            param->getEpisodeLength(), param->getRomPath());
+    }
 
 	// If not displaying the screen, there is little point in having keyboard control
 	bool display_screen = param->getDisplay();
@@ -35,17 +40,8 @@ HumanAgent::HumanAgent(Parameters *param){
 
 #ifdef __USE_SDL
 
-void HumanAgent::saveTrajectory(int takenAction){
-    ofstream myfile (this->trajectoryFile, ios::app);
-    
-    if (myfile.is_open()){
-        //Print action taken in the time step:
-        myfile << takenAction << ",";
-        myfile.close();
-    } else {
-        printf("I was not able to open the specified file!\n");
-        exit(0);
-    }    
+void HumanAgent::saveTrajectory(int episode, int frame, int takenAction, int reward){
+    trajectoryWriter->record(episode, frame, takenAction, reward);
 }
 #endif
 
@@ -63,11 +59,12 @@ void HumanAgent::evaluatePolicy(ALEInterface& ale, Features *features){
 		int step = 0;
 		while(!ale.game_over() && step < maxStepsInEpisode) {
 			action = receiveAction();
+			int frame = ale.getEpisodeFrameNumber();
+			reward = ale.act(action);
             //If one wants to save trajectories, this is where the trajectory is saved:
             if(toSaveTrajectory){
-                saveTrajectory(action);
+                saveTrajectory(episode, frame, action, reward);
             }
-			reward = ale.act(action);
 			cumulativeReward += reward;
 			step++;
 		}
@@ -132,4 +129,6 @@ Action HumanAgent::receiveAction(){
     #endif    
 }
 
-HumanAgent::~HumanAgent(){}
+HumanAgent::~HumanAgent(){
+	delete trajectoryWriter;
+}
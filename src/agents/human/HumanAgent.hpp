@@ -2,8 +2,9 @@
 ** Implementation of an agent that is controlled by a human player.
 **
 ** TODO: More tests need to be done regarding FPS. Right now there is no concern with it.
-**       Additionally, saving trajectories is very slow (saving features not that much),
-**       is there anyway we can optimize it??
+**
+** REMARKS: - Trajectories are saved in a binary file written in the background (see
+**            environment/Trajectory.hpp), they can be replayed with tools/trajectory.
 ** 
 ** Author: Marlos C. Machado
 ***************************************************************************************/
@@ -12,6 +13,10 @@
 #define AGENT_H
 #include "../Agent.hpp"
 #endif
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+#include "../../environment/Trajectory.hpp"
+#endif
 
 class HumanAgent : public Agent{
 	private:
@@ -21,6 +26,7 @@ class HumanAgent : public Agent{
 		bool toSaveTrajectory;
 		std::string featReprFile;
     	std::string trajectoryFile;
+		TrajectoryWriter *trajectoryWriter;   //NULL if trajectories are not saved
 
 		/**
 		* This method receives the action from the keyboard and returns it.
@@ -46,14 +52,16 @@ class HumanAgent : public Agent{
 		void saveFeatureRepr(ALEInterface& ale, Features *features);
 		/**
 		* This method saves in a file specified in trajectoryFile the agent's
-		* trajectory (state, action, reward). It is only called if the variable
-		* toSaveTrajectory is defined as TRUE.
-		*
-		* TODO: This method is extremely slow. Is there any optimization that makes it feasible?
+		* trajectory (action, reward). It is only called if the variable
+		* toSaveTrajectory is defined as TRUE. The step is buffered in memory,
+		* the file is written in the background.
 		*
+ 		* @param int episode index of the current episode, starting at 0
+ 		* @param int frame frame of the episode in which the action was taken
+ 		* @param int takenAction the code for the action taken
  		* @param int reward the reward obtained with the action taken in the current state
 		*/
-		void saveTrajectory(int reward);
+		void saveTrajectory(int episode, int frame, int takenAction, int reward);
 		/**
 		* This method saves in a file specified in trajectoryFile the agent's
 		* trajectory (state, action, reward). It is only called if the variable
@@ -94,7 +102,7 @@ class HumanAgent : public Agent{
  		*/
 		void evaluatePolicy(ALEInterface& ale, Features *features = NULL);
 		/**
-		* Destructor, not necessary in this class.
+		* Destructor, it writes what is left of the trajectory to the disk.
 		*/
 		~HumanAgent();
 
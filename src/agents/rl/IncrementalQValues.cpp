@@ -0,0 +1,88 @@
+/****************************************************************************************
+** Q-values of a linear learner maintained incrementally, from the features that became
+** active or inactive since the last evaluation.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef INCREMENTAL_Q_VALUES_H
+#define INCREMENTAL_Q_VALUES_H
+#include "IncrementalQValues.hpp"
+#endif
+#include <algorithm>
+
+IncrementalQValues::IncrementalQValues(std::vector<std::vector<weight_t> > *w, int refreshFrequency){
+	this->w = w;
+	this->refreshFrequency = refreshFrequency;
+	numActions = w->size();
+	numSinceRefresh = 0;
+	multiplicity.assign((*w)[0].size(), 0);
+	sums.assign(numActions, 0.0);
+}
+
+void IncrementalQValues::refresh(){
+	for(int a = 0; a < numActions; a++){
+		const std::vector<weight_t> &wa = (*w)[a];
+		double sumW = 0;
+		for(unsigned int i = 0; i < active.size(); i++){
+			sumW += wa[active[i]];
+		}
+		sums[a] = sumW;
+	}
+	numSinceRefresh = 0;
+}
+
+void IncrementalQValues::compute(const std::vector<int> &F, std::vector<double> &Q){
+	if(F != lastFeatures){
+		sorted.assign(F.begin(), F.end());
+		std::sort(sorted.begin(), sorted.end());
+		//Both sets are sorted, so they are merged to find what changed:
+		added.clear();
+		removed.clear();
+		unsigned int i = 0, j = 0;
+		while(i < active.size() || j < sorted.size()){
+			if(j == sorted.size() || (i < active.size() && active[i] < sorted[j])){
+				removed.push_back(active[i++]);
+			}
+			else if(i == active.size() || sorted[j] < active[i]){
+				added.push_back(sorted[j++]);
+			}
+			else{
+				i++;
+				j++;
+			}
+		}
+		for(unsigned int k = 0; k < removed.size(); k++){
+			multiplicity[removed[k]]--;
+		}
+		for(unsigned int k = 0; k < added.size(); k++){
+			multiplicity[added[k]]++;
+		}
+		active.swap(sorted);
+		lastFeatures.assign(F.begin(), F.end());
+
+		numSinceRefresh++;
+		//Updating a sum costs one access per changed feature, recomputing it one per active feature:
+		if(numSinceRefresh >= refreshFrequency || added.size() + removed.size() >= active.size()){
+			refresh();
+		}
+		else{
+			for(int a = 0; a < numActions; a++){
+				const std::vector<weight_t> &wa = (*w)[a];
+				double change = 0;
+				for(unsigned int k = 0; k < added.size(); k++){
+					change += wa[added[k]];
+				}
+				for(unsigned int k = 0; k < removed.size(); k++){
+					change -= wa[removed[k]];
+				}
+				sums[a] += change;
+			}
+		}
+	}
+	for(int a = 0; a < numActions; a++){
+		Q[a] = sums[a];
+	}
+}
@@ -0,0 +1,80 @@
+/****************************************************************************************
+** Q-values of a linear learner maintained incrementally. Consecutive states share most of
+** their active features, so instead of summing the weights of all active features for every
+** action, the sums of the last active set are kept and, when a new set is evaluated, only the
+** weights of the features that became active are added and the ones of the features that
+** became inactive are subtracted. The two sets are compared after being sorted.
+**
+** The learner must inform every change it makes to a weight (weightChanged), so the sums of
+** the active set follow the temporal difference updates. Since rounding errors accumulate,
+** the sums are recomputed from scratch every refreshFrequency new active sets, and also when
+** so many features changed that recomputing them is cheaper.
+**
+** REMARKS: - Evaluating the same features twice in a row (as the learners do at the top of
+**            each step, with the set evaluated as the next state in the previous one) only
+**            compares the two vectors.
+**          - The result is not bit-identical to summing the weights from scratch, as the sums
+**            are done in a different order.
+**          - A feature can be repeated at most 255 times in an active set.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef PRECISION_H
+#define PRECISION_H
+#include "../../common/Precision.hpp"
+#endif
+#include <vector>
+
+class IncrementalQValues{
+	private:
+		std::vector<std::vector<weight_t> > *w;   //Weights of the learner, one vector per action
+		int numActions;
+		int refreshFrequency;                      //Number of new active sets between two full recomputations
+		int numSinceRefresh;
+
+		std::vector<int> lastFeatures;             //Active features of the last evaluation, as informed
+		std::vector<int> active;                   //Same features, sorted
+		std::vector<int> sorted, added, removed;   //Used when comparing two active sets, kept to reuse their memory
+		std::vector<unsigned char> multiplicity;   //Number of times each feature is in the active set
+		std::vector<double> sums;                  //Sum of the weights of the active set, for each action
+
+		/**
+ 		* Constructor declared as private to force the user to inform the weights.
+ 		*/
+		IncrementalQValues();
+		/**
+ 		* Recomputes the sums of the active set from scratch.
+ 		*/
+		void refresh();
+	public:
+		/**
+ 		* Constructor. The active set starts empty.
+ 		*
+ 		* @param vector<vector<weight_t> > *w weights of the learner, one vector per action, they
+ 		*        are read when evaluating a new active set
+ 		* @param int refreshFrequency number of new active sets between two recomputations of the
+ 		*        sums from scratch
+ 		*/
+		IncrementalQValues(std::vector<std::vector<weight_t> > *w, int refreshFrequency);
+		/**
+ 		* Makes F the active set and returns its Q-values, with the current weights.
+ 		*
+ 		* @param vector<int>& F indices of the active features, in any order
+ 		* @param vector<double>& Q returns, by reference, the Q-value of each action
+ 		*/
+		void compute(const std::vector<int> &F, std::vector<double> &Q);
+		/**
+ 		* Informs a change made to a weight by the learner. It must be called for every weight
+ 		* changed after the last evaluation, otherwise the Q-values drift until the next refresh.
+ 		*
+ 		* @param int action action of the weight
+ 		* @param int feature feature of the weight
+ 		* @param double change new value of the weight minus its previous value
+ 		*/
+		void weightChanged(int action, int feature, double change){
+			if(multiplicity[feature] != 0){
+				sums[action] += multiplicity[feature] * change;
+			}
+		}
+};
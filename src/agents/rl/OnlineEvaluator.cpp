@@ -0,0 +1,142 @@
+/****************************************************************************************
+** Evaluator that runs in its own thread while the agent is learning, evaluating periodic
+** snapshots of the learner's weights.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ONLINE_EVALUATOR_H
+#define ONLINE_EVALUATOR_H
+#include "OnlineEvaluator.hpp"
+#endif
+#include <stdlib.h>
+#include <algorithm>
+
+OnlineEvaluator::OnlineEvaluator(Parameters *param, Features *features, ActionVect &actions,
+	const vector<vector<weight_t> > &w, const Random &rng) : evaluator(param, features, actions, param->getOnlineEvalEpsilon(), 1, rng){
+
+	numEpisodes    = param->getOnlineEvalEpisodes();
+	numActions     = w.size();
+	numBlocks      = (w[0].size() >> BLOCK_SHIFT) + 1;
+	currentVersion = 1;
+	latest         = -1;
+	reading        = -1;
+	toStop         = false;
+
+	for(int i = 0; i < 2; i++){
+		buffers[i]       = w;
+		bufferVersion[i] = 0;
+		bufferFrames[i]  = 0;
+		bufferEpisode[i] = 0;
+	}
+	for(int a = 0; a < numActions; a++){
+		blockStamp.push_back(vector<unsigned long>(numBlocks, 0));
+	}
+
+	metricsFile = fopen(param->getMetricsPath().c_str(), "w");
+	if(metricsFile == NULL){
+		printf("Unable to open the file '%s' to write the online evaluation.\n", param->getMetricsPath().c_str());
+		exit(-1);
+	}
+	fprintf(metricsFile, "frames,episode,version,num_episodes,avg_return,min_return,max_return,seconds\n");
+	fflush(metricsFile);
+
+	thread = std::thread(&OnlineEvaluator::evaluationLoop, this);
+}
+
+OnlineEvaluator::~OnlineEvaluator(){
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		toStop = true;
+	}
+	hasSnapshot.notify_all();
+	thread.join();
+	fclose(metricsFile);
+}
+
+void OnlineEvaluator::markModified(const vector<vector<int> > &features){
+	for(unsigned int a = 0; a < features.size(); a++){
+		for(unsigned int i = 0; i < features[a].size(); i++){
+			blockStamp[a][features[a][i] >> BLOCK_SHIFT] = currentVersion;
+		}
+	}
+}
+
+void OnlineEvaluator::publish(const vector<vector<weight_t> > &w, int frames, int episode){
+	int target;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		//The buffer being evaluated cannot be touched. Otherwise the most up to date buffer is
+		//used, as fewer blocks need to be copied. A snapshot not evaluated yet is just replaced.
+		if(reading != -1){
+			target = 1 - reading;
+		}
+		else{
+			target = bufferVersion[0] >= bufferVersion[1] ? 0 : 1;
+		}
+		if(latest == target){
+			latest = -1;
+		}
+	}
+	//The copy is done without holding the lock, the evaluator never reads the target buffer:
+	for(int a = 0; a < numActions; a++){
+		for(int b = 0; b < numBlocks; b++){
+			if(blockStamp[a][b] > bufferVersion[target]){
+				unsigned int begin = b << BLOCK_SHIFT;
+				unsigned int end   = std::min((unsigned int)((b + 1) << BLOCK_SHIFT), (unsigned int) w[a].size());
+				std::copy(w[a].begin() + begin, w[a].begin() + end, buffers[target][a].begin() + begin);
+			}
+		}
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		bufferVersion[target] = currentVersion;
+		bufferFrames[target]  = frames;
+		bufferEpisode[target] = episode;
+		latest = target;
+	}
+	currentVersion++;
+	hasSnapshot.notify_all();
+}
+
+void OnlineEvaluator::evaluationLoop(){
+	vector<double> returns, elapsedTimes;
+	vector<int> numFrames;
+
+	while(true){
+		int current;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while(!toStop && latest == -1){
+				hasSnapshot.wait(lock);
+			}
+			//When asked to stop, the last snapshot published is still evaluated:
+			if(latest == -1){
+				return;
+			}
+			current = reading = latest;
+			latest  = -1;
+		}
+
+		evaluator.evaluate(buffers[current], numEpisodes, returns, numFrames, elapsedTimes);
+
+		double sumReturns = 0, totalTime = 0;
+		double minReturn = returns[0], maxReturn = returns[0];
+		for(int i = 0; i < numEpisodes; i++){
+			sumReturns += returns[i];
+			totalTime  += elapsedTimes[i];
+			minReturn   = std::min(minReturn, returns[i]);
+			maxReturn   = std::max(maxReturn, returns[i]);
+		}
+		fprintf(metricsFile, "%d,%d,%lu,%d,%f,%f,%f,%f\n", bufferFrames[current], bufferEpisode[current],
+			bufferVersion[current], numEpisodes, sumReturns/numEpisodes, minReturn, maxReturn, totalTime);
+		fflush(metricsFile);
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			reading = -1;
+		}
+	}
+}
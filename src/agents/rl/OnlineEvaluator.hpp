@@ -0,0 +1,108 @@
+/****************************************************************************************
+** Evaluator that runs in its own thread while the agent is learning, generating a learning
+** curve free of the exploration noise without having to stop learning or to reload the
+** intermediate .wgt files.
+**
+** Every ONLINE_EVAL_FREQUENCY frames the learner publishes a snapshot of its weights and the
+** evaluator thread plays ONLINE_EVAL_EPISODES episodes with it, on its own ALEInterface,
+** appending the results to the metrics file. Snapshots published while the evaluator is busy
+** replace each other, only the most recent one is evaluated.
+**
+** The snapshots are double-buffered: the learner writes to the buffer the evaluator is not
+** reading, so neither of them ever waits for the other. To make publishing cheap, the weights
+** are split in blocks of 2^BLOCK_SHIFT features, and each block is stamped with the last
+** version in which it was modified. When publishing, only the blocks modified after the
+** buffer was last written are copied. Since the features are sparse this is a small part of
+** the weights vector.
+**
+** REMARKS: - markModified and publish must be called by the learner thread only.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef POLICY_EVALUATOR_H
+#define POLICY_EVALUATOR_H
+#include "PolicyEvaluator.hpp"
+#endif
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define BLOCK_SHIFT 10
+
+class OnlineEvaluator{
+	private:
+		PolicyEvaluator evaluator;
+		int numEpisodes;
+		int numActions, numBlocks;
+
+		vector<vector<weight_t> > buffers[2];    //Snapshots of the weights
+		unsigned long bufferVersion[2];          //Version of the weights stored in each buffer
+		int bufferFrames[2], bufferEpisode[2];   //When, in the learning process, each snapshot was taken
+		vector<vector<unsigned long> > blockStamp;  //Last version in which each block was modified
+		unsigned long currentVersion;            //Version being modified by the learner
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable hasSnapshot;
+		int latest;                              //Buffer with the most recent snapshot not evaluated, -1 if none
+		int reading;                             //Buffer being evaluated, -1 if none
+		bool toStop;
+
+		FILE *metricsFile;
+
+		/**
+ 		* Constructor declared as private to force the user to inform the parameters of the evaluation.
+ 		*/
+		OnlineEvaluator();
+		/**
+ 		* Loop executed by the evaluator thread: it waits for a snapshot, evaluates it and writes the
+ 		* results to the metrics file. It only finishes after the last snapshot published is evaluated.
+ 		*/
+		void evaluationLoop();
+	public:
+		/**
+ 		* Constructor. It copies the current weights to both buffers and starts the evaluator thread.
+ 		*
+ 		* @param Parameters *param parameters read from the command line and config file, it defines
+ 		*        the metrics file, the number of episodes and the epsilon used in the evaluation.
+ 		* @param Features *features feature extractor used when learning, it is cloned for the evaluator
+ 		* @param ActionVect& actions actions available to the agent, indexed as the weights are
+ 		* @param vector<vector<weight_t> >& w current weights of the learner, one vector per action
+ 		* @param Random& rng random number generator used by the evaluator thread, usually split from
+ 		*        the learner's generator
+ 		*/
+		OnlineEvaluator(Parameters *param, Features *features, ActionVect &actions,
+						const vector<vector<weight_t> > &w, const Random &rng);
+		/**
+ 		* Destructor. It waits for the evaluation of the last snapshot published and closes the
+ 		* metrics file.
+ 		*/
+		~OnlineEvaluator();
+		/**
+ 		* Informs the weights of the given action and feature were (or are going to be) modified.
+ 		*
+ 		* @param int action action whose weight was modified
+ 		* @param int feature index of the feature whose weight was modified
+ 		*/
+		inline void markModified(int action, int feature){
+			blockStamp[action][feature >> BLOCK_SHIFT] = currentVersion;
+		}
+		/**
+ 		* Informs the weights of all features in a sparse list, for each action, were modified. It is
+ 		* useful since the learners only modify the weights of features whose trace is not zero.
+ 		*
+ 		* @param vector<vector<int> >& features for each action, the indices of the modified features
+ 		*/
+		void markModified(const vector<vector<int> > &features);
+		/**
+ 		* Copies the weights modified since the last time the free buffer was written and hands the
+ 		* snapshot to the evaluator thread. It does not wait for the evaluation.
+ 		*
+ 		* @param vector<vector<weight_t> >& w current weights of the learner, one vector per action
+ 		* @param int frames number of frames seen by the learner so far
+ 		* @param int episode number of episodes played by the learner so far
+ 		*/
+		void publish(const vector<vector<weight_t> > &w, int frames, int episode);
+};
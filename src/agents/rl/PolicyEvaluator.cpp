@@ -0,0 +1,125 @@
+/****************************************************************************************
+** Evaluation engine used by the linear RL agents to run the evaluation episodes in
+** parallel, each worker thread owning its own emulator and feature extractor.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef POLICY_EVALUATOR_H
+#define POLICY_EVALUATOR_H
+#include "PolicyEvaluator.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "../../environment/ALEFactory.hpp"
+#endif
+#ifndef MATHEMATICS_H
+#define MATHEMATICS_H
+#include "../../common/Mathematics.hpp"
+#endif
+#ifndef TIMER_H
+#define TIMER_H
+#include "../../common/Timer.hpp"
+#endif
+
+PolicyEvaluator::PolicyEvaluator(Parameters *param, Features *features, ActionVect &actions,
+	double epsilon, int numThreads, const Random &rng) : rng(rng), pool(numThreads){
+
+	this->param   = param;
+	this->actions = actions;
+	this->epsilon = epsilon;
+	numActions    = actions.size();
+	episodeLength = param->getEpisodeLength();
+
+	for(int i = 0; i < pool.getNumThreads(); i++){
+		emulators.push_back(ALEFactory::createALE(param, param->getSeed()));
+		featureExtractors.push_back(features->clone());
+	}
+}
+
+PolicyEvaluator::~PolicyEvaluator(){
+	for(unsigned int i = 0; i < emulators.size(); i++){
+		delete emulators[i];
+		delete featureExtractors[i];
+	}
+}
+
+double PolicyEvaluator::playEpisode(const vector<vector<weight_t> > &w, QuantizedWeights *quantized, ALEInterface& ale,
+	Features *features, Random &rng, int &numFrames, int &numAgreements, int &numSteps){
+	double cumReward = 0;
+	vector<int> F;
+	vector<double> Q(numActions, 0.0);
+	vector<double> Qquantized(numActions, 0.0);
+
+	numAgreements = 0;
+	ale.reset_game();
+	for(numSteps = 0; !ale.game_over() && numSteps < episodeLength; numSteps++){
+		//Get state and features active on that state:
+		F.clear();
+		features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), F);
+		//Update Q-values for each possible action:
+		for(int a = 0; a < numActions; a++){
+			double sumW = 0;
+			for(unsigned int i = 0; i < F.size(); i++){
+				sumW += w[a][F[i]];
+			}
+			Q[a] = sumW;
+		}
+		if(quantized != NULL){
+			quantized->computeQValues(F, Qquantized);
+			if(Mathematics::argmax(Qquantized) == Mathematics::argmax(Q)){
+				numAgreements++;
+			}
+		}
+		//Epsilon-greedy, exactly as RLLearner::epsilonGreedy but with a local generator:
+		int action = Mathematics::argmax(quantized != NULL ? Qquantized : Q, rng);
+		if(rng.nextDouble() < epsilon){
+			action = rng.nextInt(numActions);
+		}
+		//Take action, observe reward and next state:
+		cumReward += ale.act(actions[action]);
+	}
+	numFrames = ale.getEpisodeFrameNumber();
+	return cumReward;
+}
+
+void PolicyEvaluator::evaluate(const vector<vector<weight_t> > &w, int numEpisodes, vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes){
+	runEpisodes(w, NULL, numEpisodes, returns, numFrames, elapsedTimes);
+}
+
+double PolicyEvaluator::evaluate(QuantizedWeights &quantized, const vector<vector<weight_t> > &w, int numEpisodes,
+	vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes){
+	return runEpisodes(w, &quantized, numEpisodes, returns, numFrames, elapsedTimes);
+}
+
+double PolicyEvaluator::runEpisodes(const vector<vector<weight_t> > &w, QuantizedWeights *quantized, int numEpisodes,
+	vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes){
+	returns.assign(numEpisodes, 0.0);
+	numFrames.assign(numEpisodes, 0);
+	elapsedTimes.assign(numEpisodes, 0.0);
+	vector<int> numAgreements(numEpisodes, 0), numSteps(numEpisodes, 0);
+	//Each call to evaluate uses different seeds, so consecutive evaluations are not correlated:
+	uint64_t evaluationSeed = rng.next();
+
+	pool.parallelFor(numEpisodes, [&](int episode, int worker){
+		struct timeval tvBegin, tvEnd, tvDiff;
+		//Each episode has its own stream, so its result does not depend on the thread running it:
+		Random episodeRng(evaluationSeed, episode);
+
+		gettimeofday(&tvBegin, NULL);
+		returns[episode] = playEpisode(w, quantized, *emulators[worker], featureExtractors[worker], episodeRng,
+			numFrames[episode], numAgreements[episode], numSteps[episode]);
+		gettimeofday(&tvEnd, NULL);
+		timeval_subtract(&tvDiff, &tvEnd, &tvBegin);
+		elapsedTimes[episode] = double(tvDiff.tv_sec) + double(tvDiff.tv_usec)/1000000.0;
+	});
+
+	long totalAgreements = 0, totalSteps = 0;
+	for(int episode = 0; episode < numEpisodes; episode++){
+		totalAgreements += numAgreements[episode];
+		totalSteps += numSteps[episode];
+	}
+	return totalSteps > 0 ? double(totalAgreements) / totalSteps : 1.0;
+}
@@ -0,0 +1,135 @@
+/****************************************************************************************
+** Evaluation engine used by the linear RL agents to run the evaluation episodes in
+** parallel. Each worker thread owns its own ALEInterface, its own copy of the feature
+** extractor and its own random number generator state, while all of them read the same
+** set of weights, which must not be written during the evaluation.
+**
+** Each episode has its own random number generator, a stream derived from the generator
+** given by the learner and from the episode number, not one per thread. Because of that,
+** the result of each episode is the same no matter which thread runs it or how many threads
+** are used.
+**
+** REMARKS: - The weights are not copied, they are only read. This avoids duplicating the
+**            weights vector, which can take several GB when using B-PRO. The learner must
+**            not update the weights while an evaluation is running.
+**          - The policy can also be evaluated with quantized weights (see QuantizedWeights),
+**            in which case the greedy action of the quantized weights is compared, at every
+**            step, to the one of the original weights.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../../common/Parameters.hpp"
+#endif
+#ifndef FEATURES_H
+#define FEATURES_H
+#include "../../features/Features.hpp"
+#endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../common/Random.hpp"
+#endif
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "../../common/ThreadPool.hpp"
+#endif
+#ifndef PRECISION_H
+#define PRECISION_H
+#include "../../common/Precision.hpp"
+#endif
+#ifndef QUANTIZED_WEIGHTS_H
+#define QUANTIZED_WEIGHTS_H
+#include "QuantizedWeights.hpp"
+#endif
+
+class PolicyEvaluator{
+	private:
+		Parameters *param;
+		ActionVect actions;
+
+		double epsilon;
+		int numActions, episodeLength;
+		Random rng;                            //Generates the seed of each evaluation
+
+		ThreadPool pool;
+		vector<ALEInterface*> emulators;       //One emulator per worker
+		vector<Features*> featureExtractors;   //One feature extractor per worker
+
+		/**
+ 		* Constructor declared as private to force the user to inform the parameters of the evaluation.
+ 		*/
+		PolicyEvaluator();
+		/**
+ 		* Plays a full episode, from the beginning of the game, following an epsilon-greedy policy
+ 		* with respect to the weights being evaluated.
+ 		*
+ 		* @param vector<vector<weight_t> >& w weights being evaluated, one vector per action
+ 		* @param QuantizedWeights *quantized if not NULL, the policy follows these weights instead
+ 		*        and its greedy actions are compared to the ones of w
+ 		* @param ALEInterface& ale emulator owned by the worker running the episode
+ 		* @param Features *features feature extractor owned by the worker running the episode
+ 		* @param Random &rng random number generator used in this episode
+ 		* @param int& numFrames returns, by reference, the number of frames in the episode
+ 		* @param int& numAgreements returns, by reference, the number of steps in which the greedy
+ 		*        actions of quantized and w were the same, 0 if quantized is NULL
+ 		* @param int& numSteps returns, by reference, the number of steps in the episode
+ 		*
+ 		* @return double score obtained in the episode
+ 		*/
+		double playEpisode(const vector<vector<weight_t> > &w, QuantizedWeights *quantized, ALEInterface& ale,
+			Features *features, Random &rng, int &numFrames, int &numAgreements, int &numSteps);
+		/**
+ 		* Runs the episodes of evaluate, in parallel, and returns the fraction of the steps in which
+ 		* the greedy actions agreed.
+ 		*/
+		double runEpisodes(const vector<vector<weight_t> > &w, QuantizedWeights *quantized, int numEpisodes,
+			vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes);
+	public:
+		/**
+ 		* Constructor. It creates the worker threads and, for each of them, an emulator and a copy
+ 		* of the feature extractor.
+ 		*
+ 		* @param Parameters *param parameters read from the command line and config file, it defines
+ 		*        the number of threads, the ROM, the episode length and the seed.
+ 		* @param Features *features feature extractor used when learning, it is cloned for each worker
+ 		* @param ActionVect& actions actions available to the agent, indexed as the weights are
+ 		* @param double epsilon exploration probability used in the evaluation, 0 means greedy
+ 		* @param int numThreads number of worker threads, each one with its own emulator
+ 		* @param Random& rng random number generator owned by the evaluator, usually split from the
+ 		*        learner's generator
+ 		*/
+		PolicyEvaluator(Parameters *param, Features *features, ActionVect &actions, double epsilon,
+						int numThreads, const Random &rng);
+		/**
+ 		* Destructor, it deletes the emulators and feature extractors created for the workers.
+ 		*/
+		~PolicyEvaluator();
+		/**
+ 		* Runs numEpisodes episodes in parallel. Results are returned by reference, in the order of
+ 		* the episodes, no matter in which order they finished.
+ 		*
+ 		* @param vector<vector<weight_t> >& w weights to be evaluated, one vector per action
+ 		* @param int numEpisodes number of episodes to be run
+ 		* @param vector<double>& returns score obtained in each episode
+ 		* @param vector<int>& numFrames number of frames of each episode
+ 		* @param vector<double>& elapsedTimes time, in seconds, taken by each episode
+ 		*/
+		void evaluate(const vector<vector<weight_t> > &w, int numEpisodes, vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes);
+		/**
+ 		* Same as above, but the episodes follow the quantized weights. The original weights are
+ 		* only used to measure how often both choose the same greedy action.
+ 		*
+ 		* @param QuantizedWeights& quantized weights followed by the policy
+ 		* @param vector<vector<weight_t> >& w weights that were quantized, one vector per action
+ 		*
+ 		* @return double fraction of the steps in which the greedy actions of both were the same
+ 		*/
+		double evaluate(QuantizedWeights &quantized, const vector<vector<weight_t> > &w, int numEpisodes,
+			vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes);
+};
@@ -0,0 +1,259 @@
+/****************************************************************************************
+** Weights of a linear learner quantized to 8 or 16 bit integers, stored in sparse blocks,
+** used when the weights are only read.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef QUANTIZED_WEIGHTS_H
+#define QUANTIZED_WEIGHTS_H
+#include "QuantizedWeights.hpp"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <algorithm>
+
+#define QUANTIZED_WEIGHTS_MAGIC "ALEQ"
+#define QUANTIZED_WEIGHTS_VERSION 1
+#define QUANT_BLOCK_SIZE (1 << QUANT_BLOCK_SHIFT)
+
+struct QuantizedWeightsHeader{
+	char magic[4];
+	int32_t version;
+	int32_t numActions;
+	int32_t numFeatures;
+	int32_t numBits;
+	int32_t blockShift;
+	int32_t numStoredBlocks;
+};
+
+QuantizedWeights::QuantizedWeights(const std::vector<std::vector<weight_t> > &w, int numBits, bool perBlockScales){
+	if((numBits != 8 && numBits != 16) || w.size() > QUANT_MAX_ACTIONS){
+		printf("The weights can only be quantized to 8 or 16 bits, with at most %d actions.\n", QUANT_MAX_ACTIONS);
+		exit(1);
+	}
+	this->numBits = numBits;
+	numActions  = w.size();
+	numFeatures = w[0].size();
+	//Each row added in 32 bits is smaller than 2^(numBits - 1 + QUANT_MAX_SHIFT):
+	flushEvery  = 1 << (31 - (numBits - 1) - QUANT_MAX_SHIFT);
+	int maxValue = (1 << (numBits - 1)) - 1;
+
+	std::vector<double> maxAbs(numActions, 0.0);
+	for(int a = 0; a < numActions; a++){
+		for(int f = 0; f < numFeatures; f++){
+			maxAbs[a] = std::max(maxAbs[a], fabs((double) w[a][f]));
+		}
+		scales.push_back(maxAbs[a] / maxValue / (1 << QUANT_MAX_SHIFT));
+	}
+
+	int numBlocks = (numFeatures + QUANT_BLOCK_SIZE - 1) >> QUANT_BLOCK_SHIFT;
+	int numStoredRows = 0;
+	std::vector<double> blockMaxAbs(numActions);
+	blockOffsets.assign(numBlocks, -1);
+	for(int b = 0; b < numBlocks; b++){
+		int end = std::min(numFeatures, (b + 1) << QUANT_BLOCK_SHIFT);
+		std::fill(blockMaxAbs.begin(), blockMaxAbs.end(), 0.0);
+		bool isZero = true;
+		for(int a = 0; a < numActions; a++){
+			for(int f = b << QUANT_BLOCK_SHIFT; f < end; f++){
+				blockMaxAbs[a] = std::max(blockMaxAbs[a], fabs((double) w[a][f]));
+			}
+			isZero = isZero && blockMaxAbs[a] == 0;
+		}
+		if(isZero){
+			continue;
+		}
+		//The largest power of two that keeps the weights of all actions of the block in range:
+		int shift = 0;
+		bool fits = perBlockScales;
+		while(fits && shift < QUANT_MAX_SHIFT){
+			for(int a = 0; a < numActions && fits; a++){
+				fits = blockMaxAbs[a] * (1 << (shift + 1)) <= maxAbs[a];
+			}
+			if(fits){
+				shift++;
+			}
+		}
+		blockOffsets[b] = numStoredRows;
+		blockShifts.push_back(QUANT_MAX_SHIFT - shift);
+		numStoredRows += QUANT_BLOCK_SIZE;
+	}
+
+	if(numBits == 8){
+		quantize(w, values8);
+	}
+	else{
+		quantize(w, values16);
+	}
+}
+
+template<typename T>
+void QuantizedWeights::quantize(const std::vector<std::vector<weight_t> > &w, std::vector<T> &values){
+	int maxValue = (1 << (numBits - 1)) - 1;
+	values.assign(blockShifts.size() * QUANT_BLOCK_SIZE * numActions, 0);
+	for(unsigned int b = 0; b < blockOffsets.size(); b++){
+		if(blockOffsets[b] < 0){
+			continue;
+		}
+		int multiplier = 1 << blockShifts[blockOffsets[b] >> QUANT_BLOCK_SHIFT];
+		int end = std::min(numFeatures, (int) (b + 1) << QUANT_BLOCK_SHIFT);
+		for(int f = b << QUANT_BLOCK_SHIFT; f < end; f++){
+			T *row = &values[(size_t) (blockOffsets[b] + (f & (QUANT_BLOCK_SIZE - 1))) * numActions];
+			for(int a = 0; a < numActions; a++){
+				if(scales[a] > 0){
+					//The row is multiplied when summed, and the sum by the scale of the action:
+					long q = lround(w[a][f] / (scales[a] * multiplier));
+					row[a] = (T) std::max((long) -maxValue, std::min((long) maxValue, q));
+				}
+			}
+		}
+	}
+}
+
+QuantizedWeights::QuantizedWeights(std::string path){
+	FILE *file = fopen(path.c_str(), "rb");
+	if(file == NULL){
+		printf("Unable to open the file '%s' with the quantized weights.\n", path.c_str());
+		exit(1);
+	}
+	QuantizedWeightsHeader header;
+	bool isValid = fread(&header, sizeof(QuantizedWeightsHeader), 1, file) == 1
+		&& memcmp(header.magic, QUANTIZED_WEIGHTS_MAGIC, 4) == 0 && header.version == QUANTIZED_WEIGHTS_VERSION
+		&& header.blockShift == QUANT_BLOCK_SHIFT && (header.numBits == 8 || header.numBits == 16)
+		&& header.numActions > 0 && header.numActions <= QUANT_MAX_ACTIONS
+		&& header.numFeatures > 0 && header.numFeatures <= INT_MAX - QUANT_BLOCK_SIZE
+		&& header.numStoredBlocks >= 0
+		&& header.numStoredBlocks <= (header.numFeatures + QUANT_BLOCK_SIZE - 1) >> QUANT_BLOCK_SHIFT;
+	if(isValid){
+		numActions  = header.numActions;
+		numFeatures = header.numFeatures;
+		numBits     = header.numBits;
+		flushEvery  = 1 << (31 - (numBits - 1) - QUANT_MAX_SHIFT);
+		scales.resize(numActions);
+		blockOffsets.resize((numFeatures + QUANT_BLOCK_SIZE - 1) >> QUANT_BLOCK_SHIFT);
+		blockShifts.resize(header.numStoredBlocks);
+		size_t numValues = blockShifts.size() * QUANT_BLOCK_SIZE * numActions;
+		isValid = fread(scales.data(), sizeof(double), numActions, file) == (size_t) numActions
+			&& fread(blockOffsets.data(), sizeof(int32_t), blockOffsets.size(), file) == blockOffsets.size()
+			&& fread(blockShifts.data(), sizeof(uint8_t), blockShifts.size(), file) == blockShifts.size();
+		if(isValid && numBits == 8){
+			values8.resize(numValues);
+			isValid = fread(values8.data(), sizeof(int8_t), numValues, file) == numValues;
+		}
+		else if(isValid){
+			values16.resize(numValues);
+			isValid = fread(values16.data(), sizeof(int16_t), numValues, file) == numValues;
+		}
+		//The offsets and shifts are used without checks when summing, and the shifts are bounded
+		//for the sums not to overflow (see flushEvery):
+		int numStoredFeatures = header.numStoredBlocks << QUANT_BLOCK_SHIFT;
+		for(unsigned int b = 0; isValid && b < blockOffsets.size(); b++){
+			isValid = blockOffsets[b] == -1 || (blockOffsets[b] >= 0 && blockOffsets[b] < numStoredFeatures
+				&& (blockOffsets[b] & (QUANT_BLOCK_SIZE - 1)) == 0);
+		}
+		for(unsigned int b = 0; isValid && b < blockShifts.size(); b++){
+			isValid = blockShifts[b] <= QUANT_MAX_SHIFT;
+		}
+	}
+	fclose(file);
+	if(!isValid){
+		printf("The file '%s' does not have quantized weights.\n", path.c_str());
+		exit(1);
+	}
+}
+
+void QuantizedWeights::save(std::string path){
+	FILE *file = fopen(path.c_str(), "wb");
+	if(file == NULL){
+		printf("Unable to open the file '%s' to save the quantized weights.\n", path.c_str());
+		return;
+	}
+	QuantizedWeightsHeader header;
+	memset(&header, 0, sizeof(QuantizedWeightsHeader));
+	memcpy(header.magic, QUANTIZED_WEIGHTS_MAGIC, 4);
+	header.version = QUANTIZED_WEIGHTS_VERSION;
+	header.numActions = numActions;
+	header.numFeatures = numFeatures;
+	header.numBits = numBits;
+	header.blockShift = QUANT_BLOCK_SHIFT;
+	header.numStoredBlocks = blockShifts.size();
+	bool isWritten = fwrite(&header, sizeof(QuantizedWeightsHeader), 1, file) == 1
+		&& fwrite(scales.data(), sizeof(double), numActions, file) == (size_t) numActions
+		&& fwrite(blockOffsets.data(), sizeof(int32_t), blockOffsets.size(), file) == blockOffsets.size()
+		&& fwrite(blockShifts.data(), sizeof(uint8_t), blockShifts.size(), file) == blockShifts.size();
+	if(isWritten && numBits == 8){
+		isWritten = fwrite(values8.data(), sizeof(int8_t), values8.size(), file) == values8.size();
+	}
+	else if(isWritten){
+		isWritten = fwrite(values16.data(), sizeof(int16_t), values16.size(), file) == values16.size();
+	}
+	if(fclose(file) != 0 || !isWritten){
+		printf("Unable to save the quantized weights in '%s'.\n", path.c_str());
+	}
+}
+
+template<typename T>
+void QuantizedWeights::sumRows(const std::vector<T> &values, const std::vector<int> &F, int64_t *sums){
+	int32_t partialSums[QUANT_MAX_ACTIONS];
+	for(int a = 0; a < numActions; a++){
+		sums[a] = 0;
+	}
+	unsigned int i = 0;
+	while(i < F.size()){
+		unsigned int end = std::min((unsigned int) F.size(), i + flushEvery);
+		for(int a = 0; a < numActions; a++){
+			partialSums[a] = 0;
+		}
+		for(; i < end; i++){
+			int32_t offset = blockOffsets[F[i] >> QUANT_BLOCK_SHIFT];
+			if(offset < 0){
+				continue;
+			}
+			int32_t multiplier = 1 << blockShifts[offset >> QUANT_BLOCK_SHIFT];
+			const T *row = &values[(size_t) (offset + (F[i] & (QUANT_BLOCK_SIZE - 1))) * numActions];
+			//Contiguous integer adds, vectorized by the compiler:
+			for(int a = 0; a < numActions; a++){
+				partialSums[a] += row[a] * multiplier;
+			}
+		}
+		for(int a = 0; a < numActions; a++){
+			sums[a] += partialSums[a];
+		}
+	}
+}
+
+void QuantizedWeights::computeQValues(const std::vector<int> &F, std::vector<double> &Q){
+	int64_t sums[QUANT_MAX_ACTIONS];
+	if(numBits == 8){
+		sumRows(values8, F, sums);
+	}
+	else{
+		sumRows(values16, F, sums);
+	}
+	for(int a = 0; a < numActions; a++){
+		Q[a] = sums[a] * scales[a];
+	}
+}
+
+size_t QuantizedWeights::getNumBytes(){
+	return scales.size() * sizeof(double) + blockOffsets.size() * sizeof(int32_t) + blockShifts.size() * sizeof(uint8_t)
+		+ values8.size() * sizeof(int8_t) + values16.size() * sizeof(int16_t);
+}
+
+int QuantizedWeights::getNumBits(){
+	return numBits;
+}
+
+int QuantizedWeights::getNumActions(){
+	return numActions;
+}
+
+int QuantizedWeights::getNumFeatures(){
+	return numFeatures;
+}
@@ -0,0 +1,112 @@
+/****************************************************************************************
+** Weights of a linear learner quantized to 8 or 16 bit integers, used when the weights are
+** only read: to evaluate the learned policy and to replay it (see tools/replay). The
+** features are grouped in blocks of 2^QUANT_BLOCK_SHIFT features and only the blocks with a
+** non-zero weight are stored, so features never seen while learning cost nothing.
+**
+** Each action has a scale, the largest absolute weight of the action divided by the largest
+** integer. When the scales are per block, each block is also given a power of two, up to
+** 2^QUANT_MAX_SHIFT, by which its weights are multiplied before being rounded, so blocks of
+** small weights keep their precision. A weight is then q * scale[a] / 2^shift[b].
+**
+** The rows of a block are feature-major: the weights of all actions of a feature are
+** contiguous. The Q-values of a state are computed by adding, for each active feature, its
+** row shifted by the power of two of its block to the integer sums of all actions, a loop the
+** compiler vectorizes. The sums are only converted to Q-values once per action, at the end.
+**
+** REMARKS: - The file written by save stores, after a header, the scales, the first row of
+**            each block (-1 if not stored), the shift of each stored block and the rows.
+**          - The sums are kept in 32 bits for at most flushEvery features, which is what fits
+**            without overflow, and then added to 64 bit sums.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef PRECISION_H
+#define PRECISION_H
+#include "../../common/Precision.hpp"
+#endif
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+#define QUANT_BLOCK_SHIFT 4     //Blocks of 16 features
+#define QUANT_MAX_SHIFT   8     //The weights of a block are multiplied by at most 256 before being rounded
+#define QUANT_MAX_ACTIONS 18    //Size of the legal action set of the ALE
+
+class QuantizedWeights{
+	private:
+		int numActions, numFeatures;
+		int numBits;                        //8 or 16
+		int flushEvery;                     //Number of features summed in 32 bits before moving the sums to 64 bits
+		std::vector<double> scales;         //Value of one unit of the sums of each action
+		std::vector<int32_t> blockOffsets;  //First row of each block, -1 if all weights of the block are zero
+		std::vector<uint8_t> blockShifts;   //Left shift applied to the rows of each stored block when summing them
+		std::vector<int8_t> values8;        //Rows of the stored blocks, numActions values per feature, when numBits is 8
+		std::vector<int16_t> values16;      //Same, when numBits is 16
+
+		/**
+ 		* Constructor declared as private to force the user to inform the weights or the file.
+ 		*/
+		QuantizedWeights();
+		/**
+ 		* Rounds the weights of the stored blocks to integers of type T.
+ 		*
+ 		* @param vector<vector<weight_t> >& w weights being quantized, one vector per action
+ 		* @param vector<T>& values returns, by reference, the rows of the stored blocks
+ 		*/
+		template<typename T>
+		void quantize(const std::vector<std::vector<weight_t> > &w, std::vector<T> &values);
+		/**
+ 		* Sums the rows of the active features, see computeQValues.
+ 		*/
+		template<typename T>
+		void sumRows(const std::vector<T> &values, const std::vector<int> &F, int64_t *sums);
+	public:
+		/**
+ 		* Constructor. It quantizes a table of weights.
+ 		*
+ 		* @param vector<vector<weight_t> >& w weights being quantized, one vector per action
+ 		* @param int numBits size of the integers, 8 or 16
+ 		* @param bool perBlockScales if true each block has its own power of two, otherwise all
+ 		*        blocks of an action use the scale of the action
+ 		*/
+		QuantizedWeights(const std::vector<std::vector<weight_t> > &w, int numBits, bool perBlockScales);
+		/**
+ 		* Constructor. It loads the weights from a file written by save. The program is interrupted
+ 		* if the file cannot be read or if its blocks are not consistent with its header.
+ 		*
+ 		* @param std::string path path to the file
+ 		*/
+		QuantizedWeights(std::string path);
+		/**
+ 		* Saves the weights in a binary file, it is overwritten if it already exists.
+ 		*
+ 		* @param std::string path path to the file
+ 		*/
+		void save(std::string path);
+		/**
+ 		* Computes the Q-value of every action. It only reads the weights, so it can be called by
+ 		* several threads at the same time.
+ 		*
+ 		* @param vector<int>& F indices of the active features
+ 		* @param vector<double>& Q returns, by reference, the Q-value of each action
+ 		*/
+		void computeQValues(const std::vector<int> &F, std::vector<double> &Q);
+		/**
+ 		* @return size_t memory, in bytes, used by the quantized weights
+ 		*/
+		size_t getNumBytes();
+		/**
+ 		* @return int size of the integers, 8 or 16
+ 		*/
+		int getNumBits();
+		/**
+ 		* @return int number of actions, as in the weights that were quantized
+ 		*/
+		int getNumActions();
+		/**
+ 		* @return int number of features, as in the weights that were quantized
+ 		*/
+		int getNumFeatures();
+};
@@ -7,6 +7,7 @@
 #define RL_LEARNER_H
 #include "RLLearner.hpp"
 #endif
+#include <sstream>
 
 RLLearner::RLLearner(ALEInterface& ale, Parameters *param){
 	randomActionTaken   = 0;
@@ -19,6 +20,30 @@ RLLearner::RLLearner(ALEInterface& ale, Parameters *param){
 	episodeLength       = param->getEpisodeLength();
 	numEpisodesEval     = param->getNumEpisodesEval();
 	totalNumberOfFramesToLearn = param->getLearningLength();
+	numThreads          = param->getNumThreads();
+	toPrintEpisodes     = param->getToPrintEpisodes();
+	parameters          = param;
+	rng                 = Random(param->getSeed());
+	corpusWriter        = NULL;
+	if(param->getCorpusPath() != ""){
+		corpusWriter = new FrameCorpusWriter(param->getCorpusPath());
+	}
+	replayBuffer        = NULL;
+	numReplayUpdates    = param->getReplayUpdates();
+	if(param->getReplayCapacity() > 0){
+		replayBuffer = new ReplayBuffer(param->getReplayCapacity(), param->getReplayExponent());
+	}
+	startStates         = NULL;
+	startRng            = Random(param->getSeed(), 1);
+	if(param->getNumStartStates() > 0){
+		startStates = new StartStateCache(param, numThreads);
+	}
+	quantizeBits        = param->getQuantizeBits();
+	quantizePerBlock    = param->getQuantizePerBlock();
+	//The weights belong to the subclasses, which create the incremental Q-values if requested:
+	incrementalQ        = NULL;
+	diverged            = false;
+	traceCapacity       = 0;
 
 	//Get the number of effective actions:
 	if(param->isMinimalAction()){
@@ -30,29 +55,129 @@ RLLearner::RLLearner(ALEInterface& ale, Parameters *param){
 	numActions = actions.size();
 }
 
+void RLLearner::reserveTraces(vector<vector<int> > &nonZeroElig, unsigned int size){
+	if(size <= traceCapacity){
+		return;
+	}
+	traceCapacity = max(size, 2 * traceCapacity);
+	for(unsigned int a = 0; a < nonZeroElig.size(); a++){
+		nonZeroElig[a].reserve(traceCapacity);
+	}
+}
+
+bool RLLearner::hasDiverged(){
+	return diverged;
+}
+
+RLLearner::~RLLearner(){
+	delete corpusWriter;
+	delete replayBuffer;
+	delete startStates;
+	delete incrementalQ;
+}
+
 int RLLearner::epsilonGreedy(vector<double> &QValues){
 	randomActionTaken = 0;
 
-	int action = Mathematics::argmax(QValues);
+	int action = Mathematics::argmax(QValues, rng);
 	//With probability epsilon: a <- random action in A(s)
-	int random = rand();
-	if((random % int(nearbyint(1.0/epsilon))) == 0) {
-	//if((rand()%int(1.0/epsilon)) == 0){
+	if(rng.nextDouble() < epsilon){
 		randomActionTaken = 1;
-		action = rand() % numActions;
+		action = rng.nextInt(numActions);
 	}
 	return action;
 }
 
+int RLLearner::epsilonGreedy(vector<double> &QValues, Random &rng){
+	int action = Mathematics::argmax(QValues, rng);
+	//With probability epsilon: a <- random action in A(s)
+	if(rng.nextDouble() < epsilon){
+		action = rng.nextInt(numActions);
+	}
+	return action;
+}
+
+void RLLearner::resetGame(ALEInterface& ale, Random &rng){
+	if(startStates != NULL){
+		startStates->restore(ale, rng);
+	}
+	else{
+		ale.reset_game();
+	}
+}
+
+void RLLearner::replayTransitions(vector<vector<weight_t> > &w, double learningRate, bool isOffPolicy,
+	OnlineEvaluator *onlineEvaluator){
+	PROFILE_SCOPE(PHASE_REPLAY);
+	for(int u = 0; u < numReplayUpdates && replayBuffer->canSample(); u++){
+		int slot = replayBuffer->sample(rng, replayed);
+		vector<weight_t> &wa = w[replayed.action];
+		double q = 0, qNext = 0;
+		for(unsigned int i = 0; i < replayed.features.size(); i++){
+			q += wa[replayed.features[i]];
+		}
+		if(!replayed.isTerminal){
+			for(int a = 0; a < numActions; a++){
+				if(!isOffPolicy && a != replayed.nextAction){
+					continue;
+				}
+				double sumW = 0;
+				for(unsigned int i = 0; i < replayed.nextFeatures.size(); i++){
+					sumW += w[a][replayed.nextFeatures[i]];
+				}
+				if(!isOffPolicy || a == 0 || sumW > qNext){
+					qNext = sumW;
+				}
+			}
+		}
+		double delta = replayed.reward + gamma * qNext - q;
+		for(unsigned int i = 0; i < replayed.features.size(); i++){
+			weight_t previous = wa[replayed.features[i]];
+			wa[replayed.features[i]] += learningRate * delta;
+			if(incrementalQ != NULL){
+				incrementalQ->weightChanged(replayed.action, replayed.features[i], wa[replayed.features[i]] - previous);
+			}
+			if(onlineEvaluator != NULL){
+				onlineEvaluator->markModified(replayed.action, replayed.features[i]);
+			}
+		}
+		replayBuffer->updatePriority(slot, delta);
+	}
+}
+
+void RLLearner::evaluateQuantized(PolicyEvaluator &evaluator, const vector<vector<weight_t> > &w,
+	vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes){
+	QuantizedWeights quantized(w, quantizeBits, quantizePerBlock);
+	double agreement = evaluator.evaluate(quantized, w, numEpisodesEval, returns, numFrames, elapsedTimes);
+	printf("quantized weights: %d bits, %.1f MB (%.1f MB unquantized), greedy action agreement: %.2f%%\n",
+		quantized.getNumBits(), quantized.getNumBytes() / 1048576.0,
+		numActions * (double) w[0].size() * sizeof(weight_t) / 1048576.0, 100 * agreement);
+	if(parameters->getToSaveWeightsAfterLearning()){
+		stringstream ss;
+		ss << parameters->getFileWithWeights() << parameters->getSeed() << ".q" << quantizeBits;
+		quantized.save(ss.str());
+	}
+}
+
 /**
  * The first parameter is the one that is used by Sarsa. The second is used to
  * pass aditional information to the running algorithm (like 'real score' if one
  * is using a surrogate reward function).
  */
 void RLLearner::act(ALEInterface& ale, int action, vector<double> &reward){
+	act(ale, action, reward, this->firstReward, this->sawFirstReward);
+	if(corpusWriter != NULL){
+		corpusWriter->record(ale.getScreen(), ale.getRAM(), actions[action], (int) reward[1]);
+	}
+}
+
+void RLLearner::act(ALEInterface& ale, int action, vector<double> &reward, double &firstReward, bool &sawFirstReward){
 	double r_alg = 0.0, r_real = 0.0;
 	
-	r_real = ale.act(actions[action]);
+	{
+		PROFILE_SCOPE(PHASE_EMULATION);
+		r_real = ale.act(actions[action]);
+	}
 	if(toUseOnlyRewardSign){
 		if(r_real > 0){ 
 			r_alg = 1.0;
@@ -10,6 +10,38 @@
 #define AGENT_H
 #include "../Agent.hpp"
 #endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../common/Random.hpp"
+#endif
+#ifndef PROFILER_H
+#define PROFILER_H
+#include "../../common/Profiler.hpp"
+#endif
+#ifndef METRICS_LOG_H
+#define METRICS_LOG_H
+#include "../../common/MetricsLog.hpp"
+#endif
+#ifndef FRAME_CORPUS_H
+#define FRAME_CORPUS_H
+#include "../../environment/FrameCorpus.hpp"
+#endif
+#ifndef REPLAY_BUFFER_H
+#define REPLAY_BUFFER_H
+#include "ReplayBuffer.hpp"
+#endif
+#ifndef ONLINE_EVALUATOR_H
+#define ONLINE_EVALUATOR_H
+#include "OnlineEvaluator.hpp"
+#endif
+#ifndef START_STATE_CACHE_H
+#define START_STATE_CACHE_H
+#include "../../environment/StartStateCache.hpp"
+#endif
+#ifndef INCREMENTAL_Q_VALUES_H
+#define INCREMENTAL_Q_VALUES_H
+#include "IncrementalQValues.hpp"
+#endif
 
 class RLLearner : public Agent{
 	protected:
@@ -23,6 +55,22 @@ class RLLearner : public Agent{
 		int    randomActionTaken, numActions;
 		int    episodeLength, numEpisodesEval;
 		int    totalNumberOfFramesToLearn;
+		int    numThreads;
+		int    toPrintEpisodes;
+
+		Parameters *parameters;
+		Random rng;                     //Random number generator of this agent, seeded with the seed from the command line
+		FrameCorpusWriter *corpusWriter;//Records the frames seen while learning, NULL if CORPUS_FILE is empty
+		ReplayBuffer *replayBuffer;     //Transitions seen while learning, NULL if REPLAY_CAPACITY is 0
+		ReplayTransition replayed;      //Transition being replayed, kept to reuse its memory
+		int numReplayUpdates;           //Number of transitions replayed after each step
+		StartStateCache *startStates;   //States the learning episodes start from, NULL if START_STATES is 0
+		Random startRng;                //Chooses the start states, so the stream of rng does not depend on them
+		int quantizeBits;               //Size of the integers the weights are quantized to when evaluated, 0 if they are not
+		int quantizePerBlock;
+		IncrementalQValues *incrementalQ;//Q-values kept from the last active set, NULL if INCREMENTAL_Q_REFRESH is 0
+		bool diverged;                  //Set by sanityCheck when the Q-values diverge, it stops learnPolicy
+		unsigned int traceCapacity;     //Capacity reserved in the lists of non-zero traces of every action
 
 		/**
  		* It acts in the environment and makes the proper operations in the reward signal (normalizing,
@@ -36,8 +84,19 @@ class RLLearner : public Agent{
  		* by executing the action defined as parameter. This vector has two positions: in the first position
  		* the reward to be used by the RL algorithm is returned; in the second position, the game score is
  		* returned.
+ 		*
+ 		* If CORPUS_FILE is set the screen and RAM observed after the action are recorded.
  		*/
 		void act(ALEInterface& ale, int action, vector<double> &reward);
+		/**
+ 		* Same as above, but the normalization of the reward is based on the state passed as parameter
+ 		* instead of the one stored in the object. It is the version to be used when several threads act,
+ 		* each one in its own emulator, as each thread sees its own first reward. Nothing is recorded.
+ 		*
+ 		* @param double& firstReward absolute value of the first non-zero reward observed by the caller
+ 		* @param bool& sawFirstReward whether the caller has already observed a non-zero reward
+ 		*/
+		void act(ALEInterface& ale, int action, vector<double> &reward, double &firstReward, bool &sawFirstReward);
 
 		/**
  		* Implementation of an epsilon-greedy function. Epsilon is defined in the constructor,
@@ -46,6 +105,65 @@ class RLLearner : public Agent{
  		* @return int action to be taken
  		*/
 		int epsilonGreedy(vector<double> &QValues);
+		/**
+ 		* Same as above, but it uses the random number generator passed as parameter. It does not update
+ 		* randomActionTaken, so it can be called by several threads at the same time, each one with its
+ 		* own generator.
+ 		*
+ 		* @param Random &rng random number generator owned by the caller
+ 		*
+ 		* @return int action to be taken
+ 		*/
+		int epsilonGreedy(vector<double> &QValues, Random &rng);
+
+		/**
+ 		* Starts a new learning episode. If START_STATES is 0 the game is reset, otherwise one of the
+ 		* cached start states is restored, which does not emulate the no-ops before it.
+ 		*
+ 		* @param ALEInterface& ale emulator in which the episode is played
+ 		* @param Random &rng random number generator that chooses the start state, owned by the caller
+ 		*/
+		void resetGame(ALEInterface& ale, Random &rng);
+
+		/**
+ 		* Makes sure the lists of non-zero traces of all actions can hold size indices without
+ 		* allocating memory. The lists grow together, doubling their capacity, so the ones of the
+ 		* actions rarely taken do not allocate memory late in learning: once the largest list
+ 		* stops growing, no step allocates memory for the traces.
+ 		*
+ 		* @param vector<vector<int> >& nonZeroElig indices of the non-zero traces, one list per action
+ 		* @param unsigned int size number of indices the list about to be updated may reach
+ 		*/
+		void reserveTraces(vector<vector<int> > &nonZeroElig, unsigned int size);
+
+		/**
+ 		* Updates the weights with numReplayUpdates transitions sampled from the replay buffer,
+ 		* one-step updates without eligibility traces. The priorities of the transitions are
+ 		* updated with their new temporal difference errors. If incrementalQ is set it is informed
+ 		* of the weights modified.
+ 		*
+ 		* @param vector<vector<weight_t> >& w weights of the learner, one vector per action
+ 		* @param double learningRate step size of the updates, already normalized
+ 		* @param bool isOffPolicy if true the target uses the greedy action in the next state
+ 		*        (Q-learning), otherwise the action that was actually taken (Sarsa)
+ 		* @param OnlineEvaluator *onlineEvaluator evaluator informed of the weights modified, it may be NULL
+ 		*/
+		void replayTransitions(vector<vector<weight_t> > &w, double learningRate, bool isOffPolicy,
+			OnlineEvaluator *onlineEvaluator);
+		/**
+ 		* Evaluates the policy with the weights quantized to quantizeBits bits, as tools/replay would
+ 		* play it. Besides the results of the episodes, it prints the memory of the quantized weights
+ 		* and how often their greedy action was the one of the original weights. If the weights are
+ 		* saved after learning, the quantized ones are also saved, in <weights file><seed>.q<bits>.
+ 		*
+ 		* @param PolicyEvaluator& evaluator evaluator that runs the episodes
+ 		* @param vector<vector<weight_t> >& w weights of the learner, one vector per action
+ 		* @param vector<double>& returns score obtained in each episode
+ 		* @param vector<int>& numFrames number of frames of each episode
+ 		* @param vector<double>& elapsedTimes time, in seconds, taken by each episode
+ 		*/
+		void evaluateQuantized(PolicyEvaluator &evaluator, const vector<vector<weight_t> > &w,
+			vector<double> &returns, vector<int> &numFrames, vector<double> &elapsedTimes);
 
 		/**
 		* Constructor to be used by the RL classes to save the parameters that
@@ -89,7 +207,15 @@ class RLLearner : public Agent{
 		virtual void evaluatePolicy(ALEInterface& ale, Features *features) = 0;
 
 		/**
-		* Destructor, not necessary in this class.
+		* The learner stops as soon as its Q-values diverge, instead of exiting, so the other runs of a
+		* sweep in the same process are not ended with it. The caller decides what to do next.
+		*
+		* @return bool true if the Q-values diverged while learning or evaluating
+		*/
+		bool hasDiverged();
+
+		/**
+		* Destructor, it closes the corpus of frames, if one is being recorded, and frees the replay buffer.
 		*/
-		virtual ~RLLearner(){};
+		virtual ~RLLearner();
 };
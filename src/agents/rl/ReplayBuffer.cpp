@@ -0,0 +1,209 @@
+/****************************************************************************************
+** Experience replay buffer for learners with sparse binary features.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef REPLAY_BUFFER_H
+#define REPLAY_BUFFER_H
+#include "ReplayBuffer.hpp"
+#endif
+#include <algorithm>
+#include <math.h>
+
+ReplayBuffer::ReplayBuffer(int capacity, double exponent, size_t chunkSize){
+	this->capacity = capacity;
+	this->exponent = exponent;
+	this->chunkSize = chunkSize;
+	maxPriority = 1.0;
+	newest = -1;
+	numStored = 0;
+
+	Slot empty;
+	empty.chunk = NULL;
+	slots.assign(capacity, empty);
+	treeSize = 1;
+	while(treeSize < capacity){
+		treeSize *= 2;
+	}
+	sumTree.assign(2 * treeSize, 0.0);
+}
+
+ReplayBuffer::~ReplayBuffer(){
+	for(unsigned int i = 0; i < chunks.size(); i++){
+		delete chunks[i];
+	}
+	for(unsigned int i = 0; i < freeChunks.size(); i++){
+		delete freeChunks[i];
+	}
+}
+
+int ReplayBuffer::size(){
+	return numStored;
+}
+
+size_t ReplayBuffer::getArenaBytes(){
+	size_t bytes = 0;
+	for(unsigned int i = 0; i < chunks.size(); i++){
+		bytes += chunks[i]->data.size();
+	}
+	return bytes;
+}
+
+void ReplayBuffer::setPriority(int slot, double priority){
+	int i = slot + treeSize;
+	sumTree[i] = priority;
+	//The sums are recomputed instead of updated, so rounding errors do not accumulate:
+	for(i /= 2; i >= 1; i /= 2){
+		sumTree[i] = sumTree[2 * i] + sumTree[2 * i + 1];
+	}
+}
+
+ReplayBuffer::Chunk* ReplayBuffer::getChunk(size_t numBytes){
+	if(!chunks.empty() && chunks.back()->used + numBytes <= chunks.back()->data.size()){
+		return chunks.back();
+	}
+	Chunk *chunk;
+	if(!freeChunks.empty()){
+		chunk = freeChunks.back();
+		freeChunks.pop_back();
+	}
+	else{
+		chunk = new Chunk();
+	}
+	if(chunk->data.size() < std::max(chunkSize, numBytes)){
+		chunk->data.resize(std::max(chunkSize, numBytes));
+	}
+	chunk->used = 0;
+	chunk->numLive = 0;
+	chunks.push_back(chunk);
+	return chunk;
+}
+
+void ReplayBuffer::release(int slot){
+	slots[slot].chunk->numLive--;
+	slots[slot].chunk = NULL;
+	setPriority(slot, 0.0);
+	numStored--;
+	//Transitions are overwritten in the order they were added, so chunks are freed in order too:
+	while(chunks.size() > 1 && chunks.front()->numLive == 0){
+		freeChunks.push_back(chunks.front());
+		chunks.pop_front();
+	}
+}
+
+void ReplayBuffer::add(const std::vector<int> &features, int action, double reward, bool isTerminal){
+	int slot = (newest + 1) % capacity;
+	if(slots[slot].chunk != NULL){
+		release(slot);
+	}
+
+	sorted.assign(features.begin(), features.end());
+	std::sort(sorted.begin(), sorted.end());
+	//A varint of a 32-bit number takes at most 5 bytes:
+	Chunk *chunk = getChunk(5 * (sorted.size() + 1));
+	unsigned char *begin = &chunk->data[chunk->used];
+	unsigned char *out = begin;
+	uint32_t value = sorted.size();
+	int previous = 0;
+	for(unsigned int i = 0; i <= sorted.size(); i++){
+		if(i > 0){
+			value = sorted[i - 1] - previous;
+			previous = sorted[i - 1];
+		}
+		while(value >= 0x80){
+			*out++ = (unsigned char) (value | 0x80);
+			value >>= 7;
+		}
+		*out++ = (unsigned char) value;
+	}
+
+	Slot &s = slots[slot];
+	s.chunk = chunk;
+	s.offset = chunk->used;
+	s.action = action;
+	s.reward = reward;
+	s.isTerminal = isTerminal;
+	chunk->used += out - begin;
+	chunk->numLive++;
+	numStored++;
+
+	//A transition can only be sampled once the state that follows it is stored:
+	if(newest >= 0 && slots[newest].chunk != NULL && !slots[newest].isTerminal){
+		setPriority(newest, maxPriority);
+	}
+	setPriority(slot, isTerminal ? maxPriority : 0.0);
+	newest = slot;
+}
+
+void ReplayBuffer::decode(const Slot &slot, std::vector<int> &features){
+	const unsigned char *in = &slot.chunk->data[slot.offset];
+	features.clear();
+	int previous = 0;
+	uint32_t numFeatures = 0;
+	for(uint32_t i = 0; i <= numFeatures; i++){
+		uint32_t value = 0;
+		int shift = 0;
+		while(*in & 0x80){
+			value |= (uint32_t) (*in++ & 0x7F) << shift;
+			shift += 7;
+		}
+		value |= (uint32_t) (*in++) << shift;
+		if(i == 0){
+			numFeatures = value;
+		}
+		else{
+			previous += value;
+			features.push_back(previous);
+		}
+	}
+}
+
+bool ReplayBuffer::canSample(){
+	return sumTree[1] > 0;
+}
+
+int ReplayBuffer::sample(Random &rng, ReplayTransition &transition){
+	int slot;
+	do{
+		double u = rng.nextDouble() * sumTree[1];
+		int i = 1;
+		while(i < treeSize){
+			if(u < sumTree[2 * i]){
+				i = 2 * i;
+			}
+			else{
+				u -= sumTree[2 * i];
+				i = 2 * i + 1;
+			}
+		}
+		slot = i - treeSize;
+	//Rounding errors may lead to a leaf without priority, which is never the right one:
+	}while(sumTree[slot + treeSize] <= 0);
+
+	const Slot &s = slots[slot];
+	decode(s, transition.features);
+	transition.action = s.action;
+	transition.reward = s.reward;
+	transition.isTerminal = s.isTerminal;
+	transition.nextFeatures.clear();
+	transition.nextAction = 0;
+	if(!s.isTerminal){
+		const Slot &next = slots[(slot + 1) % capacity];
+		decode(next, transition.nextFeatures);
+		transition.nextAction = next.action;
+	}
+	return slot;
+}
+
+void ReplayBuffer::updatePriority(int slot, double delta){
+	double priority = pow(fabs(delta) + 1e-6, exponent);
+	if(priority > maxPriority){
+		maxPriority = priority;
+	}
+	if(slots[slot].chunk != NULL){
+		setPriority(slot, priority);
+	}
+}
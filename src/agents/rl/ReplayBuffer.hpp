@@ -0,0 +1,147 @@
+/****************************************************************************************
+** Experience replay buffer for learners with sparse binary features. Each transition is
+** stored as the sorted list of active features, delta-encoded and packed as varints (7 bits
+** per byte), together with the action, the reward and whether the next state is terminal.
+** Consecutive transitions share their states: the next state of a transition is the state
+** of the transition added after it, unless it is terminal, so each state is stored once.
+**
+** The packed features are kept in large chunks of memory (the arena), which are reused
+** once all their transitions were overwritten. When the buffer is full the oldest
+** transition is overwritten. Transitions are sampled uniformly or with probability
+** proportional to |delta|^exponent, as in prioritized experience replay, without the
+** importance sampling correction.
+**
+** REMARKS: - A state of B-PRO features takes, in general, a byte or two per active feature,
+**            since the differences between sorted indices are small.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../../common/Random.hpp"
+#endif
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Transition decoded from the buffer.
+ */
+struct ReplayTransition{
+	std::vector<int> features;      //Active features of the state, sorted
+	std::vector<int> nextFeatures;  //Active features of the next state, empty if it is terminal
+	int action;                     //Action taken in the state
+	int nextAction;                 //Action taken in the next state, 0 if it is terminal
+	double reward;                  //Reward observed
+	bool isTerminal;                //Whether the next state is terminal
+};
+
+class ReplayBuffer{
+	private:
+		/**
+ 		* Piece of the arena, with the packed features of consecutive transitions.
+ 		*/
+		struct Chunk{
+			std::vector<unsigned char> data;
+			size_t used;                    //Bytes already written
+			int numLive;                    //Transitions in the chunk that were not overwritten
+		};
+		/**
+ 		* A position of the buffer.
+ 		*/
+		struct Slot{
+			Chunk *chunk;                   //NULL if the slot is empty
+			uint32_t offset;                //Position of the packed features in the chunk
+			int32_t action;
+			float reward;
+			bool isTerminal;
+		};
+
+		int capacity;                       //Maximum number of transitions
+		size_t chunkSize;                   //Default size of a chunk of the arena, in bytes
+		double exponent;                    //Priorities are |delta|^exponent, 0 for uniform sampling
+		double maxPriority;                 //Priority given to new transitions
+		std::vector<Slot> slots;
+		int newest;                         //Slot of the last transition added, -1 if none
+		int numStored;
+		std::deque<Chunk*> chunks;          //Chunks in use, the last one is being written
+		std::vector<Chunk*> freeChunks;     //Chunks that can be reused
+		std::vector<double> sumTree;        //Sum of the priorities, leaves start at treeSize
+		int treeSize;
+		std::vector<int> sorted;            //Scratch vector used to sort the features being added
+
+		/**
+ 		* Sets the priority of a slot in the sum tree.
+ 		*/
+		void setPriority(int slot, double priority);
+		/**
+ 		* Decodes the features packed at a given slot.
+ 		*/
+		void decode(const Slot &slot, std::vector<int> &features);
+		/**
+ 		* @return Chunk* chunk with at least numBytes free bytes, the current one or a new one
+ 		*/
+		Chunk* getChunk(size_t numBytes);
+		/**
+ 		* Removes the transition stored in a slot, releasing its chunk if it is not used anymore.
+ 		*/
+		void release(int slot);
+
+		/**
+ 		* Constructor declared as private to force the user to inform the size of the buffer.
+ 		*/
+		ReplayBuffer();
+	public:
+		/**
+ 		* Constructor.
+ 		*
+ 		* @param int capacity maximum number of transitions stored
+ 		* @param double exponent priorities are |delta|^exponent, 0 means uniform sampling
+ 		* @param size_t chunkSize size, in bytes, of the chunks of memory that store the features
+ 		*/
+		ReplayBuffer(int capacity, double exponent, size_t chunkSize = 1 << 24);
+		/**
+		* Destructor, it frees the arena.
+		*/
+		~ReplayBuffer();
+		/**
+ 		* Adds a transition. Its next state is the state of the next transition added, unless
+ 		* isTerminal is true, so the transitions of an episode must be added in order.
+ 		*
+ 		* @param vector<int>& features active features of the state, in any order
+ 		* @param int action action taken
+ 		* @param double reward reward observed, as used by the learner
+ 		* @param bool isTerminal whether the game was over after the action
+ 		*/
+		void add(const std::vector<int> &features, int action, double reward, bool isTerminal);
+		/**
+ 		* @return bool whether there is a transition that can be sampled
+ 		*/
+		bool canSample();
+		/**
+ 		* Samples a transition. canSample must be true.
+ 		*
+ 		* @param Random& rng random number generator owned by the caller
+ 		* @param ReplayTransition& transition object that receives the transition
+ 		*
+ 		* @return int slot of the transition, to update its priority
+ 		*/
+		int sample(Random &rng, ReplayTransition &transition);
+		/**
+ 		* Updates the priority of a transition after it was replayed.
+ 		*
+ 		* @param int slot value returned by sample
+ 		* @param double delta temporal difference error of the transition
+ 		*/
+		void updatePriority(int slot, double delta);
+		/**
+ 		* @return int number of transitions stored
+ 		*/
+		int size();
+		/**
+ 		* @return size_t bytes of the arena in use, not counting the fixed size of the slots
+ 		*/
+		size_t getArenaBytes();
+};
@@ -0,0 +1,467 @@
+/****************************************************************************************
+** Implementation of a multi-threaded Sarsa(lambda), in the style of Hogwild! (Niu et al.,
+** 2011). Each worker follows Fig. 8.8 (Linear, gradient-descent Sarsa(lambda)) from the book
+** "R. Sutton and A. Barto; Reinforcement Learning: An Introduction. 1st edition. 1988.",
+** updating weights shared by all workers.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef TIMER_H
+#define TIMER_H
+#include "../../../common/Timer.hpp"
+#endif
+#ifndef ATOMIC_H
+#define ATOMIC_H
+#include "../../../common/Atomic.hpp"
+#endif
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+#include "../../../common/SharedMemory.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "../../../environment/ALEFactory.hpp"
+#endif
+#ifndef POLICY_EVALUATOR_H
+#define POLICY_EVALUATOR_H
+#include "../PolicyEvaluator.hpp"
+#endif
+#include "HogwildSarsaLearner.hpp"
+#include <stdio.h>
+#include <math.h>
+#include <thread>
+#include <algorithm>
+#include <new>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+HogwildSarsaLearner::HogwildSarsaLearner(ALEInterface& ale, Features *features, Parameters *param) : RLLearner(ale, param) {
+	alpha = param->getAlpha();
+	lambda = param->getLambda();
+	traceThreshold = param->getTraceThreshold();
+	numFeatures = features->getNumberOfFeatures();
+	toSaveWeightsAfterLearning = param->getToSaveWeightsAfterLearning();
+	pathWeightsFileToLoad = param->getPathToWeightsFiles();
+	useProcesses = param->getUseProcesses();
+	//The counter is in shared memory so it is also seen by the workers when they are processes:
+	totalNumberFrames = new (mapSharedMemory(sizeof(std::atomic<int>))) std::atomic<int>(0);
+	workersDiverged = new (mapSharedMemory(sizeof(std::atomic<bool>))) std::atomic<bool>(false);
+	metricsLog = NULL;
+	metricsPipe = -1;
+
+	for(int i = 0; i < numActions; i++){
+		w.push_back(vector<weight_t>(numFeatures, 0.0));
+		weights.push_back(&w[i][0]);
+	}
+
+	if(toSaveWeightsAfterLearning){
+		std::stringstream ss;
+		ss << param->getFileWithWeights() << param->getSeed() << ".wgt";
+		nameWeightsFile =  ss.str();
+	}
+
+	if(param->getToLoadWeights()){
+		loadWeights();
+	}
+}
+
+HogwildSarsaLearner::~HogwildSarsaLearner(){
+	unmapSharedMemory(totalNumberFrames, sizeof(std::atomic<int>));
+	unmapSharedMemory(workersDiverged, sizeof(std::atomic<bool>));
+}
+
+void HogwildSarsaLearner::updateQValues(vector<int> &Features, vector<double> &QValues){
+	PROFILE_SCOPE(PHASE_Q_VALUES);
+	for(int a = 0; a < numActions; a++){
+		double sumW = 0;
+		for(unsigned int i = 0; i < Features.size(); i++){
+			sumW += atomicLoad(&weights[a][Features[i]]);
+		}
+		QValues[a] = sumW;
+	}
+}
+
+void HogwildSarsaLearner::updateReplTrace(vector<SparseTrace> &traces, int action, vector<int> &Features, SparseTrace &scratch){
+	PROFILE_SCOPE(PHASE_TRACES);
+	//e <- gamma * lambda * e
+	for(unsigned int a = 0; a < traces.size(); a++){
+		SparseTrace &trace = traces[a];
+		int numNonZero = 0;
+		for(unsigned int i = 0; i < trace.indices.size(); i++){
+			double value = gamma * lambda * trace.values[i];
+			//To keep the trace sparse, if it is
+			//less than a threshold it is removed.
+			if(value >= traceThreshold){
+				trace.indices[numNonZero] = trace.indices[i];
+				trace.values[numNonZero]  = value;
+				numNonZero++;
+			}
+		}
+		trace.indices.resize(numNonZero);
+		trace.values.resize(numNonZero);
+	}
+
+	//For all i in Fa: e[action][i] = 1. Both lists are sorted, so they are merged:
+	SparseTrace &trace = traces[action];
+	scratch.indices.clear();
+	scratch.values.clear();
+	unsigned int i = 0, j = 0;
+	while(i < trace.indices.size() || j < Features.size()){
+		if(j == Features.size() || (i < trace.indices.size() && trace.indices[i] < Features[j])){
+			scratch.indices.push_back(trace.indices[i]);
+			scratch.values.push_back(trace.values[i]);
+			i++;
+		}
+		else{
+			if(i < trace.indices.size() && trace.indices[i] == Features[j]){
+				i++;
+			}
+			//Repeated active features have a single entry in the trace
+			if(scratch.indices.empty() || scratch.indices.back() != Features[j]){
+				scratch.indices.push_back(Features[j]);
+				scratch.values.push_back(1.0);
+			}
+			j++;
+		}
+	}
+	trace.indices.swap(scratch.indices);
+	trace.values.swap(scratch.values);
+}
+
+void HogwildSarsaLearner::sanityCheck(vector<double> &QValues){
+	for(int i = 0; i < numActions; i++){
+		if(fabs(QValues[i]) > 10e7 || QValues[i] != QValues[i] /*NaN*/){
+			//Only the first worker to diverge prints it, the others just stop:
+			if(!workersDiverged->exchange(true) && toPrintEpisodes){
+				printf("It seems your algorithm diverged!\n");
+			}
+			return;
+		}
+	}
+}
+
+void HogwildSarsaLearner::saveWeightsToFile(string suffix){
+	std::ofstream weightsFile ((nameWeightsFile + suffix).c_str());
+	if(weightsFile.is_open()){
+		weightsFile << w.size() << " " << w[0].size() << std::endl;
+		for(unsigned int i = 0; i < w.size(); i++){
+			for(unsigned int j = 0; j < w[i].size(); j++){
+				if(w[i][j] != 0){
+					weightsFile << i << " " << j << " " << w[i][j] << std::endl;
+				}
+			}
+		}
+		weightsFile.close();
+	}
+	else{
+		printf("Unable to open file to write weights.\n");
+	}
+}
+
+void HogwildSarsaLearner::loadWeights(){
+	int nActions, nFeatures;
+	int i, j;
+	double value;
+
+	std::ifstream weightsFile (pathWeightsFileToLoad.c_str());
+
+	weightsFile >> nActions >> nFeatures;
+	assert(nActions == numActions);
+	assert(nFeatures == numFeatures);
+
+	while(weightsFile >> i >> j >> value){
+		w[i][j] = value;
+	}
+}
+
+void HogwildSarsaLearner::learnWorker(int workerId, ALEInterface& ale, Features *features, Random &rng){
+	struct timeval tvBegin, tvEnd, tvDiff;
+	double elapsedTime;
+	vector<int> F, Fnext;                      //Set of features active in the current and next state
+	vector<double> Q(numActions, 0.0);         //Q(a) entries
+	vector<double> Qnext(numActions, 0.0);     //Q(a) entries for next action
+	vector<double> reward(2, 0.0);
+	vector<SparseTrace> traces(numActions);    //Eligibility trace, private to this worker
+	SparseTrace scratch;
+	EpisodeMetrics metrics;
+	double cumReward = 0, prevCumReward = 0;
+	double firstReward = 1.0;
+	bool sawFirstReward = false;
+	unsigned int maxFeatVectorNorm = 1;
+	int currentAction, nextAction;
+	bool toStop = false;
+
+	//If START_STATES is set, the first episode also starts from a cached state:
+	if(startStates != NULL){
+		resetGame(ale, rng);
+	}
+
+	//Repeat (for each episode):
+	for(int episode = 0; !toStop && !*workersDiverged && *totalNumberFrames < totalNumberOfFramesToLearn; episode++){
+		//We have to clean the traces every episode:
+		for(int a = 0; a < numActions; a++){
+			traces[a].indices.clear();
+			traces[a].values.clear();
+		}
+		metrics.clear();
+		F.clear();
+		features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), F);
+		std::sort(F.begin(), F.end());
+		updateQValues(F, Q);
+		currentAction = epsilonGreedy(Q, rng);
+		int framesCounted = 0;
+		//Repeat(for each step of episode) until game is over:
+		gettimeofday(&tvBegin, NULL);
+
+		//This also stops when the maximum number of steps per episode is reached
+		while(!ale.game_over() && !toStop){
+			updateQValues(F, Q);
+			sanityCheck(Q);
+			//The divergence of any worker stops all of them, as they share the weights:
+			if(*workersDiverged){
+				break;
+			}
+			//Take action, observe reward and next state:
+			act(ale, currentAction, reward, firstReward, sawFirstReward);
+			cumReward += reward[1];
+			//The frames are counted at every step, so all workers stop as soon as the budget is over:
+			int newFrames = ale.getEpisodeFrameNumber() - framesCounted;
+			framesCounted = ale.getEpisodeFrameNumber();
+			toStop = totalNumberFrames->fetch_add(newFrames) + newFrames >= totalNumberOfFramesToLearn;
+
+			if(!ale.game_over()){
+				//Obtain active features in the new state:
+				Fnext.clear();
+				{
+					PROFILE_SCOPE(PHASE_FEATURES);
+					features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
+					std::sort(Fnext.begin(), Fnext.end());
+				}
+				updateQValues(Fnext, Qnext);     //Update Q-values for the new active features
+				nextAction = epsilonGreedy(Qnext, rng);
+			}
+			else{
+				nextAction = 0;
+				for(unsigned int i = 0; i < Qnext.size(); i++){
+					Qnext[i] = 0;
+				}
+			}
+			//To ensure the learning rate will never increase along
+			//the time, Marc used such approach in his JAIR paper
+			if (F.size() > maxFeatVectorNorm){
+				maxFeatVectorNorm = F.size();
+			}
+
+			double delta = reward[0] + gamma * Qnext[nextAction] - Q[currentAction];
+
+			updateReplTrace(traces, currentAction, F, scratch);
+			//Update the shared weights vector, without locking:
+			{
+				PROFILE_SCOPE(PHASE_WEIGHTS);
+				double stepSize = (alpha/maxFeatVectorNorm) * delta;
+				for(int a = 0; a < numActions; a++){
+					for(unsigned int i = 0; i < traces[a].indices.size(); i++){
+						atomicAdd(&weights[a][traces[a].indices[i]], stepSize * traces[a].values[i]);
+					}
+				}
+			}
+			int traceSize = 0;
+			for(int a = 0; a < numActions; a++){
+				traceSize += traces[a].indices.size();
+			}
+			metrics.addStep(F.size(), traceSize);
+			F.swap(Fnext);
+			currentAction = nextAction;
+		}
+		//The episode interrupted by the divergence is not reported:
+		if(*workersDiverged){
+			break;
+		}
+		gettimeofday(&tvEnd, NULL);
+		timeval_subtract(&tvDiff, &tvEnd, &tvBegin);
+		elapsedTime = double(tvDiff.tv_sec) + double(tvDiff.tv_usec)/1000000.0;
+
+		double fps = double(ale.getEpisodeFrameNumber())/elapsedTime;
+		if(toPrintEpisodes){
+			printf("worker: %d,\tepisode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
+				workerId, episode + 1, cumReward - prevCumReward, (double)cumReward/(episode + 1.0),
+				ale.getEpisodeFrameNumber(), fps);
+		}
+		PROFILE_END_EPISODE(episode + 1);
+		if(metricsLog != NULL){
+			metrics.close(episode + 1, workerId, ale.getEpisodeFrameNumber(), totalNumberFrames->load(),
+				maxFeatVectorNorm, cumReward - prevCumReward, elapsedTime);
+			//A child process cannot use the parent's writer, its records are saved by the parent:
+			if(metricsPipe >= 0){
+				if(write(metricsPipe, &metrics, sizeof(EpisodeMetrics)) != sizeof(EpisodeMetrics)){
+					perror("Unable to send the metrics of an episode to the parent");
+				}
+			}
+			else{
+				metricsLog->append(metrics);
+			}
+		}
+		prevCumReward = cumReward;
+		resetGame(ale, rng);
+	}
+}
+
+void HogwildSarsaLearner::learnWithThreads(ALEInterface& ale, Features *features, vector<Random> &workerRngs){
+	vector<ALEInterface*> emulators;
+	vector<Features*> featureExtractors;
+	vector<std::thread> workers;
+
+	//The first worker uses the objects passed as parameter, the others have their own:
+	emulators.push_back(&ale);
+	featureExtractors.push_back(features);
+	for(int i = 1; i < numThreads; i++){
+		emulators.push_back(ALEFactory::createALE(parameters, parameters->getSeed() + i));
+		featureExtractors.push_back(features->clone());
+	}
+	for(int i = 0; i < numThreads; i++){
+		workers.push_back(std::thread(&HogwildSarsaLearner::learnWorker, this, i,
+			std::ref(*emulators[i]), featureExtractors[i], std::ref(workerRngs[i])));
+	}
+	for(int i = 0; i < numThreads; i++){
+		workers[i].join();
+	}
+	for(int i = 1; i < numThreads; i++){
+		delete emulators[i];
+		delete featureExtractors[i];
+	}
+}
+
+void HogwildSarsaLearner::learnWithProcesses(Features *features, vector<Random> &workerRngs){
+	//The weights are moved to shared memory one action at a time, so they are never duplicated:
+	size_t rowBytes = numFeatures * sizeof(weight_t);
+	for(int a = 0; a < numActions; a++){
+		weights[a] = (weight_t*) mapSharedMemory(rowBytes);
+		memcpy(weights[a], &w[a][0], rowBytes);
+		vector<weight_t>().swap(w[a]);
+	}
+	int fds[2];
+	if(pipe(fds) != 0){
+		perror("Unable to create the pipe used by the workers");
+		exit(1);
+	}
+	//Otherwise what was not printed yet would be printed by every child:
+	fflush(stdout);
+
+	vector<pid_t> children;
+	for(int i = 0; i < numThreads; i++){
+		pid_t pid = fork();
+		if(pid < 0){
+			perror("Unable to create a worker process");
+			exit(1);
+		}
+		if(pid == 0){
+			close(fds[0]);
+			metricsPipe = fds[1];
+			//Each line is written at once, so the lines of different workers are not mixed:
+			setvbuf(stdout, NULL, _IOLBF, 0);
+			ALEInterface *workerAle = ALEFactory::createALE(parameters, parameters->getSeed() + i);
+			Features *workerFeatures = features->clone();
+			learnWorker(i, *workerAle, workerFeatures, workerRngs[i]);
+			fflush(stdout);
+			//The child must not run the destructors of the objects it inherited from the parent. If
+			//it diverged, the parent knows it from workersDiverged, which is in shared memory:
+			_exit(0);
+		}
+		children.push_back(pid);
+	}
+	close(fds[1]);
+
+	//The records of the children are saved until all of them close the pipe:
+	EpisodeMetrics metrics;
+	size_t numBytes = 0;
+	ssize_t numRead;
+	while((numRead = read(fds[0], (char*) &metrics + numBytes, sizeof(EpisodeMetrics) - numBytes)) != 0){
+		if(numRead < 0){
+			if(errno == EINTR){
+				continue;
+			}
+			break;
+		}
+		numBytes += numRead;
+		if(numBytes == sizeof(EpisodeMetrics)){
+			if(metricsLog != NULL){
+				metricsLog->append(metrics);
+			}
+			numBytes = 0;
+		}
+	}
+	close(fds[0]);
+	for(unsigned int i = 0; i < children.size(); i++){
+		int status;
+		waitpid(children[i], &status, 0);
+		if(!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+			printf("Worker %d did not finish properly.\n", i);
+		}
+	}
+
+	//The weights are moved back, one action at a time:
+	for(int a = 0; a < numActions; a++){
+		w[a].assign(weights[a], weights[a] + numFeatures);
+		unmapSharedMemory(weights[a], rowBytes);
+		weights[a] = &w[a][0];
+	}
+}
+
+void HogwildSarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
+	vector<Random> workerRngs;
+	//Each worker has its own stream of random numbers:
+	for(int i = 0; i < numThreads; i++){
+		workerRngs.push_back(rng.split());
+	}
+
+	//If requested, the metrics of the episodes of all workers are saved in a single binary file:
+	if(!parameters->getEpisodeLogPath().empty()){
+		metricsLog = new MetricsLog(parameters->getEpisodeLogPath());
+	}
+	*totalNumberFrames = 0;
+	*workersDiverged = false;
+	if(useProcesses){
+		learnWithProcesses(features, workerRngs);
+	}
+	else{
+		learnWithThreads(ale, features, workerRngs);
+	}
+	printf("Total number of frames seen by the %d workers: %d\n", numThreads, totalNumberFrames->load());
+	PROFILE_DUMP(parameters->getProfilePath());
+	delete metricsLog;
+	metricsLog = NULL;
+	diverged = *workersDiverged;
+
+	if(toSaveWeightsAfterLearning && !diverged){
+		saveWeightsToFile();
+	}
+}
+
+void HogwildSarsaLearner::evaluatePolicy(ALEInterface& ale, Features *features){
+	double cumReward = 0;
+	vector<double> returns, elapsedTimes;
+	vector<int> numFrames;
+
+	//The weights of a learner that diverged are not evaluated:
+	if(diverged){
+		return;
+	}
+	PolicyEvaluator evaluator(parameters, features, actions, epsilon, numThreads, rng.split());
+	if(quantizeBits > 0){
+		evaluateQuantized(evaluator, w, returns, numFrames, elapsedTimes);
+	}
+	else{
+		evaluator.evaluate(w, numEpisodesEval, returns, numFrames, elapsedTimes);
+	}
+	for(int episode = 0; episode < numEpisodesEval; episode++){
+		cumReward += returns[episode];
+		printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
+			episode + 1, returns[episode], (double)cumReward/(episode + 1.0), numFrames[episode],
+			double(numFrames[episode])/elapsedTimes[episode]);
+	}
+}
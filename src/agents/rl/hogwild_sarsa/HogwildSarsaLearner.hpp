@@ -0,0 +1,145 @@
+/****************************************************************************************
+** Implementation of a multi-threaded Sarsa(lambda), in the style of Hogwild! (Niu et al.,
+** 2011). NUM_THREADS workers learn at the same time, each one with its own emulator, its
+** own copy of the feature extractor and its own eligibility traces, while all of them read
+** and update a single weights vector without any locking. Since the features are sparse,
+** two workers rarely update the same weight at the same time and, when they do, the update
+** is done with a lock-free atomic add, so it is not lost.
+**
+** The frames are counted globally: the workers stop when all of them together have seen
+** TOTAL_FRAMES_LEARN frames (it may be exceeded by at most one action per worker).
+**
+** If USE_PROCESSES = 1 the workers are child processes created with fork instead of threads,
+** for the builds in which threads cannot be used (e.g. with SDL). Before forking, the weights
+** are moved, one action at a time, to memory shared with the children (see
+** common/SharedMemory.hpp), so they are never duplicated, and each child creates its own
+** emulator and feature extractor. The children send the metrics of their episodes to the
+** parent through a pipe; the parent is the only one writing files, and it moves the weights
+** back once all children are done, before saving or evaluating them.
+**
+** REMARKS: - The traces are stored as sparse vectors (indices sorted and their values) and
+**            not as dense vectors as in SarsaLearner. A dense trace per worker would take as
+**            much memory as the weights themselves, which is what we are trying to avoid.
+**          - Each worker normalizes the learning rate by the largest feature vector it has
+**            seen and the reward by the first reward it has seen.
+**          - With processes, the profile (PROFILE=1) only has the time spent by the parent.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef RLLEARNER_H
+#define RLLEARNER_H
+#include "../RLLearner.hpp"
+#endif
+#include <vector>
+#include <atomic>
+
+class HogwildSarsaLearner : public RLLearner{
+	private:
+		/**
+ 		* Eligibility trace of a single action, only the non-zero entries are stored.
+ 		*/
+		struct SparseTrace{
+			vector<int> indices;            //Indices of the non-zero entries, in increasing order
+			vector<trace_t> values;         //Value of each non-zero entry
+		};
+
+		double alpha, lambda, traceThreshold;
+		int numFeatures;
+		int toSaveWeightsAfterLearning;
+
+		std::string nameWeightsFile, pathWeightsFileToLoad;
+
+		vector<vector<weight_t> > w;        //Theta, weights vector, shared by all workers
+		vector<weight_t*> weights;          //Weights of each action read and updated by the workers, in w or in shared memory
+		std::atomic<int> *totalNumberFrames;//Frames seen by all workers together, in shared memory
+		std::atomic<bool> *workersDiverged; //Set by the first worker whose Q-values diverge, it stops all of them, in shared memory
+		MetricsLog *metricsLog;             //Metrics of the episodes of all workers, NULL if not requested
+		int metricsPipe;                    //Pipe through which a child process sends its metrics, -1 in the parent
+		int useProcesses;
+
+		/**
+ 		* Constructor declared as private to force the user to instantiate HogwildSarsaLearner
+ 		* informing the parameters to learning/execution.
+ 		*/
+		HogwildSarsaLearner();
+		/**
+ 		* Loop executed by each worker: it plays episodes, updating the shared weights, until the
+ 		* total number of frames to learn is reached.
+ 		*
+ 		* @param int workerId index of the worker
+ 		* @param ALEInterface& ale emulator owned by this worker
+ 		* @param Features *features feature extractor owned by this worker
+ 		* @param Random &rng random number generator owned by this worker
+ 		*/
+		void learnWorker(int workerId, ALEInterface& ale, Features *features, Random &rng);
+		/**
+ 		* Runs the workers in threads, the first one using the emulator and feature extractor passed
+ 		* as parameter.
+ 		*
+ 		* @param vector<Random>& workerRngs random number generator of each worker
+ 		*/
+		void learnWithThreads(ALEInterface& ale, Features *features, vector<Random> &workerRngs);
+		/**
+ 		* Runs the workers in child processes, which share the weights with this process, and saves
+ 		* the metrics they send while they learn. It only returns once all children are done.
+ 		*
+ 		* @param vector<Random>& workerRngs random number generator of each worker
+ 		*/
+		void learnWithProcesses(Features *features, vector<Random> &workerRngs);
+		/**
+ 		* Sum of the weights of the active features for each action. The weights may be being
+ 		* written by other workers, so they are read atomically.
+ 		*/
+		void updateQValues(vector<int> &Features, vector<double> &QValues);
+		/**
+ 		* Replacing traces: all traces decay following the rule e[a][i] = gamma * lambda * e[a][i],
+ 		* being removed when smaller than the threshold, then the traces of the active features for
+ 		* the current action are set to 1.
+ 		*
+ 		* @param vector<SparseTrace>& traces traces of the worker, one per action
+ 		* @param int action action taken
+ 		* @param vector<int>& Features active features, in increasing order
+ 		* @param SparseTrace& scratch buffer reused across calls to avoid allocations
+ 		*/
+		void updateReplTrace(vector<SparseTrace> &traces, int action, vector<int> &Features, SparseTrace &scratch);
+		/**
+ 		* This method evaluates whether the Q-values are sound. By unsound I mean huge Q-values (> 10e7)
+ 		* or NaN values. If so, it informs the algorithm has diverged and sets the flag shared by the
+ 		* workers, which stops all of them; learnPolicy then sets diverged (see RLLearner::hasDiverged).
+ 		*/
+		void sanityCheck(vector<double> &QValues);
+		/**
+ 		* Prints the weights in a file. Each line will contain a weight.
+ 		*/
+		void saveWeightsToFile(string suffix="");
+		/**
+ 		* Loads the weights saved in a file. Each line will contain a weight.
+ 		*/
+		void loadWeights();
+	public:
+		HogwildSarsaLearner(ALEInterface& ale, Features *features, Parameters *param);
+		/**
+ 		* Implementation of an agent controller. This implementation is a multi-threaded Sarsa(lambda).
+ 		* The emulator passed as parameter is used by the first worker, the other workers create their
+ 		* own.
+ 		*
+ 		* @param ALEInterface& ale Arcade Learning Environment interface: object used to define agents'
+ 		*        actions, obtain simulator's screen, RAM, etc.
+ 		* @param Features *features object that defines what feature function that will be used.
+ 		*/
+		void learnPolicy(ALEInterface& ale, Features *features);
+		/**
+ 		* After the policy was learned it is necessary to evaluate its quality. Therefore, a given number
+ 		* of episodes is run without learning, in parallel, using one thread per worker.
+ 		*
+ 		* @param ALEInterface& ale Arcade Learning Environment interface: object used to define agents'
+ 		*        actions, obtain simulator's screen, RAM, etc.
+ 		* @param Features *features object that defines what feature function that will be used.
+ 		*/
+		void evaluatePolicy(ALEInterface& ale, Features *features);
+		/**
+		* Destructor, it releases the shared frame counter and divergence flag.
+		*/
+		~HogwildSarsaLearner();
+};
@@ -17,6 +17,14 @@
 #define TIMER_H
 #include "../../../common/Timer.hpp"
 #endif
+#ifndef POLICY_EVALUATOR_H
+#define POLICY_EVALUATOR_H
+#include "../PolicyEvaluator.hpp"
+#endif
+#ifndef ONLINE_EVALUATOR_H
+#define ONLINE_EVALUATOR_H
+#include "../OnlineEvaluator.hpp"
+#endif
 #include "QLearner.hpp"
 #include <stdio.h>
 #include <math.h>
@@ -42,11 +50,15 @@ QLearner::QLearner(ALEInterface& ale, Features *features, Parameters *param) : R
 		Q.push_back(0);
 		Qnext.push_back(0);
 		//Initialize e:
-		e.push_back(vector<double>(numFeatures, 0.0));
-		w.push_back(vector<double>(numFeatures, 0.0));
+		e.push_back(vector<trace_t>(numFeatures, 0.0));
+		w.push_back(vector<weight_t>(numFeatures, 0.0));
 
 		nonZeroElig.push_back(vector<int>());
 	}
+	//If requested, the Q-values are kept from one active set to the next:
+	if(param->getIncrementalQRefresh() > 0){
+		incrementalQ = new IncrementalQValues(&w, param->getIncrementalQRefresh());
+	}
 }
 
 QLearner::~QLearner(){}
@@ -73,6 +85,11 @@ void QLearner::updateReplTrace(int action){
 }
 
 void QLearner::updateQValues(vector<int> &Features, vector<double> &QValues){
+	PROFILE_SCOPE(PHASE_Q_VALUES);
+	if(incrementalQ != NULL){
+		incrementalQ->compute(Features, QValues);
+		return;
+	}
 	for(int a = 0; a < numActions; a++){
 		double sumW = 0;
 		for(unsigned int i = 0; i < Features.size(); i++){
@@ -85,20 +102,43 @@ void QLearner::updateQValues(vector<int> &Features, vector<double> &QValues){
 void QLearner::sanityCheck(){
 	for(int i = 0; i < numActions; i++){
 		if(Q[i] > 10e7 || Q[i] != Q[i] /*NaN*/){
-			printf("It seems your algorithm diverged!\n");
-			exit(0);
+			//The runs of a sweep do not print, their divergence is reported in the summary:
+			if(toPrintEpisodes){
+				printf("It seems your algorithm diverged!\n");
+			}
+			diverged = true;
+			return;
 		}
 	}
 }
 
 void QLearner::learnPolicy(ALEInterface& ale, Features *features){
 	struct timeval tvBegin, tvEnd, tvDiff;
-	vector<double> reward;
+	vector<double> reward(2, 0.0);
 	double elapsedTime;
 	double cumReward = 0, prevCumReward = 0;
 	unsigned int maxFeatVectorNorm = 1;
 	sawFirstReward = 0; firstReward = 1.0;
 
+	//If requested, the weights are evaluated in a separate thread while learning:
+	OnlineEvaluator *onlineEvaluator = NULL;
+	int onlineEvalFrequency = parameters->getOnlineEvalFrequency();
+	int nextOnlineEval = onlineEvalFrequency;
+	if(onlineEvalFrequency > 0){
+		onlineEvaluator = new OnlineEvaluator(parameters, features, actions, w, rng.split());
+	}
+	//If requested, the metrics of each episode are saved in a binary file:
+	EpisodeMetrics metrics;
+	MetricsLog *metricsLog = NULL;
+	if(!parameters->getEpisodeLogPath().empty()){
+		metricsLog = new MetricsLog(parameters->getEpisodeLogPath());
+	}
+
+	//If START_STATES is set, the first episode also starts from a cached state:
+	if(startStates != NULL){
+		resetGame(ale, startRng);
+	}
+
 	//Repeat (for each episode):
 	int episode, totalNumberFrames = 0;
 	//This is going to be interrupted by the ALE code since I set max_num_frames beforehand
@@ -113,6 +153,7 @@ void QLearner::learnPolicy(ALEInterface& ale, Features *features){
 			nonZeroElig[a].clear();
 		}
 
+		metrics.clear();
 		F.clear();
 		features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), F);
 		//To ensure the learning rate will never increase along
@@ -124,11 +165,11 @@ void QLearner::learnPolicy(ALEInterface& ale, Features *features){
 
 		//This also stops when the maximum number of steps per episode is reached
 		while(!ale.game_over()){
-			reward.clear();
-			reward.push_back(0.0);
-			reward.push_back(0.0);
 			updateQValues(F, Q);
 			sanityCheck();
+			if(diverged){
+				break;
+			}
 
 			//Take action, observe reward and next state:
 			currentAction = epsilonGreedy(Q);
@@ -138,14 +179,17 @@ void QLearner::learnPolicy(ALEInterface& ale, Features *features){
 			if(!ale.game_over()){
 				//Obtain active features in the new state:
 				Fnext.clear();
-				features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
+				{
+					PROFILE_SCOPE(PHASE_FEATURES);
+					features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
+				}
 				//To ensure the learning rate will never increase along
 				//the time, Marc used such approach in his JAIR paper
 				if (Fnext.size() > maxFeatVectorNorm){
 					maxFeatVectorNorm = Fnext.size();
 				}
 				updateQValues(Fnext, Qnext);     //Update Q-values for the new active features
-				nextAction = Mathematics::argmax(Qnext);
+				nextAction = Mathematics::argmax(Qnext, rng);
 			}
 			else{
 				nextAction = 0;
@@ -155,50 +199,94 @@ void QLearner::learnPolicy(ALEInterface& ale, Features *features){
 			}
 			delta = reward[0] + gamma * Qnext[nextAction] - Q[currentAction];
 			
-			if(randomActionTaken) {
+			{
+				PROFILE_SCOPE(PHASE_TRACES);
+				if(randomActionTaken) {
+					for(unsigned int a = 0; a < nonZeroElig.size(); a++){
+						for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
+							int idx = nonZeroElig[a][i];
+							e[a][idx] = 0.0;
+						}
+						nonZeroElig[a].clear();
+					}
+				}
+				else{
+					updateReplTrace(currentAction);
+				}
+				//The lists of all actions grow together (see RLLearner::reserveTraces):
+				reserveTraces(nonZeroElig, nonZeroElig[currentAction].size() + F.size());
+				//For all i in Fa:
+				for(unsigned int i = 0; i < F.size(); i++){
+					int idx = F[i];
+					//If the trace is zero it is not in the vector
+					//of non-zeros, thus it needs to be added
+					if(e[currentAction][idx] == 0){
+				       nonZeroElig[currentAction].push_back(idx);
+				    }
+					e[currentAction][idx] = 1;
+				}
+			}
+
+			//Update weights vector:
+			{
+				PROFILE_SCOPE(PHASE_WEIGHTS);
 				for(unsigned int a = 0; a < nonZeroElig.size(); a++){
 					for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
 						int idx = nonZeroElig[a][i];
-						e[a][idx] = 0.0;
+						weight_t previous = w[a][idx];
+						w[a][idx] = w[a][idx] + (alpha/(maxFeatVectorNorm)) * delta * e[a][idx];
+						if(incrementalQ != NULL){
+							incrementalQ->weightChanged(a, idx, w[a][idx] - previous);
+						}
 					}
-					nonZeroElig[a].clear();
 				}
 			}
-			else{
-				updateReplTrace(currentAction);
+			//If requested, transitions seen before are replayed after the online update:
+			if(replayBuffer != NULL){
+				replayBuffer->add(F, currentAction, reward[0], ale.game_over());
+				replayTransitions(w, alpha/maxFeatVectorNorm, true, onlineEvaluator);
 			}
-			//For all i in Fa:
-			for(unsigned int i = 0; i < F.size(); i++){
-				int idx = F[i];
-				//If the trace is zero it is not in the vector
-				//of non-zeros, thus it needs to be added
-				if(e[currentAction][idx] == 0){
-			       nonZeroElig[currentAction].push_back(idx);
-			    }
-				e[currentAction][idx] = 1;
-			}
-
-			//Update weights vector:
-			for(unsigned int a = 0; a < nonZeroElig.size(); a++){
-				for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
-					int idx = nonZeroElig[a][i];
-					w[a][idx] = w[a][idx] + (alpha/(maxFeatVectorNorm)) * delta * e[a][idx];
+			if(onlineEvaluator != NULL){
+				onlineEvaluator->markModified(nonZeroElig);
+				if(totalNumberFrames + ale.getEpisodeFrameNumber() >= nextOnlineEval){
+					onlineEvaluator->publish(w, totalNumberFrames + ale.getEpisodeFrameNumber(), episode);
+					nextOnlineEval += onlineEvalFrequency;
 				}
 			}
-			F = Fnext;
+			metrics.addStep(F.size(), nonZeroElig);
+			F.swap(Fnext);
+		}
+		//The episode interrupted by the divergence is not reported:
+		if(diverged){
+			break;
 		}
 		gettimeofday(&tvEnd, NULL);
 		timeval_subtract(&tvDiff, &tvEnd, &tvBegin);
 		elapsedTime = double(tvDiff.tv_sec) + double(tvDiff.tv_usec)/1000000.0;
 		
 		double fps = double(ale.getEpisodeFrameNumber())/elapsedTime;
-		printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
-			episode + 1, cumReward - prevCumReward, (double)cumReward/(episode + 1.0),
-			ale.getEpisodeFrameNumber(), fps);
+		if(toPrintEpisodes){
+			printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
+				episode + 1, cumReward - prevCumReward, (double)cumReward/(episode + 1.0),
+				ale.getEpisodeFrameNumber(), fps);
+		}
+		PROFILE_END_EPISODE(episode + 1);
 		totalNumberFrames += ale.getEpisodeFrameNumber();
+		if(metricsLog != NULL){
+			metrics.close(episode + 1, 0, ale.getEpisodeFrameNumber(), totalNumberFrames, maxFeatVectorNorm,
+				cumReward - prevCumReward, elapsedTime);
+			metricsLog->append(metrics);
+		}
 		prevCumReward = cumReward;
-		ale.reset_game();
+		resetGame(ale, startRng);
+	}
+	if(onlineEvaluator != NULL){
+		//The final weights are always evaluated, the destructor waits for it:
+		onlineEvaluator->publish(w, totalNumberFrames, episode);
+		delete onlineEvaluator;
 	}
+	delete metricsLog;
+	PROFILE_DUMP(parameters->getProfilePath());
 }
 
 void QLearner::evaluatePolicy(ALEInterface& ale, Features *features){
@@ -206,6 +294,25 @@ void QLearner::evaluatePolicy(ALEInterface& ale, Features *features){
 	double cumReward = 0; 
 	double prevCumReward = 0;
 
+	//The evaluation episodes are independent, so they are run in parallel when possible (the quantized
+	//weights are only evaluated by the PolicyEvaluator):
+	if(numThreads > 1 || quantizeBits > 0){
+		vector<double> returns, elapsedTimes;
+		vector<int> numFrames;
+		PolicyEvaluator evaluator(parameters, features, actions, epsilon, numThreads, rng.split());
+		if(quantizeBits > 0){
+			evaluateQuantized(evaluator, w, returns, numFrames, elapsedTimes);
+		}
+		else{
+			evaluator.evaluate(w, numEpisodesEval, returns, numFrames, elapsedTimes);
+		}
+		for(int episode = 0; episode < numEpisodesEval; episode++){
+			cumReward += returns[episode];
+			printf("%d, %f, %f\n", episode + 1, (double)cumReward/(episode + 1.0), returns[episode]);
+		}
+		return;
+	}
+
 	//Repeat (for each episode):
 	for(int episode = 0; episode < numEpisodesEval; episode++){
 		//Repeat(for each step of episode) until game is over:
@@ -221,6 +328,9 @@ void QLearner::evaluatePolicy(ALEInterface& ale, Features *features){
 		}
 		ale.reset_game();
 		sanityCheck();
+		if(diverged){
+			return;
+		}
 		
 		printf("%d, %f, %f\n", episode + 1, (double)cumReward/(episode + 1.0), cumReward-prevCumReward);
 		
@@ -13,6 +13,14 @@
 #define TIMER_H
 #include "../../../common/Timer.hpp"
 #endif
+#ifndef POLICY_EVALUATOR_H
+#define POLICY_EVALUATOR_H
+#include "../PolicyEvaluator.hpp"
+#endif
+#ifndef ONLINE_EVALUATOR_H
+#define ONLINE_EVALUATOR_H
+#include "../OnlineEvaluator.hpp"
+#endif
 #include "SarsaLearner.hpp"
 #include <stdio.h>
 #include <math.h>
@@ -33,8 +41,8 @@ SarsaLearner::SarsaLearner(ALEInterface& ale, Features *features, Parameters *pa
 		Q.push_back(0);
 		Qnext.push_back(0);
 		//Initialize e:
-		e.push_back(vector<double>(numFeatures, 0.0));
-		w.push_back(vector<double>(numFeatures, 0.0));
+		e.push_back(vector<trace_t>(numFeatures, 0.0));
+		w.push_back(vector<weight_t>(numFeatures, 0.0));
 		nonZeroElig.push_back(vector<int>());
 	}
 
@@ -47,11 +55,20 @@ SarsaLearner::SarsaLearner(ALEInterface& ale, Features *features, Parameters *pa
 	if(param->getToLoadWeights()){
 		loadWeights();
 	}
+	//If requested, the Q-values are kept from one active set to the next:
+	if(param->getIncrementalQRefresh() > 0){
+		incrementalQ = new IncrementalQValues(&w, param->getIncrementalQRefresh());
+	}
 }
 
 SarsaLearner::~SarsaLearner(){}
 
 void SarsaLearner::updateQValues(vector<int> &Features, vector<double> &QValues){
+	PROFILE_SCOPE(PHASE_Q_VALUES);
+	if(incrementalQ != NULL){
+		incrementalQ->compute(Features, QValues);
+		return;
+	}
 	for(int a = 0; a < numActions; a++){
 		double sumW = 0;
 		for(unsigned int i = 0; i < Features.size(); i++){
@@ -62,6 +79,7 @@ void SarsaLearner::updateQValues(vector<int> &Features, vector<double> &QValues)
 }
 
 void SarsaLearner::updateReplTrace(int action, vector<int> &Features){
+	PROFILE_SCOPE(PHASE_TRACES);
 	//e <- gamma * lambda * e
 	for(unsigned int a = 0; a < nonZeroElig.size(); a++){
 		int numNonZero = 0;
@@ -81,6 +99,8 @@ void SarsaLearner::updateReplTrace(int action, vector<int> &Features){
 		nonZeroElig[a].resize(numNonZero);
 	}
 
+	//The lists of all actions grow together (see RLLearner::reserveTraces):
+	reserveTraces(nonZeroElig, nonZeroElig[action].size() + F.size());
 	//For all i in Fa:
 	for(unsigned int i = 0; i < F.size(); i++){
 		int idx = Features[i];
@@ -94,6 +114,7 @@ void SarsaLearner::updateReplTrace(int action, vector<int> &Features){
 }
 
 void SarsaLearner::updateAcumTrace(int action, vector<int> &Features){
+	PROFILE_SCOPE(PHASE_TRACES);
 	//e <- gamma * lambda * e
 	for(unsigned int a = 0; a < nonZeroElig.size(); a++){
 		int numNonZero = 0;
@@ -113,6 +134,8 @@ void SarsaLearner::updateAcumTrace(int action, vector<int> &Features){
 		nonZeroElig[a].resize(numNonZero);
 	}
 
+	//The lists of all actions grow together (see RLLearner::reserveTraces):
+	reserveTraces(nonZeroElig, nonZeroElig[action].size() + F.size());
 	//For all i in Fa:
 	for(unsigned int i = 0; i < F.size(); i++){
 		int idx = Features[i];
@@ -128,8 +151,12 @@ void SarsaLearner::updateAcumTrace(int action, vector<int> &Features){
 void SarsaLearner::sanityCheck(){
 	for(int i = 0; i < numActions; i++){
 		if(fabs(Q[i]) > 10e7 || Q[i] != Q[i] /*NaN*/){
-			printf("It seems your algorithm diverged!\n");
-			exit(0);
+			//The runs of a sweep do not print, their divergence is reported in the summary:
+			if(toPrintEpisodes){
+				printf("It seems your algorithm diverged!\n");
+			}
+			diverged = true;
+			return;
 		}
 	}
 }
@@ -172,12 +199,31 @@ void SarsaLearner::loadWeights(){
 void SarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 	
 	struct timeval tvBegin, tvEnd, tvDiff;
-	vector<double> reward;
+	vector<double> reward(2, 0.0);
 	double elapsedTime;
 	double cumReward = 0, prevCumReward = 0;
 	unsigned int maxFeatVectorNorm = 1;
 	sawFirstReward = 0; firstReward = 1.0;
 
+	//If requested, the weights are evaluated in a separate thread while learning:
+	OnlineEvaluator *onlineEvaluator = NULL;
+	int onlineEvalFrequency = parameters->getOnlineEvalFrequency();
+	int nextOnlineEval = onlineEvalFrequency;
+	if(onlineEvalFrequency > 0){
+		onlineEvaluator = new OnlineEvaluator(parameters, features, actions, w, rng.split());
+	}
+	//If requested, the metrics of each episode are saved in a binary file:
+	EpisodeMetrics metrics;
+	MetricsLog *metricsLog = NULL;
+	if(!parameters->getEpisodeLogPath().empty()){
+		metricsLog = new MetricsLog(parameters->getEpisodeLogPath());
+	}
+
+	//If START_STATES is set, the first episode also starts from a cached state:
+	if(startStates != NULL){
+		resetGame(ale, startRng);
+	}
+
 	//Repeat (for each episode):
 	int episode, totalNumberFrames = 0;
 	//This is going to be interrupted by the ALE code since I set max_num_frames beforehand
@@ -190,6 +236,7 @@ void SarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 			}
 			nonZeroElig[a].clear();
 		}
+		metrics.clear();
 		F.clear();
 		features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), F);
 		updateQValues(F, Q);
@@ -199,19 +246,22 @@ void SarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 
 		//This also stops when the maximum number of steps per episode is reached
 		while(!ale.game_over()){
-			reward.clear();
-			reward.push_back(0.0);
-			reward.push_back(0.0);
 			updateQValues(F, Q);
 
 			sanityCheck();
+			if(diverged){
+				break;
+			}
 			//Take action, observe reward and next state:
 			act(ale, currentAction, reward);
 			cumReward  += reward[1];
 			if(!ale.game_over()){
 				//Obtain active features in the new state:
 				Fnext.clear();
-				features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
+				{
+					PROFILE_SCOPE(PHASE_FEATURES);
+					features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
+				}
 				updateQValues(Fnext, Qnext);     //Update Q-values for the new active features
 				nextAction = epsilonGreedy(Qnext);
 			}
@@ -231,33 +281,72 @@ void SarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 
 			updateReplTrace(currentAction, F);
 			//Update weights vector:
-			for(unsigned int a = 0; a < nonZeroElig.size(); a++){
-				for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
-					int idx = nonZeroElig[a][i];
-					w[a][idx] = w[a][idx] + (alpha/maxFeatVectorNorm) * delta * e[a][idx];
+			{
+				PROFILE_SCOPE(PHASE_WEIGHTS);
+				for(unsigned int a = 0; a < nonZeroElig.size(); a++){
+					for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
+						int idx = nonZeroElig[a][i];
+						weight_t previous = w[a][idx];
+						w[a][idx] = w[a][idx] + (alpha/maxFeatVectorNorm) * delta * e[a][idx];
+						if(incrementalQ != NULL){
+							incrementalQ->weightChanged(a, idx, w[a][idx] - previous);
+						}
+					}
+				}
+			}
+			//If requested, transitions seen before are replayed after the online update:
+			if(replayBuffer != NULL){
+				replayBuffer->add(F, currentAction, reward[0], ale.game_over());
+				replayTransitions(w, alpha/maxFeatVectorNorm, false, onlineEvaluator);
+			}
+			if(onlineEvaluator != NULL){
+				onlineEvaluator->markModified(nonZeroElig);
+				if(totalNumberFrames + ale.getEpisodeFrameNumber() >= nextOnlineEval){
+					onlineEvaluator->publish(w, totalNumberFrames + ale.getEpisodeFrameNumber(), episode);
+					nextOnlineEval += onlineEvalFrequency;
 				}
 			}
-			F = Fnext;
+			metrics.addStep(F.size(), nonZeroElig);
+			F.swap(Fnext);
 			currentAction = nextAction;
 		}
+		//The episode interrupted by the divergence is not reported:
+		if(diverged){
+			break;
+		}
 		gettimeofday(&tvEnd, NULL);
 		timeval_subtract(&tvDiff, &tvEnd, &tvBegin);
 		elapsedTime = double(tvDiff.tv_sec) + double(tvDiff.tv_usec)/1000000.0;
 		
 		double fps = double(ale.getEpisodeFrameNumber())/elapsedTime;
-		printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
-			episode + 1, cumReward - prevCumReward, (double)cumReward/(episode + 1.0),
-			ale.getEpisodeFrameNumber(), fps);
+		if(toPrintEpisodes){
+			printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
+				episode + 1, cumReward - prevCumReward, (double)cumReward/(episode + 1.0),
+				ale.getEpisodeFrameNumber(), fps);
+		}
+		PROFILE_END_EPISODE(episode + 1);
 		totalNumberFrames += ale.getEpisodeFrameNumber();
+		if(metricsLog != NULL){
+			metrics.close(episode + 1, 0, ale.getEpisodeFrameNumber(), totalNumberFrames, maxFeatVectorNorm,
+				cumReward - prevCumReward, elapsedTime);
+			metricsLog->append(metrics);
+		}
 		prevCumReward = cumReward;
-		ale.reset_game();
+		resetGame(ale, startRng);
 		if(toSaveWeightsAfterLearning && episode%saveWeightsEveryXSteps == 0 && episode > 0){
 			stringstream ss;
 			ss << episode;
 			saveWeightsToFile(ss.str());
 		}
 	}
-	if(toSaveWeightsAfterLearning){
+	if(onlineEvaluator != NULL){
+		//The final weights are always evaluated, the destructor waits for it:
+		onlineEvaluator->publish(w, totalNumberFrames, episode);
+		delete onlineEvaluator;
+	}
+	delete metricsLog;
+	PROFILE_DUMP(parameters->getProfilePath());
+	if(toSaveWeightsAfterLearning && !diverged){
 		stringstream ss;
 		ss << episode;
 		saveWeightsToFile(ss.str());
@@ -271,6 +360,27 @@ void SarsaLearner::evaluatePolicy(ALEInterface& ale, Features *features){
 	struct timeval tvBegin, tvEnd, tvDiff;
 	double elapsedTime;
 
+	//The evaluation episodes are independent, so they are run in parallel when possible (the quantized
+	//weights are only evaluated by the PolicyEvaluator):
+	if(numThreads > 1 || quantizeBits > 0){
+		vector<double> returns, elapsedTimes;
+		vector<int> numFrames;
+		PolicyEvaluator evaluator(parameters, features, actions, epsilon, numThreads, rng.split());
+		if(quantizeBits > 0){
+			evaluateQuantized(evaluator, w, returns, numFrames, elapsedTimes);
+		}
+		else{
+			evaluator.evaluate(w, numEpisodesEval, returns, numFrames, elapsedTimes);
+		}
+		for(int episode = 0; episode < numEpisodesEval; episode++){
+			cumReward += returns[episode];
+			printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
+				episode + 1, returns[episode], (double)cumReward/(episode + 1.0), numFrames[episode],
+				double(numFrames[episode])/elapsedTimes[episode]);
+		}
+		return;
+	}
+
 	//Repeat (for each episode):
 	for(int episode = 0; episode < numEpisodesEval; episode++){
 		//Repeat(for each step of episode) until game is over:
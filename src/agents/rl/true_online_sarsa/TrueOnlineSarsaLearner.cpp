@@ -13,6 +13,14 @@
 #define TIMER_H
 #include "../../../common/Timer.hpp"
 #endif
+#ifndef POLICY_EVALUATOR_H
+#define POLICY_EVALUATOR_H
+#include "../PolicyEvaluator.hpp"
+#endif
+#ifndef ONLINE_EVALUATOR_H
+#define ONLINE_EVALUATOR_H
+#include "../OnlineEvaluator.hpp"
+#endif
 #include "TrueOnlineSarsaLearner.hpp"
 #include <stdio.h>
 #include <math.h>
@@ -30,8 +38,8 @@ TrueOnlineSarsaLearner::TrueOnlineSarsaLearner(ALEInterface& ale, Features *feat
 		Q.push_back(0);
 		Qnext.push_back(0);
 		//Initialize e:
-		e.push_back(vector<double>(numFeatures, 0.0));
-		w.push_back(vector<double>(numFeatures, 0.0));
+		e.push_back(vector<trace_t>(numFeatures, 0.0));
+		w.push_back(vector<weight_t>(numFeatures, 0.0));
 
 		nonZeroElig.push_back(vector<int>());
 	}
@@ -39,11 +47,20 @@ TrueOnlineSarsaLearner::TrueOnlineSarsaLearner(ALEInterface& ale, Features *feat
 	std::stringstream ss;
 	ss << "weights_" << param->getSeed() << ".wgt";
 	nameWeightsFile =  ss.str();
+	//If requested, the Q-values are kept from one active set to the next:
+	if(param->getIncrementalQRefresh() > 0){
+		incrementalQ = new IncrementalQValues(&w, param->getIncrementalQRefresh());
+	}
 }
 
 TrueOnlineSarsaLearner::~TrueOnlineSarsaLearner(){}
 
 void TrueOnlineSarsaLearner::updateQValues(vector<int> &Features, vector<double> &QValues){
+	PROFILE_SCOPE(PHASE_Q_VALUES);
+	if(incrementalQ != NULL){
+		incrementalQ->compute(Features, QValues);
+		return;
+	}
 	for(int a = 0; a < numActions; a++){
 		double sumW = 0;
 		for(unsigned int i = 0; i < Features.size(); i++){
@@ -54,20 +71,30 @@ void TrueOnlineSarsaLearner::updateQValues(vector<int> &Features, vector<double>
 }
 
 void TrueOnlineSarsaLearner::updateWeights(int action, double alpha, double delta_q){
+	PROFILE_SCOPE(PHASE_WEIGHTS);
 	for(unsigned int a = 0; a < nonZeroElig.size(); a++){
 		for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
 			int idx = nonZeroElig[a][i];
+			weight_t previous = w[a][idx];
 			w[a][idx] = w[a][idx] + alpha * (delta + delta_q) * e[a][idx];
+			if(incrementalQ != NULL){
+				incrementalQ->weightChanged(a, idx, w[a][idx] - previous);
+			}
 		}
 	}
 
 	for(unsigned int i = 0; i < F.size(); i++){
 		int idx = F[i];
+		weight_t previous = w[action][idx];
 		w[action][idx] = w[action][idx] - alpha * delta_q;
+		if(incrementalQ != NULL){
+			incrementalQ->weightChanged(action, idx, w[action][idx] - previous);
+		}
 	}
 }
 
 void TrueOnlineSarsaLearner::updateTrace(int action, double alpha){
+	PROFILE_SCOPE(PHASE_TRACES);
 	double dot_e_phi = 0;
 	for(unsigned int i = 0; i < F.size(); i++){
 		int idx = F[i];
@@ -75,6 +102,8 @@ void TrueOnlineSarsaLearner::updateTrace(int action, double alpha){
 	}
 	int numNonZero = 0;
 	if((1 - alpha * dot_e_phi) > traceThreshold){
+		//The lists of all actions grow together (see RLLearner::reserveTraces):
+		reserveTraces(nonZeroElig, nonZeroElig[action].size() + F.size());
 		for(unsigned int i = 0; i < F.size(); i++){
 			int idx = F[i];
 			if(e[action][idx] == 0){
@@ -86,6 +115,7 @@ void TrueOnlineSarsaLearner::updateTrace(int action, double alpha){
 }
 
 void TrueOnlineSarsaLearner::decayTrace(){
+	PROFILE_SCOPE(PHASE_TRACES);
 	//e <- gamma * lambda * e
 	for(unsigned int a = 0; a < nonZeroElig.size(); a++){
 		int numNonZero = 0;
@@ -109,8 +139,12 @@ void TrueOnlineSarsaLearner::decayTrace(){
 void TrueOnlineSarsaLearner::sanityCheck(){
 	for(int i = 0; i < numActions; i++){
 		if(fabs(Q[i]) > 10e7 || Q[i] != Q[i] /*NaN*/){
-			printf("It seems your algorithm diverged!\n");
-			exit(0);
+			//The runs of a sweep do not print, their divergence is reported in the summary:
+			if(toPrintEpisodes){
+				printf("It seems your algorithm diverged!\n");
+			}
+			diverged = true;
+			return;
 		}
 	}
 }
@@ -147,7 +181,7 @@ void TrueOnlineSarsaLearner::loadWeights(){
 void TrueOnlineSarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 	
 	struct timeval tvBegin, tvEnd, tvDiff;
-	vector<double> reward;
+	vector<double> reward(2, 0.0);
 	double elapsedTime;
 	double norm_a;
 	double q_old, delta_q;
@@ -155,6 +189,25 @@ void TrueOnlineSarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 	unsigned int maxFeatVectorNorm = 1;
 	sawFirstReward = 0; firstReward = 1.0;
 
+	//If requested, the weights are evaluated in a separate thread while learning:
+	OnlineEvaluator *onlineEvaluator = NULL;
+	int onlineEvalFrequency = parameters->getOnlineEvalFrequency();
+	int nextOnlineEval = onlineEvalFrequency;
+	if(onlineEvalFrequency > 0){
+		onlineEvaluator = new OnlineEvaluator(parameters, features, actions, w, rng.split());
+	}
+	//If requested, the metrics of each episode are saved in a binary file:
+	EpisodeMetrics metrics;
+	MetricsLog *metricsLog = NULL;
+	if(!parameters->getEpisodeLogPath().empty()){
+		metricsLog = new MetricsLog(parameters->getEpisodeLogPath());
+	}
+
+	//If START_STATES is set, the first episode also starts from a cached state:
+	if(startStates != NULL){
+		resetGame(ale, startRng);
+	}
+
 	//Repeat (for each episode):
 	int episode, totalNumberFrames = 0;
 	//This is going to be interrupted by the ALE code since I set max_num_frames beforehand
@@ -172,6 +225,7 @@ void TrueOnlineSarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 				e[i][j] = 0.0;
 			}
 		}
+		metrics.clear();
 		F.clear();
 		features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), F);
 		updateQValues(F, Q);
@@ -183,11 +237,11 @@ void TrueOnlineSarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 		gettimeofday(&tvBegin, NULL);
 		//This also stops when the maximum number of steps per episode is reached
 		while(!ale.game_over()){
-			reward.clear();
-			reward.push_back(0.0);
-			reward.push_back(0.0);
 			updateQValues(F, Q);
 			sanityCheck();
+			if(diverged){
+				break;
+			}
 
 			//Take action, observe reward and next state:
 			act(ale, currentAction, reward);
@@ -195,7 +249,10 @@ void TrueOnlineSarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 			if(!ale.game_over()){
 				//Obtain active features in the new state:
 				Fnext.clear();
-				features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
+				{
+					PROFILE_SCOPE(PHASE_FEATURES);
+					features->getActiveFeaturesIndices(ale.getScreen(), ale.getRAM(), Fnext);
+				}
 				updateQValues(Fnext, Qnext);     //Update Q-values for the new active features
 				nextAction = epsilonGreedy(Qnext);
 			}
@@ -219,24 +276,54 @@ void TrueOnlineSarsaLearner::learnPolicy(ALEInterface& ale, Features *features){
 			updateTrace(currentAction, norm_a);
 			//theta <- theta + alpha * delta * e + alpha * delta_q (e - phi(S,A))
 			updateWeights(currentAction, norm_a, delta_q);
+			if(onlineEvaluator != NULL){
+				onlineEvaluator->markModified(nonZeroElig);
+				for(unsigned int i = 0; i < F.size(); i++){
+					onlineEvaluator->markModified(currentAction, F[i]);
+				}
+				if(totalNumberFrames + ale.getEpisodeFrameNumber() >= nextOnlineEval){
+					onlineEvaluator->publish(w, totalNumberFrames + ale.getEpisodeFrameNumber(), episode);
+					nextOnlineEval += onlineEvalFrequency;
+				}
+			}
 			//e <- gamma * lambda * e
 			decayTrace();
 
-			F = Fnext;
+			metrics.addStep(F.size(), nonZeroElig);
+			F.swap(Fnext);
 			currentAction = nextAction;
 		}
+		//The episode interrupted by the divergence is not reported:
+		if(diverged){
+			break;
+		}
 		gettimeofday(&tvEnd, NULL);
 		timeval_subtract(&tvDiff, &tvEnd, &tvBegin);
 		elapsedTime = double(tvDiff.tv_sec) + double(tvDiff.tv_usec)/1000000.0;
 		
 		double fps = double(ale.getEpisodeFrameNumber())/elapsedTime;
-		printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
-			episode + 1, cumReward - prevCumReward, (double)cumReward/(episode + 1.0),
-			ale.getEpisodeFrameNumber(), fps);
+		if(toPrintEpisodes){
+			printf("episode: %d,\t%.0f points,\tavg. return: %.1f,\t%d frames,\t%.0f fps\n",
+				episode + 1, cumReward - prevCumReward, (double)cumReward/(episode + 1.0),
+				ale.getEpisodeFrameNumber(), fps);
+		}
+		PROFILE_END_EPISODE(episode + 1);
 		totalNumberFrames += ale.getEpisodeFrameNumber();
+		if(metricsLog != NULL){
+			metrics.close(episode + 1, 0, ale.getEpisodeFrameNumber(), totalNumberFrames, maxFeatVectorNorm,
+				cumReward - prevCumReward, elapsedTime);
+			metricsLog->append(metrics);
+		}
 		prevCumReward = cumReward;
-		ale.reset_game();
+		resetGame(ale, startRng);
 	}
+	if(onlineEvaluator != NULL){
+		//The final weights are always evaluated, the destructor waits for it:
+		onlineEvaluator->publish(w, totalNumberFrames, episode);
+		delete onlineEvaluator;
+	}
+	delete metricsLog;
+	PROFILE_DUMP(parameters->getProfilePath());
 }
 
 void TrueOnlineSarsaLearner::evaluatePolicy(ALEInterface& ale, Features *features){
@@ -244,6 +331,25 @@ void TrueOnlineSarsaLearner::evaluatePolicy(ALEInterface& ale, Features *feature
 	double cumReward = 0; 
 	double prevCumReward = 0;
 
+	//The evaluation episodes are independent, so they are run in parallel when possible (the quantized
+	//weights are only evaluated by the PolicyEvaluator):
+	if(numThreads > 1 || quantizeBits > 0){
+		vector<double> returns, elapsedTimes;
+		vector<int> numFrames;
+		PolicyEvaluator evaluator(parameters, features, actions, epsilon, numThreads, rng.split());
+		if(quantizeBits > 0){
+			evaluateQuantized(evaluator, w, returns, numFrames, elapsedTimes);
+		}
+		else{
+			evaluator.evaluate(w, numEpisodesEval, returns, numFrames, elapsedTimes);
+		}
+		for(int episode = 0; episode < numEpisodesEval; episode++){
+			cumReward += returns[episode];
+			printf("%d, %f, %f \n", episode + 1, (double)cumReward/(episode + 1.0), returns[episode]);
+		}
+		return;
+	}
+
 	//Repeat (for each episode):
 	for(int episode = 0; episode < numEpisodesEval; episode++){
 		//Repeat(for each step of episode) until game is over:
@@ -259,6 +365,9 @@ void TrueOnlineSarsaLearner::evaluatePolicy(ALEInterface& ale, Features *feature
 		}
 		ale.reset_game();
 		sanityCheck();
+		if(diverged){
+			return;
+		}
 		
 		printf("%d, %f, %f \n", episode + 1, (double)cumReward/(episode + 1.0), cumReward-prevCumReward);
 		
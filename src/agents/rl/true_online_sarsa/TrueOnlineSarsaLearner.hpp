@@ -26,8 +26,8 @@ class TrueOnlineSarsaLearner : public RLLearner{
 		vector<int> Fnext;              //Set of features active in next state
 		vector<double> Q;               //Q(a) entries
 		vector<double> Qnext;           //Q(a) entries for next action
-		vector<vector<double> > e;      //Eligibility trace
-		vector<vector<double> > w;      //Theta, weights vector
+		vector<vector<trace_t> > e;       //Eligibility trace
+		vector<vector<weight_t> > w;      //Theta, weights vector
 		vector<vector<int> >nonZeroElig;//To optimize the implementation   
 
 		/**
@@ -37,7 +37,8 @@ class TrueOnlineSarsaLearner : public RLLearner{
 		TrueOnlineSarsaLearner();
 		/**
  		* This method evaluates whether the Q-values are sound. By unsound I mean huge Q-values (> 10e7)
- 		* or NaN values. If so, it finishes the execution informing the algorithm has diverged. 
+ 		* or NaN values. If so, it informs the algorithm has diverged and sets diverged, which stops the
+ 		* learning (see RLLearner::hasDiverged).
  		*/
 		void sanityCheck();
 		/**
@@ -0,0 +1,277 @@
+/****************************************************************************************
+** Benchmarks of the parts of the code in which the learners spend their time. It measures:
+**   - each Features subclass (Basic, BASS, BPRO, RAM), with and without the background,
+**     on a corpus of screens recorded by playing the game with a uniformly random policy;
+**   - the kernels of the learners (Q-values evaluation, replacing traces update and
+**     weights update), using the features of the corpus, so the sparsity is realistic;
+**   - the number of frames and steps per second of Sarsa, Q-learning and True Online Sarsa,
+**     learning for TOTAL_FRAMES_LEARN frames.
+** All random numbers come from the seed given in the command line, so two runs with the same
+** arguments measure exactly the same work. The results are printed as JSON to stdout and the
+** progress to stderr, e.g.: ./benchmark -s 1 -c ../conf/bench.cfg -r pong.bin > bench.json
+**
+** REMARKS: - The features with background are only measured when SUBTRACT_BACKGROUND = 1 in
+**            the configuration file, since otherwise no background is read.
+**          - The kernels are the same loops as in SarsaLearner, which are private methods. They
+**            store the weights and traces with the types of common/Precision.hpp.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../common/Parameters.hpp"
+#endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../common/Random.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "../environment/ALEFactory.hpp"
+#endif
+#ifndef BASIC_FEATURES_H
+#define BASIC_FEATURES_H
+#include "../features/BasicFeatures.hpp"
+#endif
+#ifndef BASS_FEATURES_H
+#define BASS_FEATURES_H
+#include "../features/BASSFeatures.hpp"
+#endif
+#ifndef BPRO_FEATURES_H
+#define BPRO_FEATURES_H
+#include "../features/BPROFeatures.hpp"
+#endif
+#ifndef RAM_FEATURES_H
+#define RAM_FEATURES_H
+#include "../features/RAMFeatures.hpp"
+#endif
+#ifndef SARSA_H
+#define SARSA_H
+#include "../agents/rl/sarsa/SarsaLearner.hpp"
+#endif
+#ifndef Q_H
+#define Q_H
+#include "../agents/rl/qlearning/QLearner.hpp"
+#endif
+#ifndef TRUE_ONLINE_SARSA_H
+#define TRUE_ONLINE_SARSA_H
+#include "../agents/rl/true_online_sarsa/TrueOnlineSarsaLearner.hpp"
+#endif
+#include <stdio.h>
+#include <chrono>
+
+#define CORPUS_SIZE         500   //Number of screens in the corpus
+#define NUM_REPETITIONS     3     //Each measure is repeated and the fastest repetition is reported
+#define NUM_KERNEL_PASSES   20    //Number of passes over the corpus when measuring the kernels
+
+using namespace std;
+
+static double now(){
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Plays the game with a uniformly random policy, saving every screen and RAM seen.
+ *
+ * @return int number of actions in the minimal action set
+ */
+int recordCorpus(Parameters *param, vector<ALEScreen> &screens, vector<ALERAM> &rams){
+	ALEInterface *ale = ALEFactory::createALE(param, param->getSeed());
+	ActionVect actions = ale->getMinimalActionSet();
+	Random rng(param->getSeed());
+	while((int) screens.size() < CORPUS_SIZE){
+		if(ale->game_over()){
+			ale->reset_game();
+		}
+		ale->act(actions[rng.nextInt(actions.size())]);
+		screens.push_back(ale->getScreen());
+		rams.push_back(ale->getRAM());
+	}
+	delete ale;
+	return actions.size();
+}
+
+/**
+ * Extracts the features of all screens of the corpus, reporting the time of the fastest
+ * repetition and the average number of active features.
+ */
+void benchmarkFeatures(const char *name, Features *features, bool background, vector<ALEScreen> &screens,
+	vector<ALERAM> &rams, bool isFirst){
+	vector<int> F;
+	double best = -1, numActive = 0;
+	for(int r = 0; r < NUM_REPETITIONS; r++){
+		numActive = 0;
+		double begin = now();
+		for(unsigned int i = 0; i < screens.size(); i++){
+			F.clear();
+			features->getActiveFeaturesIndices(screens[i], rams[i], F);
+			numActive += F.size();
+		}
+		double elapsed = now() - begin;
+		if(best < 0 || elapsed < best){
+			best = elapsed;
+		}
+	}
+	fprintf(stderr, "%s%s: %.1f us per screen\n", name, background ? " (background)" : "", 1e6 * best / screens.size());
+	printf("%s\n    {\"name\": \"%s\", \"background\": %s, \"screens\": %d, \"seconds\": %.6f, "
+		"\"us_per_screen\": %.3f, \"avg_active_features\": %.1f}", isFirst ? "" : ",", name,
+		background ? "true" : "false", (int) screens.size(), best, 1e6 * best / screens.size(),
+		numActive / screens.size());
+}
+
+/**
+ * Measures the kernels of SarsaLearner on the Basic features of the corpus: the actions are
+ * random and the temporal difference errors are small random numbers.
+ */
+void benchmarkKernels(Parameters *param, vector<ALEScreen> &screens, vector<ALERAM> &rams, int numActions){
+	BasicFeatures features(param);
+	int numFeatures = features.getNumberOfFeatures();
+	double gamma = param->getGamma(), lambda = param->getLambda(), alpha = param->getAlpha();
+	double traceThreshold = param->getTraceThreshold();
+
+	vector<vector<int> > corpusFeatures(screens.size());
+	for(unsigned int i = 0; i < screens.size(); i++){
+		features.getActiveFeaturesIndices(screens[i], rams[i], corpusFeatures[i]);
+	}
+
+	vector<vector<weight_t> > w(numActions, vector<weight_t>(numFeatures, 0.0));
+	vector<vector<trace_t> > e(numActions, vector<trace_t>(numFeatures, 0.0));
+	vector<vector<int> > nonZeroElig(numActions);
+	vector<double> Q(numActions, 0.0);
+	double timeQ = 0, timeTraces = 0, timeWeights = 0, traceSize = 0;
+	long calls = 0;
+	Random rng(param->getSeed());
+
+	for(int pass = 0; pass < NUM_KERNEL_PASSES; pass++){
+		for(unsigned int s = 0; s < corpusFeatures.size(); s++){
+			vector<int> &F = corpusFeatures[s];
+			int action = rng.nextInt(numActions);
+			double delta = 0.01 * (rng.nextDouble() - 0.5);
+
+			double begin = now();
+			//Q-values, as SarsaLearner::updateQValues:
+			for(int a = 0; a < numActions; a++){
+				double sumW = 0;
+				for(unsigned int i = 0; i < F.size(); i++){
+					sumW += w[a][F[i]];
+				}
+				Q[a] = sumW;
+			}
+			double endQ = now();
+			//Replacing traces, as SarsaLearner::updateReplTrace:
+			for(int a = 0; a < numActions; a++){
+				int numNonZero = 0;
+				for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
+					int idx = nonZeroElig[a][i];
+					e[a][idx] = gamma * lambda * e[a][idx];
+					if(e[a][idx] < traceThreshold){
+						e[a][idx] = 0;
+					}
+					else{
+						nonZeroElig[a][numNonZero] = idx;
+						numNonZero++;
+					}
+				}
+				nonZeroElig[a].resize(numNonZero);
+			}
+			for(unsigned int i = 0; i < F.size(); i++){
+				int idx = F[i];
+				if(e[action][idx] == 0){
+					nonZeroElig[action].push_back(idx);
+				}
+				e[action][idx] = 1;
+			}
+			double endTraces = now();
+			//Weights, as in SarsaLearner::learnPolicy:
+			for(int a = 0; a < numActions; a++){
+				for(unsigned int i = 0; i < nonZeroElig[a].size(); i++){
+					int idx = nonZeroElig[a][i];
+					w[a][idx] = w[a][idx] + (alpha/F.size()) * delta * e[a][idx];
+				}
+			}
+			double endWeights = now();
+
+			timeQ += endQ - begin;
+			timeTraces += endTraces - endQ;
+			timeWeights += endWeights - endTraces;
+			for(int a = 0; a < numActions; a++){
+				traceSize += nonZeroElig[a].size();
+			}
+			calls++;
+		}
+	}
+	fprintf(stderr, "kernels: %.0f ns (Q-values), %.0f ns (traces), %.0f ns (weights) per step\n",
+		1e9 * timeQ / calls, 1e9 * timeTraces / calls, 1e9 * timeWeights / calls);
+	printf("\n    {\"name\": \"q_values\", \"calls\": %ld, \"ns_per_call\": %.1f},", calls, 1e9 * timeQ / calls);
+	printf("\n    {\"name\": \"replacing_traces\", \"calls\": %ld, \"ns_per_call\": %.1f, \"avg_trace_size\": %.1f},",
+		calls, 1e9 * timeTraces / calls, traceSize / calls);
+	printf("\n    {\"name\": \"weights_update\", \"calls\": %ld, \"ns_per_call\": %.1f}", calls, 1e9 * timeWeights / calls);
+}
+
+/**
+ * Learns for the number of frames defined in the configuration file, with Basic features.
+ */
+template<class Learner>
+void benchmarkLearner(const char *name, Parameters *param, bool isFirst){
+	ALEInterface *ale = ALEFactory::createALE(param, param->getSeed());
+	BasicFeatures features(param);
+	Learner learner(*ale, &features, param);
+
+	int framesBefore = ale->getFrameNumber();
+	double begin = now();
+	learner.learnPolicy(*ale, &features);
+	double elapsed = now() - begin;
+	int frames = ale->getFrameNumber() - framesBefore;
+	double steps = double(frames) / param->getNumStepsPerAction();
+
+	fprintf(stderr, "%s: %.0f frames per second\n", name, frames / elapsed);
+	printf("%s\n    {\"name\": \"%s\", \"frames\": %d, \"seconds\": %.3f, \"frames_per_second\": %.1f, "
+		"\"steps_per_second\": %.1f}", isFirst ? "" : ",", name, frames, elapsed, frames / elapsed, steps / elapsed);
+	delete ale;
+}
+
+int main(int argc, char** argv){
+	Parameters param(argc, argv);
+	Parameters paramNoBackground = param;
+	paramNoBackground.setSubtractBackground(0);
+
+	vector<ALEScreen> screens;
+	vector<ALERAM> rams;
+	int numActions = recordCorpus(&param, screens, rams);
+
+	printf("{\n  \"rom\": \"%s\", \"seed\": %d, \"corpus_size\": %d, \"num_rows\": %d, \"num_columns\": %d, "
+		"\"num_colors\": %d, \"frames_learn\": %d, \"weight_bytes\": %d, \"trace_bytes\": %d,\n", param.getRomPath().c_str(),
+		param.getSeed(), CORPUS_SIZE, param.getNumRows(), param.getNumColumns(), param.getNumColors(), param.getLearningLength(),
+		(int) sizeof(weight_t), (int) sizeof(trace_t));
+
+	printf("  \"features\": [");
+	for(int withBackground = 0; withBackground <= param.getSubtractBackground(); withBackground++){
+		Parameters *p = withBackground ? &param : &paramNoBackground;
+		BasicFeatures basic(p);
+		BASSFeatures bass(p);
+		BPROFeatures bpro(p);
+		benchmarkFeatures("Basic", &basic, withBackground, screens, rams, withBackground == 0);
+		benchmarkFeatures("BASS", &bass, withBackground, screens, rams, false);
+		benchmarkFeatures("BPRO", &bpro, withBackground, screens, rams, false);
+	}
+	RAMFeatures ram;
+	benchmarkFeatures("RAM", &ram, false, screens, rams, false);
+	printf("\n  ],\n");
+
+	printf("  \"kernels\": [");
+	benchmarkKernels(&paramNoBackground, screens, rams, numActions);
+	printf("\n  ],\n");
+
+	printf("  \"learners\": [");
+	benchmarkLearner<SarsaLearner>("Sarsa", &param, true);
+	benchmarkLearner<QLearner>("QLearning", &param, false);
+	benchmarkLearner<TrueOnlineSarsaLearner>("TrueOnlineSarsa", &param, false);
+	printf("\n  ]\n}\n");
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+/****************************************************************************************
+** Buffered writer that moves the writing to the disk out of the caller's thread.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+#include "AsyncFileWriter.hpp"
+#endif
+
+AsyncFileWriter::AsyncFileWriter(const std::string &path, size_t bufferSize){
+	this->bufferSize = bufferSize;
+	filling = 0;
+	pending = -1;
+	toStop = false;
+	buffers[0].reserve(bufferSize);
+	buffers[1].reserve(bufferSize);
+
+	file = fopen(path.c_str(), "wb");
+	if(file == NULL){
+		printf("Unable to open the file '%s' to be written.\n", path.c_str());
+	}
+	else{
+		writer = std::thread(&AsyncFileWriter::writerLoop, this);
+	}
+}
+
+AsyncFileWriter::~AsyncFileWriter(){
+	if(file != NULL){
+		flush();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			toStop = true;
+		}
+		bufferReady.notify_one();
+		writer.join();
+		fclose(file);
+	}
+}
+
+bool AsyncFileWriter::isOpen(){
+	return file != NULL;
+}
+
+void AsyncFileWriter::writerLoop(){
+	std::unique_lock<std::mutex> lock(mutex);
+	while(true){
+		bufferReady.wait(lock, [this]{ return pending != -1 || toStop; });
+		if(pending == -1){
+			return;
+		}
+		//The buffer being written is not touched by the other threads, so the lock is released:
+		std::vector<char> &buffer = buffers[pending];
+		lock.unlock();
+		fwrite(&buffer[0], 1, buffer.size(), file);
+		fflush(file);
+		lock.lock();
+		buffer.clear();
+		pending = -1;
+		bufferWritten.notify_all();
+	}
+}
+
+void AsyncFileWriter::handOver(std::unique_lock<std::mutex> &lock){
+	bufferWritten.wait(lock, [this]{ return pending == -1; });
+	pending = filling;
+	filling = 1 - filling;
+	bufferReady.notify_one();
+}
+
+void AsyncFileWriter::write(const void *data, size_t size){
+	if(file == NULL){
+		return;
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	const char *bytes = (const char*) data;
+	buffers[filling].insert(buffers[filling].end(), bytes, bytes + size);
+	if(buffers[filling].size() >= bufferSize){
+		handOver(lock);
+	}
+}
+
+void AsyncFileWriter::flush(){
+	if(file == NULL){
+		return;
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	if(!buffers[filling].empty()){
+		handOver(lock);
+	}
+	bufferWritten.wait(lock, [this]{ return pending == -1; });
+}
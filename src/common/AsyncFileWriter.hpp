@@ -0,0 +1,77 @@
+/****************************************************************************************
+** Buffered writer that moves the writing to the disk out of the caller's thread. Data is
+** appended to one of two buffers in memory; when it is full it is handed to a background
+** thread that writes it while the other buffer is being filled. The caller only blocks if
+** it fills a buffer before the previous one has been written.
+**
+** REMARKS: - write() can be called by several threads, the order of the data written by
+**            different threads is the order in which they called it.
+**          - The data is only guaranteed to be in the file after flush() or the destructor.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class AsyncFileWriter{
+	private:
+		FILE *file;
+		size_t bufferSize;                  //Size after which a buffer is handed to the writer thread
+		std::vector<char> buffers[2];
+		int filling;                        //Buffer receiving the data
+		int pending;                        //Buffer being written, -1 if the writer thread is idle
+		bool toStop;
+
+		std::mutex mutex;
+		std::condition_variable bufferReady, bufferWritten;
+		std::thread writer;
+
+		/**
+ 		* Constructor declared as private to force the user to inform the file to be written.
+ 		*/
+		AsyncFileWriter();
+		/**
+ 		* Loop executed by the writer thread: it waits for a full buffer, writes it to the file
+ 		* and clears it, until the object is destroyed.
+ 		*/
+		void writerLoop();
+		/**
+ 		* Hands the buffer being filled to the writer thread, waiting for the previous one to be
+ 		* written, if necessary.
+ 		*
+ 		* @param std::unique_lock<std::mutex>& lock lock of the mutex, owned by the caller
+ 		*/
+		void handOver(std::unique_lock<std::mutex> &lock);
+	public:
+		/**
+ 		* Constructor. The file is truncated if it already exists.
+ 		*
+ 		* @param string path name of the file to be written
+ 		* @param size_t bufferSize size, in bytes, of each of the two buffers
+ 		*/
+		AsyncFileWriter(const std::string &path, size_t bufferSize = 1 << 20);
+		/**
+ 		* @return bool whether the file could be opened
+ 		*/
+		bool isOpen();
+		/**
+ 		* Appends data to the file, without waiting for it to be written.
+ 		*
+ 		* @param const void *data data to be written
+ 		* @param size_t size number of bytes to be written
+ 		*/
+		void write(const void *data, size_t size);
+		/**
+ 		* Blocks until all the data appended so far is written to the file.
+ 		*/
+		void flush();
+		/**
+ 		* Destructor, it writes whatever is still in memory and closes the file.
+ 		*/
+		~AsyncFileWriter();
+};
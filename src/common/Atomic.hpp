@@ -0,0 +1,39 @@
+/****************************************************************************************
+** Lock-free operations on doubles or floats stored in plain memory (e.g. a vector<double>),
+** used when several threads read and update the same weights without any locking, as in
+** Hogwild!. The weights can still be used as a regular vector by single-threaded code, for
+** example when saving them to a file or evaluating the learned policy.
+**
+** All operations use relaxed memory ordering: each read or write of a weight is atomic, so
+** no thread ever sees a torn value, but there is no ordering among different weights.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+/**
+* @param T *address memory position being read, it may be written by other threads
+*
+* @return T value stored in address
+*/
+template<typename T>
+inline T atomicLoad(const T *address){
+	T value;
+	__atomic_load(address, &value, __ATOMIC_RELAXED);
+	return value;
+}
+
+/**
+* Adds increment to the value stored in address. If another thread writes to the same
+* position in the meantime the operation is repeated, so no update is lost.
+*
+* @param T *address memory position being updated
+* @param double increment value to be added, the sum is computed in double
+*/
+template<typename T>
+inline void atomicAdd(T *address, double increment){
+	T expected, desired;
+	__atomic_load(address, &expected, __ATOMIC_RELAXED);
+	do{
+		desired = expected + increment;
+	}while(!__atomic_compare_exchange(address, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
@@ -13,7 +13,7 @@
 #include <assert.h>
 #include <cstdlib>
 
-int Mathematics::argmax(std::vector<double> array){
+int Mathematics::argmax(const std::vector<double> &array, Random &rng){
 	assert(array.size() > 0);
 	//Discover max value of the array:
 	double max = array[0];
@@ -22,15 +22,33 @@ int Mathematics::argmax(std::vector<double> array){
 			max = array[i];
 		}
 	}
-	//We need to break ties, thus we save all  
-	//indices that hold the same max value:
-	std::vector<int> indices;
+	//Count how many elements hold the max value and pick one of them:
+	int numTies = 0;
 	for(unsigned int i = 0; i < array.size(); i++){
 		if(fabs(array[i] - max) < 1e-10){
-			indices.push_back(i);
+			numTies++;
 		}
 	}
-	assert(indices.size() > 0);
-	//Now we randomly pick one of the best
-	return indices[rand()%indices.size()];
+	assert(numTies > 0);
+	int chosen = rng.nextInt(numTies);
+	for(unsigned int i = 0; i < array.size(); i++){
+		if(fabs(array[i] - max) < 1e-10){
+			if(chosen == 0){
+				return i;
+			}
+			chosen--;
+		}
+	}
+	return 0;
+}
+
+int Mathematics::argmax(const std::vector<double> &array){
+	assert(array.size() > 0);
+	int best = 0;
+	for(unsigned int i = 1; i < array.size(); i++){
+		if(array[i] > array[best] + 1e-10){
+			best = i;
+		}
+	}
+	return best;
 }
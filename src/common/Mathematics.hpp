@@ -6,21 +6,37 @@
 ** Author: Marlos C. Machado
 ***************************************************************************************/
 
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "Random.hpp"
+#endif
 #include <vector>
 #include <math.h>
 
 class Mathematics{
 	public:
 	   /**
- 		* Implementation of argmax function. It breaks ties randomly.
+ 		* Implementation of argmax function. It breaks ties randomly, using the generator
+ 		* passed as parameter, so it can be called by several threads, each one with its own
+ 		* generator.
  		*
  		* TODO: Right now it is implemented for vectors of doubles, it should
  		* be parametrized for any type. Definetely Templates should be used 
  		* here in the future.
  		*
  		* @param std::vector<double> array vector one wants the argmax
+ 		* @param Random &rng random number generator used to break ties
  		*
  		* @return indice of an element with highest value, ties are broke randomly.
  		*/
-		static int argmax(std::vector<double> array);
+		static int argmax(const std::vector<double> &array, Random &rng);
+	   /**
+ 		* Same as above, but ties are broken by the lowest index, so the same array always gives
+ 		* the same answer. Used to compare the greedy actions of two sets of Q-values.
+ 		*
+ 		* @param std::vector<double> array vector one wants the argmax
+ 		*
+ 		* @return indice of the first element with highest value
+ 		*/
+		static int argmax(const std::vector<double> &array);
 };
@@ -0,0 +1,46 @@
+/****************************************************************************************
+** Binary log with one record per learning episode, written in the background.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef METRICS_LOG_H
+#define METRICS_LOG_H
+#include "MetricsLog.hpp"
+#endif
+
+//A buffer holds 1024 records, as records are small and episodes are long this is enough:
+MetricsLog::MetricsLog(const std::string &path) : writer(path, 1024 * sizeof(EpisodeMetrics)){
+	MetricsLogHeader header;
+	memset(&header, 0, sizeof(MetricsLogHeader));
+	memcpy(header.magic, METRICS_LOG_MAGIC, 4);
+	header.version = METRICS_LOG_VERSION;
+	header.recordSize = sizeof(EpisodeMetrics);
+	writer.write(&header, sizeof(MetricsLogHeader));
+}
+
+void MetricsLog::append(const EpisodeMetrics &metrics){
+	writer.write(&metrics, sizeof(EpisodeMetrics));
+}
+
+bool MetricsLog::readAll(const std::string &path, std::vector<EpisodeMetrics> &records){
+	FILE *file = fopen(path.c_str(), "rb");
+	if(file == NULL){
+		return false;
+	}
+	MetricsLogHeader header;
+	if(fread(&header, sizeof(MetricsLogHeader), 1, file) != 1 || memcmp(header.magic, METRICS_LOG_MAGIC, 4) != 0
+		|| header.version != METRICS_LOG_VERSION || header.recordSize != sizeof(EpisodeMetrics)){
+		fclose(file);
+		return false;
+	}
+	EpisodeMetrics metrics;
+	//An incomplete record at the end (e.g. the learner was killed) is ignored:
+	while(fread(&metrics, sizeof(EpisodeMetrics), 1, file) == 1){
+		records.push_back(metrics);
+	}
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,134 @@
+/****************************************************************************************
+** Binary log with one record per learning episode, written in the background, so the
+** learners do not have to print (and the analysis scripts do not have to parse) a line of
+** text per episode. The file has a header followed by fixed-size records; the tool in
+** tools/metrics converts it to CSV.
+**
+** REMARKS: - The records are written in the byte order of the machine that ran the learner.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+#include "AsyncFileWriter.hpp"
+#endif
+#include <string.h>
+#include <stdint.h>
+
+#define METRICS_LOG_MAGIC   "ALEM"
+#define METRICS_LOG_VERSION 1
+
+/**
+ * Header at the beginning of the file, used to check whether a file can be read.
+ */
+struct MetricsLogHeader{
+	char magic[4];          //METRICS_LOG_MAGIC
+	uint32_t version;       //METRICS_LOG_VERSION
+	uint32_t recordSize;    //sizeof(EpisodeMetrics)
+	uint32_t reserved;
+};
+
+/**
+ * Everything that is recorded about a learning episode. During the episode the averages
+ * hold sums, they are divided by the number of steps when the episode is closed.
+ */
+struct EpisodeMetrics{
+	int32_t episode;            //Index of the episode, starting at 1
+	int32_t worker;             //Thread that played the episode, 0 if there is a single one
+	int32_t frames;             //Number of frames in the episode
+	int32_t totalFrames;        //Number of frames seen so far, including this episode
+	int32_t numSteps;           //Number of actions taken
+	int32_t maxFeatVectorNorm;  //Largest number of active features seen so far, used to normalize alpha
+	int32_t maxActiveFeatures;  //Largest number of active features in this episode
+	int32_t maxTraceSize;       //Largest number of non-zero traces in this episode
+	double episodeReturn;       //Sum of the (non-normalized) rewards
+	double seconds;             //Wall time spent in the episode
+	double avgActiveFeatures;   //Average number of active features per step
+	double avgTraceSize;        //Average number of non-zero traces per step
+
+	/**
+ 	* Resets all fields, to start a new episode.
+ 	*/
+	void clear(){
+		memset(this, 0, sizeof(EpisodeMetrics));
+	}
+	/**
+ 	* Accounts a step of the episode.
+ 	*
+ 	* @param int numActiveFeatures number of features active in the state the action was taken
+ 	* @param int traceSize number of non-zero traces after the update
+ 	*/
+	void addStep(int numActiveFeatures, int traceSize){
+		numSteps++;
+		avgActiveFeatures += numActiveFeatures;
+		avgTraceSize += traceSize;
+		if(numActiveFeatures > maxActiveFeatures){
+			maxActiveFeatures = numActiveFeatures;
+		}
+		if(traceSize > maxTraceSize){
+			maxTraceSize = traceSize;
+		}
+	}
+	/**
+ 	* Same as above, counting the non-zero traces of all actions.
+ 	*
+ 	* @param vector<vector<int> >& nonZeroElig indices of the non-zero traces of each action
+ 	*/
+	void addStep(int numActiveFeatures, const std::vector<std::vector<int> > &nonZeroElig){
+		int traceSize = 0;
+		for(unsigned int a = 0; a < nonZeroElig.size(); a++){
+			traceSize += nonZeroElig[a].size();
+		}
+		addStep(numActiveFeatures, traceSize);
+	}
+	/**
+ 	* Fills the fields only known at the end of the episode and computes the averages.
+ 	*/
+	void close(int episode, int worker, int frames, int totalFrames, int maxFeatVectorNorm,
+		double episodeReturn, double seconds){
+		this->episode = episode;
+		this->worker = worker;
+		this->frames = frames;
+		this->totalFrames = totalFrames;
+		this->maxFeatVectorNorm = maxFeatVectorNorm;
+		this->episodeReturn = episodeReturn;
+		this->seconds = seconds;
+		if(numSteps > 0){
+			avgActiveFeatures /= numSteps;
+			avgTraceSize /= numSteps;
+		}
+	}
+};
+
+class MetricsLog{
+	private:
+		AsyncFileWriter writer;
+
+		/**
+ 		* Constructor declared as private to force the user to inform the file to be written.
+ 		*/
+		MetricsLog();
+	public:
+		/**
+ 		* Constructor, it creates the file and writes its header.
+ 		*
+ 		* @param string path name of the file to be written
+ 		*/
+		MetricsLog(const std::string &path);
+		/**
+ 		* Appends the record of an episode to the file. It can be called by several threads.
+ 		*
+ 		* @param EpisodeMetrics& metrics record of the episode, already closed
+ 		*/
+		void append(const EpisodeMetrics &metrics);
+		/**
+ 		* Reads all the records of a file written by this class.
+ 		*
+ 		* @param string path name of the file to be read
+ 		* @param vector<EpisodeMetrics>& records vector that will receive the records
+ 		*
+ 		* @return bool false if the file could not be opened or was not written by this class
+ 		*/
+		static bool readAll(const std::string &path, std::vector<EpisodeMetrics> &records);
+};
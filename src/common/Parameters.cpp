@@ -36,6 +36,8 @@ void Parameters::printHelp(char** argv){
 	printf("   -t     %s[REQUIRED IF SAVE_TRAJECTORY = 1]%s path to file that will store the agent's trajectory.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
 	printf("   -w     If one wants to save intermediate weights, this is prefix to files that will store the agent's learned weights every FREQUENCY_SAVING episodes.\n");
 	printf("   -l     If one wants to load an stored set of weights, this should contain the path to such file.\n");
+	printf("   -m     %s[REQUIRED IF ONLINE_EVAL_FREQUENCY > 0]%s path to file that will store the results of the online evaluation.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -g     %s[REQUIRED BY THE SWEEP]%s path to file with the grid of parameters to be run.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
 	printf("   -h     Print this help and exit\n");
 	printf("\n");
 }
@@ -43,6 +45,11 @@ void Parameters::printHelp(char** argv){
 Parameters::Parameters(int argc, char** argv){
 
 	this->setSaveTrajectoryPath("");
+	this->setMetricsPath("");
+	this->setSweepPath("");
+	//These are only set when -w and -l are given:
+	this->setToSaveWeightsAfterLearning(0);
+	this->setToLoadWeights(0);
 
 	this->readParameters(argc, argv);
 	//Get the game being played by the path to ROM:
@@ -62,6 +69,11 @@ Parameters::Parameters(int argc, char** argv){
 		printHelp(argv);
 		exit(1);
 	}
+	//The same is true for the results of the online evaluation
+	if(this->onlineEvalFrequency > 0 && this->getMetricsPath().compare("") == 0){
+		printHelp(argv);
+		exit(1);
+	}
 }
 
 std::vector<std::string> Parameters::parseLine(std::string line){
@@ -91,7 +103,7 @@ std::vector<std::string> Parameters::parseLine(std::string line){
 
 void Parameters::readParameters(int argc, char* argv[]){
 	int option = 0;
-	while ((option = getopt(argc, argv, "c:r:s:t:w:l:h")) != -1)
+	while ((option = getopt(argc, argv, "c:r:s:t:w:l:m:g:h")) != -1)
 	{
 		if (option == -1){
 			break;
@@ -121,6 +133,12 @@ void Parameters::readParameters(int argc, char* argv[]){
 				this->setPathToWeightsFiles(optarg);
 				this->setToLoadWeights(1);
 				break;
+			case 'm':
+				this->setMetricsPath(optarg);
+				break;
+			case 'g':
+				this->setSweepPath(optarg);
+				break;
 			case ':':
          	case '?':
          		fprintf(stderr, "Try `%s -h' for more information.\n", argv[0]);
@@ -143,8 +161,9 @@ void Parameters::parseParametersFromConfigFile(std::string cfgFileName){
 	std::string line;
 	//Open config file passed as parameter
 	std::ifstream cfgFile(cfgFileName.c_str());
-	//Save parameters temporarily in a Map to ease its retrieval later
-	std::map<std::string,std::string> parameters;
+	//Save parameters in a Map to ease its retrieval later, it is kept to create variants of these parameters
+	std::map<std::string,std::string> &parameters = this->configValues;
+	parameters.clear();
 	if (cfgFile.is_open()){
 		//Read file line by line:
 		while( getline(cfgFile, line)){
@@ -161,6 +180,11 @@ void Parameters::parseParametersFromConfigFile(std::string cfgFileName){
 	else{
 		printf("Unable to open the file '%s', defined as the configuration file.\n", cfgFileName.c_str());
 	}
+	this->setParametersFromConfigValues();
+}
+
+void Parameters::setParametersFromConfigValues(){
+	std::map<std::string,std::string> &parameters = this->configValues;
 
 	this->setAlpha(atof(parameters["ALPHA"].c_str()));
 	this->setGamma(atof(parameters["GAMMA"].c_str()));
@@ -183,6 +207,35 @@ void Parameters::parseParametersFromConfigFile(std::string cfgFileName){
 
 	this->setFrequencySavingWeights(atoi(parameters["FREQUENCY_SAVING"].c_str()));
 	this->setLearningLength(atoi(parameters["TOTAL_FRAMES_LEARN"].c_str()));
+	//Older configuration files do not have this parameter, in this case a single thread is used:
+	this->setNumThreads(parameters.count("NUM_THREADS") ? atoi(parameters["NUM_THREADS"].c_str()) : 1);
+	this->setUseProcesses(atoi(parameters["USE_PROCESSES"].c_str()));
+	//The same is true for the online evaluation, which is disabled by default:
+	this->setOnlineEvalFrequency(atoi(parameters["ONLINE_EVAL_FREQUENCY"].c_str()));
+	this->setOnlineEvalEpisodes(parameters.count("ONLINE_EVAL_EPISODES") ? atoi(parameters["ONLINE_EVAL_EPISODES"].c_str()) : 1);
+	this->setOnlineEvalEpsilon(atof(parameters["ONLINE_EVAL_EPSILON"].c_str()));
+	this->setProfilePath(parameters["PROFILE_FILE"]);
+	this->setEpisodeLogPath(parameters["EPISODE_LOG_FILE"]);
+	//Older configuration files do not have this parameter, in this case the episodes are printed:
+	this->setToPrintEpisodes(parameters.count("PRINT_EPISODES") ? atoi(parameters["PRINT_EPISODES"].c_str()) : 1);
+	this->setCorpusPath(parameters["CORPUS_FILE"]);
+	//Experience replay is disabled by default, older configuration files do not have it:
+	this->setReplayCapacity(atoi(parameters["REPLAY_CAPACITY"].c_str()));
+	this->setReplayUpdates(parameters.count("REPLAY_UPDATES") ? atoi(parameters["REPLAY_UPDATES"].c_str()) : 1);
+	this->setReplayExponent(atof(parameters["REPLAY_PRIORITY_EXPONENT"].c_str()));
+	//Episodes start after a reset of the game by default, older configuration files do not have the cache:
+	this->setNumStartStates(atoi(parameters["START_STATES"].c_str()));
+	this->setNumStartNoops(parameters.count("START_NOOPS") ? atoi(parameters["START_NOOPS"].c_str()) : 30);
+	this->setStartStatesPath(parameters["START_STATES_FILE"]);
+	//The weights are not quantized by default, older configuration files do not have it:
+	this->setQuantizeBits(atoi(parameters["QUANTIZE_BITS"].c_str()));
+	this->setQuantizePerBlock(parameters.count("QUANTIZE_PER_BLOCK") ? atoi(parameters["QUANTIZE_PER_BLOCK"].c_str()) : 1);
+	//The Q-values are computed from scratch by default, older configuration files do not have it:
+	this->setIncrementalQRefresh(atoi(parameters["INCREMENTAL_Q_REFRESH"].c_str()));
+	//The synthetic environment is only used when compiled with SYNTHETIC=1, most files do not define it:
+	this->setSyntheticFps(atoi(parameters["SYNTHETIC_FPS"].c_str()));
+	this->setSyntheticReward(parameters.count("SYNTHETIC_REWARD") ? atoi(parameters["SYNTHETIC_REWARD"].c_str()) : 10);
+	this->setSyntheticSpritePeriod(parameters.count("SYNTHETIC_SPRITE_PERIOD") ? atoi(parameters["SYNTHETIC_SPRITE_PERIOD"].c_str()) : 1);
 
 	if(this->getSubtractBackground()){
 		std::string folderWithBackgrounds = parameters["PATH_TO_BACKGROUND"];
@@ -190,6 +243,23 @@ void Parameters::parseParametersFromConfigFile(std::string cfgFileName){
 	}
 }
 
+Parameters Parameters::withValues(const std::map<std::string, std::string> &values){
+	Parameters variant = *this;
+	for(std::map<std::string, std::string>::const_iterator it = values.begin(); it != values.end(); it++){
+		if(it->first == "SEED"){
+			variant.setSeed(it->second);
+		}
+		else if(it->first == "WEIGHTS_FILE"){
+			variant.setFileWithWeights(it->second);
+		}
+		else{
+			variant.configValues[it->first] = it->second;
+		}
+	}
+	variant.setParametersFromConfigValues();
+	return variant;
+}
+
 void Parameters::setSaveTrajectoryPath(std::string name){
 	this->trajectPath = name;
 }
@@ -420,4 +490,188 @@ int Parameters::getLearningLength(){
 
 void Parameters::setLearningLength(int a){
 	this->learningLength = a;
-}
\ No newline at end of file
+}
+
+int Parameters::getNumThreads(){
+	return this->numThreads;
+}
+
+void Parameters::setNumThreads(int a){
+	this->numThreads = a > 0 ? a : 1;
+}
+
+int Parameters::getUseProcesses(){
+	return this->useProcesses;
+}
+
+void Parameters::setUseProcesses(int a){
+	this->useProcesses = a;
+}
+
+std::string Parameters::getMetricsPath(){
+	return this->metricsPath;
+}
+
+void Parameters::setMetricsPath(std::string name){
+	this->metricsPath = name;
+}
+
+std::string Parameters::getSweepPath(){
+	return this->sweepPath;
+}
+
+void Parameters::setSweepPath(std::string name){
+	this->sweepPath = name;
+}
+
+int Parameters::getOnlineEvalFrequency(){
+	return this->onlineEvalFrequency;
+}
+
+void Parameters::setOnlineEvalFrequency(int a){
+	this->onlineEvalFrequency = a;
+}
+
+int Parameters::getOnlineEvalEpisodes(){
+	return this->onlineEvalEpisodes;
+}
+
+void Parameters::setOnlineEvalEpisodes(int a){
+	this->onlineEvalEpisodes = a > 0 ? a : 1;
+}
+
+double Parameters::getOnlineEvalEpsilon(){
+	return this->onlineEvalEpsilon;
+}
+
+void Parameters::setOnlineEvalEpsilon(double a){
+	this->onlineEvalEpsilon = a;
+}
+
+std::string Parameters::getProfilePath(){
+	return this->profilePath;
+}
+
+void Parameters::setProfilePath(std::string name){
+	this->profilePath = name;
+}
+
+std::string Parameters::getEpisodeLogPath(){
+	return this->episodeLogPath;
+}
+
+void Parameters::setEpisodeLogPath(std::string name){
+	this->episodeLogPath = name;
+}
+
+int Parameters::getToPrintEpisodes(){
+	return this->toPrintEpisodes;
+}
+
+void Parameters::setToPrintEpisodes(int a){
+	this->toPrintEpisodes = a;
+}
+
+std::string Parameters::getCorpusPath(){
+	return this->corpusPath;
+}
+
+void Parameters::setCorpusPath(std::string name){
+	this->corpusPath = name;
+}
+
+int Parameters::getReplayCapacity(){
+	return this->replayCapacity;
+}
+
+void Parameters::setReplayCapacity(int a){
+	this->replayCapacity = a;
+}
+
+int Parameters::getReplayUpdates(){
+	return this->replayUpdates;
+}
+
+void Parameters::setReplayUpdates(int a){
+	this->replayUpdates = a;
+}
+
+double Parameters::getReplayExponent(){
+	return this->replayExponent;
+}
+
+void Parameters::setReplayExponent(double a){
+	this->replayExponent = a;
+}
+
+int Parameters::getNumStartStates(){
+	return this->numStartStates;
+}
+
+void Parameters::setNumStartStates(int a){
+	this->numStartStates = a;
+}
+
+int Parameters::getNumStartNoops(){
+	return this->numStartNoops;
+}
+
+void Parameters::setNumStartNoops(int a){
+	this->numStartNoops = a;
+}
+
+std::string Parameters::getStartStatesPath(){
+	return this->startStatesPath;
+}
+
+void Parameters::setStartStatesPath(std::string name){
+	this->startStatesPath = name;
+}
+
+int Parameters::getQuantizeBits(){
+	return this->quantizeBits;
+}
+
+void Parameters::setQuantizeBits(int a){
+	this->quantizeBits = a;
+}
+
+int Parameters::getQuantizePerBlock(){
+	return this->quantizePerBlock;
+}
+
+void Parameters::setQuantizePerBlock(int a){
+	this->quantizePerBlock = a;
+}
+
+int Parameters::getIncrementalQRefresh(){
+	return this->incrementalQRefresh;
+}
+
+void Parameters::setIncrementalQRefresh(int a){
+	this->incrementalQRefresh = a;
+}
+
+int Parameters::getSyntheticFps(){
+	return this->syntheticFps;
+}
+
+void Parameters::setSyntheticFps(int a){
+	this->syntheticFps = a;
+}
+
+int Parameters::getSyntheticReward(){
+	return this->syntheticReward;
+}
+
+void Parameters::setSyntheticReward(int a){
+	this->syntheticReward = a;
+}
+
+int Parameters::getSyntheticSpritePeriod(){
+	return this->syntheticSpritePeriod;
+}
+
+void Parameters::setSyntheticSpritePeriod(int a){
+	this->syntheticSpritePeriod = a;
+}
@@ -14,6 +14,7 @@
 #include <getopt.h>
 #include <string>
 #include <vector>
+#include <map>
 
 class Parameters{
 	private:
@@ -25,6 +26,9 @@ class Parameters{
 		std::string modelPath;          //path to the file containing the model learned by the logistic regression
 		std::string fileWithWeights;    //path to the file that we will write the weights after we are done learning
 		std::string pathToWeightsFiles; //path to the file that we will load the weights from
+		std::string metricsPath;        //path to the file that will store the results of the online evaluation
+		std::string sweepPath;          //path to the file with the grid of parameters of a sweep
+		std::map<std::string, std::string> configValues; //values read from the config file, kept to create variants
 		double alpha;                   //learning rate
 		double gamma;                   //discount factor
 		double epsilon;                 //exploration probability
@@ -48,6 +52,27 @@ class Parameters{
 		int frequencySavingWeights;     //If we are asked to save the weights, We need to know how many frames to wait until saving them again
 		int toLoadWeights;              //whether we are going to load an already learned set of weights or not
 		int learningLength;             //The number of frames to be learned, in total. DQN uses, for example, 50,000,000.
+		int numThreads;                 //number of threads to be used by the parts of the code that can run in parallel
+		int useProcesses;               //whether the parallel learners run their workers in processes instead of threads
+		int onlineEvalFrequency;        //number of frames between two snapshots evaluated while learning, 0 disables it
+		int onlineEvalEpisodes;         //number of episodes used to evaluate each snapshot
+		double onlineEvalEpsilon;       //exploration probability used when evaluating each snapshot
+		std::string profilePath;        //path to the file that will store the time spent in each phase of the learners
+		std::string episodeLogPath;     //path to the binary file that will store the metrics of each learning episode
+		int toPrintEpisodes;            //whether a line is printed at the end of each learning episode
+		std::string corpusPath;         //path to the file that will store the screens and RAMs seen while learning
+		int replayCapacity;             //number of transitions kept for experience replay, 0 disables it
+		int replayUpdates;              //number of replayed transitions after each step
+		double replayExponent;          //exponent of the priorities used to sample transitions, 0 for uniform sampling
+		int numStartStates;             //number of cached states the learning episodes start from, 0 disables it
+		int numStartNoops;              //maximum number of no-ops taken before a cached start state
+		std::string startStatesPath;    //path to the file that stores the cached start states of the ROM
+		int quantizeBits;               //size of the integers the weights are quantized to when evaluated, 0 disables it
+		int quantizePerBlock;           //whether each block of quantized weights has its own scale
+		int incrementalQRefresh;        //number of steps between two full computations of the incremental Q-values, 0 disables them
+		int syntheticFps;               //frame rate of the synthetic environment, 0 means as fast as possible
+		int syntheticReward;            //reward of each coin collected in the synthetic environment
+		int syntheticSpritePeriod;      //number of frames between two movements of the sprites of the synthetic environment
 
 	   /**
  		* Constructor defined as private to force the use of the constructor 
@@ -80,6 +105,11 @@ class Parameters{
  		*/
 		void parseParametersFromConfigFile(std::string cfgFileName);
 		/**
+ 		* Sets all parameters that come from the configuration file from the values stored in
+ 		* configValues, as if they had just been read from the file.
+ 		*/
+		void setParametersFromConfigValues();
+		/**
  		* Parse a line from the configuration file returning the pair <ID, Value>.
  		*
  		* @param std::string line the line to be parsed
@@ -185,10 +215,6 @@ class Parameters{
  		*/
 		void setUseRewardSign(int a);
 		/**
- 		* @param double value that represents SUBTRACT_BACKGROUND in the config file.
- 		*/
-		void setSubtractBackground(int a);
-		/**
  		* @param int value that represents SAVE_TRAJECTORY in the config file.
  		*/		
 		void setToSaveTrajectory(int a);
@@ -212,6 +238,98 @@ class Parameters{
 		* @param learningLength number of frames to be learned in total, e.g. 50,000,000 (DQN).
 		*/
 		void setLearningLength(int a);
+		/**
+		* @param int value that represents NUM_THREADS in the config file.
+		*/
+		void setNumThreads(int a);
+		/**
+		* @param int value that represents USE_PROCESSES in the config file.
+		*/
+		void setUseProcesses(int a);
+		/**
+		* @param std::string path to the file that will store the results of the online evaluation
+		*/
+		void setMetricsPath(std::string name);
+		/**
+		* @param std::string path to the file with the grid of parameters of a sweep
+		*/
+		void setSweepPath(std::string name);
+		/**
+		* @param int value that represents ONLINE_EVAL_FREQUENCY in the config file.
+		*/
+		void setOnlineEvalFrequency(int a);
+		/**
+		* @param int value that represents ONLINE_EVAL_EPISODES in the config file.
+		*/
+		void setOnlineEvalEpisodes(int a);
+		/**
+		* @param double value that represents ONLINE_EVAL_EPSILON in the config file.
+		*/
+		void setOnlineEvalEpsilon(double a);
+		/**
+		* @param std::string value that represents PROFILE_FILE in the config file.
+		*/
+		void setProfilePath(std::string name);
+		/**
+		* @param std::string value that represents EPISODE_LOG_FILE in the config file.
+		*/
+		void setEpisodeLogPath(std::string name);
+		/**
+		* @param int value that represents PRINT_EPISODES in the config file.
+		*/
+		void setToPrintEpisodes(int a);
+		/**
+		* @param std::string value that represents CORPUS_FILE in the config file.
+		*/
+		void setCorpusPath(std::string name);
+		/**
+		* @param int value that represents REPLAY_CAPACITY in the config file.
+		*/
+		void setReplayCapacity(int a);
+		/**
+		* @param int value that represents REPLAY_UPDATES in the config file.
+		*/
+		void setReplayUpdates(int a);
+		/**
+		* @param double value that represents REPLAY_PRIORITY_EXPONENT in the config file.
+		*/
+		void setReplayExponent(double a);
+		/**
+		* @param int value that represents START_STATES in the config file.
+		*/
+		void setNumStartStates(int a);
+		/**
+		* @param int value that represents START_NOOPS in the config file.
+		*/
+		void setNumStartNoops(int a);
+		/**
+		* @param string value that represents START_STATES_FILE in the config file.
+		*/
+		void setStartStatesPath(std::string name);
+		/**
+		* @param int value that represents QUANTIZE_BITS in the config file.
+		*/
+		void setQuantizeBits(int a);
+		/**
+		* @param int value that represents QUANTIZE_PER_BLOCK in the config file.
+		*/
+		void setQuantizePerBlock(int a);
+		/**
+		* @param int value that represents INCREMENTAL_Q_REFRESH in the config file.
+		*/
+		void setIncrementalQRefresh(int a);
+		/**
+		* @param int value that represents SYNTHETIC_FPS in the config file.
+		*/
+		void setSyntheticFps(int a);
+		/**
+		* @param int value that represents SYNTHETIC_REWARD in the config file.
+		*/
+		void setSyntheticReward(int a);
+		/**
+		* @param int value that represents SYNTHETIC_SPRITE_PERIOD in the config file.
+		*/
+		void setSyntheticSpritePeriod(int a);
 		
 	public:
 		/**
@@ -222,6 +340,24 @@ class Parameters{
  		*/
 		Parameters(int argc, char** argv);
 		/**
+ 		* Creates a copy of these parameters in which some values of the configuration file are
+ 		* replaced, as if they had been written in it. The file is not read again. The keys SEED
+ 		* and WEIGHTS_FILE replace the seed and the file of weights informed in the command line.
+ 		* It is used to run sweeps over a grid of parameters in a single process (see
+ 		* sweep/SweepScheduler.hpp).
+ 		*
+ 		* @param std::map<std::string, std::string>& values new value of each key, as in the config file
+ 		*
+ 		* @return Parameters parameters with the new values
+ 		*/
+		Parameters withValues(const std::map<std::string, std::string> &values);
+		/**
+ 		* @param double value that represents SUBTRACT_BACKGROUND in the config file. It is public so
+ 		*        a copy of the parameters can be used without background subtraction (e.g. in the
+ 		*        benchmarks), as the background file is only read when it is set in the config file.
+ 		*/
+		void setSubtractBackground(int a);
+		/**
  		* @return std::string path the file with background information
  		*/
 		std::string getPathToBackground();
@@ -344,4 +480,109 @@ class Parameters{
 		* @return int learningLength number of frames to be learned in total, e.g. 50,000,000 (DQN).
 		*/
 		int getLearningLength();
+		/**
+		* @return int number of threads to be used, e.g., when evaluating a policy. It is at least 1.
+		*/
+		int getNumThreads();
+		/**
+		* @return int 1 if the workers of the parallel learners (e.g. Hogwild Sarsa) are processes
+		*   created with fork, sharing the weights through shared memory, instead of threads.
+		*/
+		int getUseProcesses();
+		/**
+		* @return string path to the file that will store the results of the online evaluation
+		*/
+		std::string getMetricsPath();
+		/**
+		* @return string path to the file with the grid of parameters of a sweep, empty if none was informed
+		*/
+		std::string getSweepPath();
+		/**
+		* @return int number of frames between two snapshots of the weights evaluated while learning.
+		*   If 0 there is no online evaluation.
+		*/
+		int getOnlineEvalFrequency();
+		/**
+		* @return int number of episodes used to evaluate each snapshot of the weights
+		*/
+		int getOnlineEvalEpisodes();
+		/**
+		* @return double exploration probability used when evaluating each snapshot of the weights
+		*/
+		double getOnlineEvalEpsilon();
+		/**
+		* @return string path to the file that will store the time spent in each phase of the learners,
+		*   only used when the code is compiled with PROFILE=1. If empty nothing is stored.
+		*/
+		std::string getProfilePath();
+		/**
+		* @return string path to the binary file that will store the metrics of each learning episode
+		*   (see common/MetricsLog.hpp). If empty nothing is stored.
+		*/
+		std::string getEpisodeLogPath();
+		/**
+		* @return int 1 if a line must be printed at the end of each learning episode, 0 otherwise.
+		*/
+		int getToPrintEpisodes();
+		/**
+		* @return string path to the file that will store the screens and RAMs seen while learning
+		*   (see environment/FrameCorpus.hpp). If empty nothing is stored.
+		*/
+		std::string getCorpusPath();
+		/**
+		* @return int number of transitions kept for experience replay (see agents/rl/ReplayBuffer.hpp).
+		*   If 0 the learners are purely online.
+		*/
+		int getReplayCapacity();
+		/**
+		* @return int number of transitions replayed after each step of the learner.
+		*/
+		int getReplayUpdates();
+		/**
+		* @return double exponent of the priorities used to sample transitions, 0 for uniform sampling.
+		*/
+		double getReplayExponent();
+		/**
+		* @return int number of cached states the learning episodes start from (see
+		*   environment/StartStateCache.hpp). If 0 the episodes start after a reset of the game.
+		*/
+		int getNumStartStates();
+		/**
+		* @return int maximum number of no-ops taken after a reset to obtain a cached start state.
+		*/
+		int getNumStartNoops();
+		/**
+		* @return string path to the file the cached start states are loaded from or saved in,
+		*   empty if they are not saved.
+		*/
+		std::string getStartStatesPath();
+		/**
+		* @return int 8 or 16 if the policy is evaluated with the weights quantized to integers of
+		*   this size (see agents/rl/QuantizedWeights.hpp), 0 if the weights are used as they are.
+		*/
+		int getQuantizeBits();
+		/**
+		* @return int 1 if each block of quantized weights has its own scale, 0 if the scale of the
+		*   action is used by all of them.
+		*/
+		int getQuantizePerBlock();
+		/**
+		* @return int number of new active sets between two computations from scratch of the Q-values
+		*   kept incrementally by the learners (see agents/rl/IncrementalQValues.hpp), 0 if the
+		*   Q-values are computed from scratch at every step.
+		*/
+		int getIncrementalQRefresh();
+		/**
+		* @return int frame rate the synthetic environment is throttled to, 0 if it is not throttled.
+		*   Only used when the code is compiled with SYNTHETIC=1 (see environment/synthetic).
+		*/
+		int getSyntheticFps();
+		/**
+		* @return int reward of each coin collected in the synthetic environment.
+		*/
+		int getSyntheticReward();
+		/**
+		* @return int number of frames between two movements of the sprites of the synthetic environment.
+		*/
+		int getSyntheticSpritePeriod();
 };
@@ -0,0 +1,30 @@
+/****************************************************************************************
+** Types used to store the weights and the eligibility traces of the linear learners. By
+** default both are doubles; they can be made smaller at compile time (see the Makefile):
+**   - __FLOAT_WEIGHTS: the weights are stored as float;
+**   - __FLOAT_TRACES: the traces are stored as float;
+**   - __HALF_TRACES: the traces are stored as _Float16 (GCC >= 12 or clang), which is enough
+**     for values in [traceThreshold, 1/(1-gamma*lambda)].
+**
+** Only the storage changes: the Q-values are accumulated in double and each update of a
+** weight or trace is computed in double and then rounded to the type in which it is stored.
+** Halving the size of the weights halves the memory and the cache misses when there are
+** millions of features (e.g. B-PRO), at the cost of losing updates smaller than the float
+** resolution of the weight (about 1e-7 of its magnitude).
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifdef __FLOAT_WEIGHTS
+typedef float weight_t;
+#else
+typedef double weight_t;
+#endif
+
+#if defined(__HALF_TRACES)
+typedef _Float16 trace_t;
+#elif defined(__FLOAT_TRACES)
+typedef float trace_t;
+#else
+typedef double trace_t;
+#endif
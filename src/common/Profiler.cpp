@@ -0,0 +1,115 @@
+/****************************************************************************************
+** Low-overhead scoped timers used to find out where the learners spend their time.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+#include "Profiler.hpp"
+#endif
+#include <stdio.h>
+#include <string.h>
+
+std::mutex Profiler::registryMutex;
+std::vector<Profiler::ThreadProfile*> Profiler::registry;
+thread_local Profiler::ThreadProfile* Profiler::threadProfile = NULL;
+
+static const char* phaseNames[NUM_PROFILE_PHASES] = {"emulation", "features", "q_values", "traces", "weights", "replay"};
+
+const char* Profiler::getPhaseName(int phase){
+	return phaseNames[phase];
+}
+
+void Profiler::clear(EpisodeProfile &profile, int thread){
+	memset(&profile, 0, sizeof(EpisodeProfile));
+	profile.thread = thread;
+}
+
+Profiler::ThreadProfile* Profiler::getThreadProfile(){
+	if(threadProfile == NULL){
+		ThreadProfile *profile = new ThreadProfile();
+		std::lock_guard<std::mutex> lock(registryMutex);
+		clear(profile->current, registry.size());
+		registry.push_back(profile);
+		threadProfile = profile;
+	}
+	return threadProfile;
+}
+
+void Profiler::add(int phase, uint64_t ns){
+	EpisodeProfile &current = getThreadProfile()->current;
+	int bucket = ns > 0 ? 63 - __builtin_clzll(ns) : 0;
+	if(bucket >= NUM_PROFILE_BUCKETS){
+		bucket = NUM_PROFILE_BUCKETS - 1;
+	}
+	current.numCalls[phase]++;
+	current.totalNs[phase] += ns;
+	current.histogram[phase][bucket]++;
+}
+
+void Profiler::endEpisode(int episode){
+	ThreadProfile *profile = getThreadProfile();
+	profile->current.episode = episode;
+	profile->episodes.push_back(profile->current);
+	clear(profile->current, profile->current.thread);
+}
+
+void Profiler::dump(const std::string &path){
+	if(path.empty()){
+		return;
+	}
+	FILE *file = fopen(path.c_str(), "w");
+	if(file == NULL){
+		printf("Unable to open file to write the profile.\n");
+		return;
+	}
+	bool toJSON = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	if(toJSON){
+		fprintf(file, "[");
+	}
+	else{
+		fprintf(file, "thread,episode,phase,calls,total_ns");
+		for(int b = 0; b < NUM_PROFILE_BUCKETS; b++){
+			fprintf(file, ",bucket_%d", b);
+		}
+		fprintf(file, "\n");
+	}
+	bool first = true;
+	for(unsigned int t = 0; t < registry.size(); t++){
+		ThreadProfile *profile = registry[t];
+		for(unsigned int e = 0; e < profile->episodes.size(); e++){
+			EpisodeProfile &episode = profile->episodes[e];
+			if(toJSON){
+				fprintf(file, "%s\n  {\"thread\": %d, \"episode\": %d, \"phases\": {", first ? "" : ",",
+					episode.thread, episode.episode);
+			}
+			for(int p = 0; p < NUM_PROFILE_PHASES; p++){
+				if(toJSON){
+					fprintf(file, "%s\"%s\": {\"calls\": %llu, \"total_ns\": %llu, \"histogram\": [", p ? ", " : "",
+						phaseNames[p], (unsigned long long) episode.numCalls[p], (unsigned long long) episode.totalNs[p]);
+				}
+				else{
+					fprintf(file, "%d,%d,%s,%llu,%llu", episode.thread, episode.episode, phaseNames[p],
+						(unsigned long long) episode.numCalls[p], (unsigned long long) episode.totalNs[p]);
+				}
+				for(int b = 0; b < NUM_PROFILE_BUCKETS; b++){
+					fprintf(file, toJSON && b == 0 ? "%u" : ",%u", episode.histogram[p][b]);
+				}
+				fprintf(file, toJSON ? "]}" : "\n");
+			}
+			if(toJSON){
+				fprintf(file, "}}");
+			}
+			first = false;
+		}
+	}
+	if(toJSON){
+		fprintf(file, "\n]\n");
+	}
+	fclose(file);
+}
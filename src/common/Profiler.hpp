@@ -0,0 +1,131 @@
+/****************************************************************************************
+** Low-overhead scoped timers used to find out where the learners spend their time. Each
+** step is divided in phases (emulation, feature extraction, Q-values evaluation, trace
+** update and weights update) and the time spent in each phase is accumulated by thread,
+** without any locking, in a histogram of durations that is closed at the end of every
+** episode. The histograms of all threads can then be written as CSV or JSON.
+**
+** The timers are only compiled when __PROFILE is defined (make PROFILE=1), otherwise the
+** macros below are empty and the learners run exactly as before.
+**
+** REMARKS: - The time is measured with std::chrono::steady_clock, which is monotonic and,
+**            in Linux, read without a system call.
+**          - The histogram has one bucket per power of two of nanoseconds: a phase that
+**            took t ns is counted in the bucket floor(log2(t)).
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+
+#define NUM_PROFILE_BUCKETS 32
+
+enum ProfilePhase{
+	PHASE_EMULATION = 0,    //ale.act, including the frame skip
+	PHASE_FEATURES,         //extraction of the active features
+	PHASE_Q_VALUES,         //evaluation of Q(s, a) for all actions
+	PHASE_TRACES,           //update (and decay) of the eligibility traces
+	PHASE_WEIGHTS,          //update of the weights
+	PHASE_REPLAY,           //updates made with transitions sampled from the replay buffer
+	NUM_PROFILE_PHASES
+};
+
+class Profiler{
+	private:
+		/**
+ 		* Time spent in each phase during a single episode of a single thread.
+ 		*/
+		struct EpisodeProfile{
+			int thread;
+			int episode;
+			uint64_t numCalls[NUM_PROFILE_PHASES];
+			uint64_t totalNs[NUM_PROFILE_PHASES];
+			uint32_t histogram[NUM_PROFILE_PHASES][NUM_PROFILE_BUCKETS];
+		};
+		/**
+ 		* Accumulators owned by a single thread, so they are updated without locking.
+ 		*/
+		struct ThreadProfile{
+			EpisodeProfile current;
+			std::vector<EpisodeProfile> episodes;
+		};
+
+		static std::mutex registryMutex;
+		static std::vector<ThreadProfile*> registry;        //Accumulators of all threads, in order of creation
+		static thread_local ThreadProfile *threadProfile;   //Accumulators of the calling thread
+
+		/**
+ 		* Constructor declared as private to force the user to use the static methods.
+ 		*/
+		Profiler();
+		/**
+ 		* @return ThreadProfile* accumulators of the calling thread, created (and registered,
+ 		*         to be dumped later) the first time a thread calls it.
+ 		*/
+		static ThreadProfile* getThreadProfile();
+		/**
+ 		* Resets the counters of the episode currently being profiled.
+ 		*/
+		static void clear(EpisodeProfile &profile, int thread);
+	public:
+		/**
+ 		* Adds the time spent in one execution of a phase to the current episode of the calling
+ 		* thread.
+ 		*
+ 		* @param int phase one of the values of ProfilePhase
+ 		* @param uint64_t ns duration of the phase, in nanoseconds
+ 		*/
+		static void add(int phase, uint64_t ns);
+		/**
+ 		* Closes the histograms of the episode being profiled by the calling thread and starts
+ 		* new ones for the next episode.
+ 		*
+ 		* @param int episode index of the episode that just finished
+ 		*/
+		static void endEpisode(int episode);
+		/**
+ 		* Writes the histograms of all episodes of all threads. If the name of the file ends with
+ 		* .json it is written as JSON, otherwise as CSV, with one line per episode and phase.
+ 		* It must not be called while other threads are being profiled.
+ 		*
+ 		* @param string path name of the file to be written, nothing is written if it is empty
+ 		*/
+		static void dump(const std::string &path);
+		/**
+ 		* @param int phase one of the values of ProfilePhase
+ 		*
+ 		* @return const char* name of the phase, as written in the dumped file
+ 		*/
+		static const char* getPhaseName(int phase);
+};
+
+/**
+ * Measures the time between its construction and its destruction, adding it to a phase.
+ */
+class ScopedTimer{
+	private:
+		int phase;
+		std::chrono::steady_clock::time_point begin;
+	public:
+		ScopedTimer(int phase) : phase(phase), begin(std::chrono::steady_clock::now()){}
+		~ScopedTimer(){
+			Profiler::add(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - begin).count());
+		}
+};
+
+#ifdef __PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(phase) ScopedTimer PROFILE_CONCAT(scopedTimer, __LINE__)(phase)
+#define PROFILE_END_EPISODE(episode) Profiler::endEpisode(episode)
+#define PROFILE_DUMP(path) Profiler::dump(path)
+#else
+#define PROFILE_SCOPE(phase)
+#define PROFILE_END_EPISODE(episode)
+#define PROFILE_DUMP(path)
+#endif
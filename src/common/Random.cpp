@@ -0,0 +1,88 @@
+/****************************************************************************************
+** Pseudo-random number generator used by all agents, xoshiro256** seeded with splitmix64.
+** The constants are the ones from the reference implementation by Blackman and Vigna,
+** available at http://xoshiro.di.unimi.it/
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "Random.hpp"
+#endif
+#include <assert.h>
+
+static inline uint64_t rotl(const uint64_t x, int k){
+	return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t splitmix64(uint64_t &x){
+	uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+Random::Random(uint64_t seed, uint64_t stream){
+	//The stream is mixed before being combined with the seed, so (seed, stream)
+	//and (seed + 1, stream - 1) do not lead to the same state:
+	uint64_t mixedStream = stream;
+	uint64_t x = seed ^ splitmix64(mixedStream);
+	for(int i = 0; i < 4; i++){
+		state[i] = splitmix64(x);
+	}
+}
+
+uint64_t Random::next(){
+	const uint64_t result = rotl(state[1] * 5, 7) * 9;
+	const uint64_t t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotl(state[3], 45);
+
+	return result;
+}
+
+int Random::nextInt(int n){
+	assert(n > 0);
+	//Multiply-shift (Lemire, 2019) instead of the modulo, it is faster and less biased:
+	return (int) (((next() >> 32) * (uint64_t) n) >> 32);
+}
+
+double Random::nextDouble(){
+	return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void Random::jump(){
+	static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+		0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+	uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	for(int i = 0; i < 4; i++){
+		for(int b = 0; b < 64; b++){
+			if(JUMP[i] & (1ULL << b)){
+				s0 ^= state[0];
+				s1 ^= state[1];
+				s2 ^= state[2];
+				s3 ^= state[3];
+			}
+			next();
+		}
+	}
+	state[0] = s0;
+	state[1] = s1;
+	state[2] = s2;
+	state[3] = s3;
+}
+
+Random Random::split(){
+	Random copy = *this;
+	jump();
+	return copy;
+}
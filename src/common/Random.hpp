@@ -0,0 +1,57 @@
+/****************************************************************************************
+** Pseudo-random number generator used by all agents, in place of the global rand(). It
+** implements xoshiro256** (Blackman and Vigna, 2018), which is much faster than rand() and
+** has a 256-bit state, seeded with splitmix64 from the seed informed in the command line.
+**
+** Each agent owns its own generator, so its sequence of random numbers does not depend on
+** any other part of the code calling a random function. When several threads need random
+** numbers, each one must own a generator. They can be obtained with split(), which gives
+** non-overlapping streams (2^128 numbers apart), or by the constructor receiving a stream
+** index, which gives an independent stream for, e.g., each evaluation episode.
+**
+** REMARKS: - A generator must not be used by more than one thread at the same time.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stdint.h>
+
+class Random{
+	private:
+		uint64_t state[4];
+
+		/**
+ 		* Advances the generator 2^128 steps, in constant time. It is used to create streams
+ 		* that do not overlap.
+ 		*/
+		void jump();
+	public:
+		/**
+ 		* Constructor. Generators created with the same seed and stream generate the same sequence.
+ 		*
+ 		* @param uint64_t seed seed of the generator, usually the one informed in the command line
+ 		* @param uint64_t stream index of the stream, different streams are independent
+ 		*/
+		Random(uint64_t seed = 1, uint64_t stream = 0);
+		/**
+ 		* @return uint64_t next 64-bit random number
+ 		*/
+		uint64_t next();
+		/**
+ 		* @param int n upper limit, it must be positive
+ 		*
+ 		* @return int random integer uniformly distributed in [0, n)
+ 		*/
+		int nextInt(int n);
+		/**
+ 		* @return double random number uniformly distributed in [0, 1)
+ 		*/
+		double nextDouble();
+		/**
+ 		* Returns a copy of this generator and advances this one 2^128 steps, so the sequences
+ 		* of both never overlap. It is used to give a generator to each parallel worker.
+ 		*
+ 		* @return Random new generator, independent from this one
+ 		*/
+		Random split();
+};
@@ -0,0 +1,45 @@
+/****************************************************************************************
+** Memory shared between a process and the children it creates with fork, used when the
+** workers of a parallel learner are processes instead of threads (e.g. when the ALE was
+** compiled with SDL). It is an anonymous shared mapping: the children see the writes of
+** each other, and of the parent, to the same pages, which are never copied.
+**
+** The pages are only given to the process when they are first written, and are zeroed,
+** so a large table that is mostly zero costs only the pages that were touched. The
+** operations of Atomic.hpp can be used on this memory by different processes.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+/**
+* Creates a shared mapping, which must be created before fork to be shared with the children.
+* The program is interrupted if it cannot be created.
+*
+* @param size_t numBytes size of the mapping
+*
+* @return void* beginning of the mapping, aligned to a page and filled with zeros
+*/
+inline void* mapSharedMemory(size_t numBytes){
+	void *address = mmap(NULL, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(address == MAP_FAILED){
+		perror("Unable to allocate shared memory");
+		exit(1);
+	}
+	return address;
+}
+
+/**
+* Releases a mapping created by mapSharedMemory in this process; the other processes that
+* share it keep their own view of it.
+*
+* @param void *address beginning of the mapping
+* @param size_t numBytes size of the mapping, as informed when it was created
+*/
+inline void unmapSharedMemory(void *address, size_t numBytes){
+	munmap(address, numBytes);
+}
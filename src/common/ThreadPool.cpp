@@ -0,0 +1,91 @@
+/****************************************************************************************
+** Persistent pool of worker threads, used to run independent tasks (e.g. evaluation
+** episodes) in parallel.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "ThreadPool.hpp"
+#endif
+#include <assert.h>
+
+ThreadPool::ThreadPool(int numThreads){
+	assert(numThreads > 0);
+	task           = NULL;
+	nextTask       = 0;
+	numTasks       = 0;
+	numBusyWorkers = 0;
+	generation     = 0;
+	toStop         = false;
+	for(int i = 0; i < numThreads; i++){
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+	}
+}
+
+ThreadPool::~ThreadPool(){
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		toStop = true;
+	}
+	hasWork.notify_all();
+	for(unsigned int i = 0; i < workers.size(); i++){
+		workers[i].join();
+	}
+}
+
+int ThreadPool::getNumThreads(){
+	return workers.size();
+}
+
+void ThreadPool::workerLoop(int workerId){
+	unsigned long seenGeneration = 0;
+	while(true){
+		const std::function<void(int, int)> *currentTask;
+		int currentNumTasks;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while(!toStop && generation == seenGeneration){
+				hasWork.wait(lock);
+			}
+			if(toStop){
+				return;
+			}
+			seenGeneration  = generation;
+			currentTask     = task;
+			currentNumTasks = numTasks;
+		}
+		//Tasks are picked dynamically, so slow tasks (e.g. long episodes) do not
+		//keep the other workers waiting:
+		for(int i = nextTask.fetch_add(1); i < currentNumTasks; i = nextTask.fetch_add(1)){
+			(*currentTask)(i, workerId);
+		}
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			numBusyWorkers--;
+			if(numBusyWorkers == 0){
+				workDone.notify_all();
+			}
+		}
+	}
+}
+
+void ThreadPool::parallelFor(int numTasks, const std::function<void(int, int)> &task){
+	if(numTasks <= 0){
+		return;
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	this->task     = &task;
+	this->numTasks = numTasks;
+	nextTask       = 0;
+	numBusyWorkers = workers.size();
+	generation++;
+	hasWork.notify_all();
+	while(numBusyWorkers > 0){
+		workDone.wait(lock);
+	}
+	this->task = NULL;
+}
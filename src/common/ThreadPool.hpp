@@ -0,0 +1,71 @@
+/****************************************************************************************
+** Persistent pool of worker threads. Threads are created once, in the constructor, and
+** stay asleep until some work is given to them, so the pool can be used in tight loops
+** (e.g. once per step) without paying for thread creation every time.
+**
+** The only operation available is a parallel for: numTasks tasks are distributed among
+** the workers, which pick the next task as soon as they are done with the previous one.
+** Each task receives its index and the index of the worker running it, which allows the
+** caller to keep per-worker resources (emulators, features, etc.) in a simple vector.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+class ThreadPool{
+	private:
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable hasWork;
+		std::condition_variable workDone;
+
+		const std::function<void(int, int)> *task; //Function being executed by the workers
+		std::atomic<int> nextTask;                 //Index of the next task to be picked by a worker
+		int numTasks;                              //Number of tasks in the current parallel for
+		int numBusyWorkers;                        //Workers that did not finish the current parallel for
+		unsigned long generation;                  //Incremented every time new work is available
+		bool toStop;
+
+		/**
+		* Loop executed by each worker thread: it waits for work, executes as many tasks as
+		* possible and goes back to sleep.
+		*
+		* @param int workerId index of the worker, between 0 and numThreads - 1
+		*/
+		void workerLoop(int workerId);
+		/**
+		* Constructor declared as private to force the user to inform the number of threads.
+		*/
+		ThreadPool();
+	public:
+		/**
+		* Constructor. It creates the worker threads, which stay asleep until parallelFor is called.
+		*
+		* @param int numThreads number of worker threads, it should be at least 1
+		*/
+		ThreadPool(int numThreads);
+		/**
+		* Destructor, it wakes up all workers and waits for them to finish.
+		*/
+		~ThreadPool();
+		/**
+		* Executes task(i, workerId) for every i in [0, numTasks), distributing the tasks
+		* among the workers. It only returns once all tasks are done. It must not be called
+		* from inside a task.
+		*
+		* @param int numTasks number of tasks to be executed
+		* @param std::function<void(int, int)> task function receiving the index of the task
+		*        and the index of the worker executing it
+		*/
+		void parallelFor(int numTasks, const std::function<void(int, int)> &task);
+		/**
+		* @return int number of worker threads in the pool
+		*/
+		int getNumThreads();
+};
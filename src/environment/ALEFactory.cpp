@@ -0,0 +1,29 @@
+/****************************************************************************************
+** Creation of Arcade Learning Environment instances configured from the Parameters.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "ALEFactory.hpp"
+#endif
+
+ALEInterface* ALEFactory::createALE(Parameters *param, int seed){
+	ALEInterface *ale = new ALEInterface(false);
+
+	ale->setFloat("stochasticity", 0.00);
+	ale->setInt("random_seed", seed);
+	ale->setFloat("frame_skip", param->getNumStepsPerAction());
+	ale->setInt("max_num_frames_per_episode", param->getEpisodeLength());
+#ifdef __SYNTHETIC
+	ale->setInt("synthetic_fps", param->getSyntheticFps());
+	ale->setInt("synthetic_coin_reward", param->getSyntheticReward());
+	ale->setInt("synthetic_sprite_period", param->getSyntheticSpritePeriod());
+#endif
+
+	ale->loadROM(param->getRomPath().c_str());
+	return ale;
+}
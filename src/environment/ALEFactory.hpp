@@ -0,0 +1,33 @@
+/****************************************************************************************
+** Creation of Arcade Learning Environment instances configured from the Parameters, in
+** the same way main configures the emulator given to the agents. It is used whenever an
+** agent needs more than one emulator, e.g. when running episodes in parallel, since each
+** thread must own its own ALEInterface.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../common/Parameters.hpp"
+#endif
+
+class ALEFactory{
+	public:
+	   /**
+ 		* Creates a new emulator, without display, with the ROM informed in the command line
+ 		* already loaded. Stochasticity, frame skip and maximum episode length are set from
+ 		* the parameters, as well as the dynamics of the synthetic environment when it is used.
+ 		* The caller is responsible for deleting the returned object.
+ 		*
+ 		* @param Parameters *param parameters read from the command line and config file
+ 		* @param int seed seed to be used by the emulator's random number generator
+ 		*
+ 		* @return ALEInterface* new emulator, ready to be used
+ 		*/
+		static ALEInterface* createALE(Parameters *param, int seed);
+};
@@ -0,0 +1,234 @@
+/****************************************************************************************
+** Recording and reading of compressed files with the screens and RAMs observed by an agent.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef FRAME_CORPUS_H
+#define FRAME_CORPUS_H
+#include "FrameCorpus.hpp"
+#endif
+#include <zlib.h>
+
+//The disk is written in blocks of 4MB, a few chunks of Atari screens:
+FrameCorpusWriter::FrameCorpusWriter(const std::string &path, int framesPerChunk) : writer(path, 1 << 22){
+	memset(&header, 0, sizeof(FrameCorpusHeader));
+	memcpy(header.magic, FRAME_CORPUS_MAGIC, 4);
+	header.version = FRAME_CORPUS_VERSION;
+	header.framesPerChunk = framesPerChunk;
+	bytesWritten = 0;
+	numFrames = 0;
+	numFramesInChunk = 0;
+	isClosed = false;
+}
+
+FrameCorpusWriter::~FrameCorpusWriter(){
+	close();
+}
+
+int FrameCorpusWriter::getNumFrames(){
+	return numFrames;
+}
+
+void FrameCorpusWriter::record(const ALEScreen &screen, const ALERAM &ram, int action, int reward){
+	if(isClosed){
+		return;
+	}
+	if(numFrames == 0){
+		header.height = screen.height();
+		header.width = screen.width();
+		header.ramSize = ram.size();
+		writer.write(&header, sizeof(FrameCorpusHeader));
+		bytesWritten += sizeof(FrameCorpusHeader);
+		frame.resize(2 * sizeof(int32_t) + header.height * header.width + header.ramSize);
+		previous.resize(frame.size());
+	}
+	int32_t values[2] = {action, reward};
+	memcpy(&frame[0], values, sizeof(values));
+	memcpy(&frame[sizeof(values)], screen.getArray(), header.height * header.width);
+	unsigned char *ramBytes = &frame[sizeof(values) + header.height * header.width];
+	for(unsigned int i = 0; i < header.ramSize; i++){
+		ramBytes[i] = ram.get(i);
+	}
+
+	size_t start = chunk.size();
+	chunk.resize(start + frame.size());
+	if(numFramesInChunk == 0){
+		memcpy(&chunk[start], &frame[0], frame.size());
+	}
+	else{
+		for(unsigned int i = 0; i < frame.size(); i++){
+			chunk[start + i] = frame[i] ^ previous[i];
+		}
+	}
+	previous.swap(frame);
+	numFrames++;
+	numFramesInChunk++;
+	if(numFramesInChunk == header.framesPerChunk){
+		writeChunk();
+	}
+}
+
+void FrameCorpusWriter::writeChunk(){
+	uLongf compressedSize = compressBound(chunk.size());
+	compressed.resize(compressedSize);
+	//The XORed frames are mostly zeros, the fastest level already compresses them a lot:
+	int status = compress2(&compressed[0], &compressedSize, &chunk[0], chunk.size(), Z_BEST_SPEED);
+	//Nothing else is written, so the file has no footer and is rejected by the reader:
+	if(status != Z_OK){
+		printf("Unable to compress the frames of the corpus (zlib error %d), the recording is stopped.\n", status);
+		isClosed = true;
+		return;
+	}
+	writer.write(&compressed[0], compressedSize);
+
+	FrameCorpusChunk entry;
+	memset(&entry, 0, sizeof(FrameCorpusChunk));
+	entry.offset = bytesWritten;
+	entry.firstFrame = numFrames - numFramesInChunk;
+	entry.numFrames = numFramesInChunk;
+	entry.compressedSize = compressedSize;
+	index.push_back(entry);
+
+	bytesWritten += compressedSize;
+	numFramesInChunk = 0;
+	chunk.clear();
+}
+
+void FrameCorpusWriter::close(){
+	if(isClosed){
+		return;
+	}
+	if(numFrames == 0){
+		writer.write(&header, sizeof(FrameCorpusHeader));
+		bytesWritten += sizeof(FrameCorpusHeader);
+	}
+	if(numFramesInChunk > 0){
+		writeChunk();
+		if(isClosed){
+			return;
+		}
+	}
+	FrameCorpusFooter footer;
+	memset(&footer, 0, sizeof(FrameCorpusFooter));
+	footer.indexOffset = bytesWritten;
+	footer.numChunks = index.size();
+	footer.numFrames = numFrames;
+	memcpy(footer.magic, FRAME_CORPUS_MAGIC, 4);
+	if(!index.empty()){
+		writer.write(&index[0], index.size() * sizeof(FrameCorpusChunk));
+	}
+	writer.write(&footer, sizeof(FrameCorpusFooter));
+	writer.flush();
+	isClosed = true;
+}
+
+FrameCorpusReader::FrameCorpusReader(const std::string &path){
+	numFrames = 0;
+	frameSize = 0;
+	loadedChunk = -1;
+	nextFrame = 0;
+	file = fopen(path.c_str(), "rb");
+	if(file == NULL){
+		printf("Unable to open the file '%s' to be read.\n", path.c_str());
+		return;
+	}
+	FrameCorpusFooter footer;
+	bool isValid = fread(&header, sizeof(FrameCorpusHeader), 1, file) == 1
+		&& memcmp(header.magic, FRAME_CORPUS_MAGIC, 4) == 0 && header.version == FRAME_CORPUS_VERSION
+		&& fseek(file, -(long) sizeof(FrameCorpusFooter), SEEK_END) == 0
+		&& fread(&footer, sizeof(FrameCorpusFooter), 1, file) == 1
+		&& memcmp(footer.magic, FRAME_CORPUS_MAGIC, 4) == 0;
+	if(isValid && footer.numChunks > 0){
+		index.resize(footer.numChunks);
+		isValid = fseek(file, footer.indexOffset, SEEK_SET) == 0
+			&& fread(&index[0], sizeof(FrameCorpusChunk), footer.numChunks, file) == footer.numChunks;
+	}
+	if(!isValid){
+		printf("The file '%s' is not a complete corpus of frames.\n", path.c_str());
+		fclose(file);
+		file = NULL;
+		return;
+	}
+	numFrames = footer.numFrames;
+	frameSize = 2 * sizeof(int32_t) + header.height * header.width + header.ramSize;
+}
+
+FrameCorpusReader::~FrameCorpusReader(){
+	if(file != NULL){
+		fclose(file);
+	}
+}
+
+bool FrameCorpusReader::isOpen(){
+	return file != NULL;
+}
+
+int FrameCorpusReader::getNumFrames(){
+	return numFrames;
+}
+
+int FrameCorpusReader::getHeight(){
+	return header.height;
+}
+
+int FrameCorpusReader::getWidth(){
+	return header.width;
+}
+
+void FrameCorpusReader::seek(int frame){
+	nextFrame = frame;
+}
+
+bool FrameCorpusReader::loadChunk(int c){
+	const FrameCorpusChunk &entry = index[c];
+	compressed.resize(entry.compressedSize);
+	chunk.resize((size_t) entry.numFrames * frameSize);
+	uLongf size = chunk.size();
+	if(fseek(file, entry.offset, SEEK_SET) != 0
+		|| fread(&compressed[0], 1, entry.compressedSize, file) != entry.compressedSize
+		|| uncompress(&chunk[0], &size, &compressed[0], entry.compressedSize) != Z_OK || size != chunk.size()){
+		loadedChunk = -1;
+		return false;
+	}
+	//Undoing the XORs, so any frame of the chunk can be accessed directly:
+	for(size_t i = frameSize; i < chunk.size(); i++){
+		chunk[i] ^= chunk[i - frameSize];
+	}
+	loadedChunk = c;
+	return true;
+}
+
+bool FrameCorpusReader::next(ALEScreen &screen, ALERAM &ram, int &action, int &reward){
+	if(file == NULL || nextFrame < 0 || nextFrame >= numFrames){
+		return false;
+	}
+	//Binary search for the last chunk that starts at or before the frame:
+	int c = 0, last = index.size() - 1;
+	while(c < last){
+		int middle = (c + last + 1) / 2;
+		if((int) index[middle].firstFrame <= nextFrame){
+			c = middle;
+		}
+		else{
+			last = middle - 1;
+		}
+	}
+	if(c != loadedChunk && !loadChunk(c)){
+		return false;
+	}
+	const unsigned char *bytes = &chunk[(size_t) (nextFrame - index[c].firstFrame) * frameSize];
+	int32_t values[2];
+	memcpy(values, bytes, sizeof(values));
+	action = values[0];
+	reward = values[1];
+	memcpy(screen.getArray(), bytes + sizeof(values), header.height * header.width);
+	const unsigned char *ramBytes = bytes + sizeof(values) + header.height * header.width;
+	for(unsigned int i = 0; i < header.ramSize; i++){
+		*ram.byte(i) = ramBytes[i];
+	}
+	nextFrame++;
+	return true;
+}
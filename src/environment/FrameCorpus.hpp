@@ -0,0 +1,197 @@
+/****************************************************************************************
+** Recording of the screens and RAMs observed by an agent into a compressed file, and the
+** reading of such a file, so features can be extracted and benchmarked without running
+** the emulator. The file has the layout below, all integers in the byte order of the
+** machine that recorded it:
+**
+**   FrameCorpusHeader | chunk 0 | chunk 1 | ... | FrameCorpusChunk[numChunks] | FrameCorpusFooter
+**
+** Each chunk holds up to framesPerChunk consecutive frames compressed with zlib. A frame is
+** the action taken, the reward observed, the screen and the RAM after the action. Inside a
+** chunk every frame but the first is stored as the XOR with the previous one, which is
+** mostly zeros since little changes between two frames, so it compresses very well. The
+** index at the end of the file allows jumping to any frame decompressing a single chunk.
+**
+** REMARKS: - Compression happens in the thread that records, the writing to the disk in
+**            the background (see common/AsyncFileWriter.hpp).
+**          - A file is only readable after the writer is closed, since the index is the
+**            last thing written.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+#include "../common/AsyncFileWriter.hpp"
+#endif
+#include <string.h>
+#include <stdint.h>
+
+#define FRAME_CORPUS_MAGIC   "ALEC"
+#define FRAME_CORPUS_VERSION 1
+
+/**
+ * Header at the beginning of the file, it describes the frames stored.
+ */
+struct FrameCorpusHeader{
+	char magic[4];              //FRAME_CORPUS_MAGIC
+	uint32_t version;           //FRAME_CORPUS_VERSION
+	uint32_t height;            //Number of rows of the screen
+	uint32_t width;             //Number of columns of the screen
+	uint32_t ramSize;           //Number of bytes of the RAM
+	uint32_t framesPerChunk;    //Largest number of frames in a chunk
+};
+
+/**
+ * Entry of the index, one per chunk.
+ */
+struct FrameCorpusChunk{
+	uint64_t offset;            //Position of the chunk in the file
+	uint32_t firstFrame;        //Index of the first frame of the chunk
+	uint32_t numFrames;         //Number of frames in the chunk
+	uint32_t compressedSize;    //Number of bytes of the chunk in the file
+	uint32_t reserved;
+};
+
+/**
+ * Footer at the end of the file, used to find the index.
+ */
+struct FrameCorpusFooter{
+	uint64_t indexOffset;       //Position of the first FrameCorpusChunk in the file
+	uint32_t numChunks;         //Number of entries in the index
+	uint32_t numFrames;         //Total number of frames in the file
+	char magic[4];              //FRAME_CORPUS_MAGIC, to detect files that were not closed
+	uint32_t reserved;
+};
+
+class FrameCorpusWriter{
+	private:
+		AsyncFileWriter writer;
+		FrameCorpusHeader header;
+		std::vector<FrameCorpusChunk> index;
+		std::vector<unsigned char> chunk;       //Frames of the current chunk, already XORed
+		std::vector<unsigned char> previous;    //Last frame recorded, as it is, to compute the next XOR
+		std::vector<unsigned char> frame;       //Frame being recorded
+		std::vector<unsigned char> compressed;  //Output of zlib
+		uint64_t bytesWritten;
+		uint32_t numFrames, numFramesInChunk;
+		bool isClosed;
+
+		/**
+ 		* Compresses the current chunk, writes it and adds it to the index. If it cannot be
+ 		* compressed, the recording is stopped and the file is left without a footer.
+ 		*/
+		void writeChunk();
+
+		/**
+ 		* Constructor declared as private to force the user to inform the file to be written.
+ 		*/
+		FrameCorpusWriter();
+	public:
+		/**
+ 		* Constructor, it creates the file. The header is only written with the first frame,
+ 		* when the size of the screen is known.
+ 		*
+ 		* @param string path name of the file to be written
+ 		* @param int framesPerChunk number of frames compressed together; larger chunks compress
+ 		*        better but make the reader decompress more to access a single frame
+ 		*/
+		FrameCorpusWriter(const std::string &path, int framesPerChunk = 256);
+		/**
+ 		* Records a frame. It is not thread-safe, each thread must use its own writer.
+ 		*
+ 		* @param ALEScreen& screen screen observed after the action was taken
+ 		* @param ALERAM& ram RAM observed after the action was taken
+ 		* @param int action action taken
+ 		* @param int reward reward given by the emulator
+ 		*/
+		void record(const ALEScreen &screen, const ALERAM &ram, int action, int reward);
+		/**
+ 		* Writes the last chunk, the index and the footer. Nothing can be recorded afterwards.
+ 		* It is called by the destructor if it was not called before.
+ 		*/
+		void close();
+		/**
+ 		* @return int number of frames recorded so far
+ 		*/
+		int getNumFrames();
+		/**
+		* Destructor, it closes the file.
+		*/
+		~FrameCorpusWriter();
+};
+
+class FrameCorpusReader{
+	private:
+		FILE *file;
+		FrameCorpusHeader header;
+		std::vector<FrameCorpusChunk> index;
+		std::vector<unsigned char> chunk;       //Frames of the loaded chunk, already decoded
+		std::vector<unsigned char> compressed;
+		int numFrames, frameSize;
+		int loadedChunk;                        //Index of the chunk in memory, -1 if none
+		int nextFrame;                          //Index of the frame returned by the next call to next
+
+		/**
+ 		* Reads, decompresses and decodes a chunk.
+ 		*
+ 		* @param int c index of the chunk
+ 		*
+ 		* @return bool false if the chunk could not be read
+ 		*/
+		bool loadChunk(int c);
+
+		/**
+ 		* Constructor declared as private to force the user to inform the file to be read.
+ 		*/
+		FrameCorpusReader();
+	public:
+		/**
+ 		* Constructor, it opens the file and reads its index.
+ 		*
+ 		* @param string path name of a file written by FrameCorpusWriter
+ 		*/
+		FrameCorpusReader(const std::string &path);
+		/**
+ 		* @return bool false if the file could not be opened, was not written by FrameCorpusWriter
+ 		*         or was not closed properly
+ 		*/
+		bool isOpen();
+		/**
+ 		* @return int number of frames in the file
+ 		*/
+		int getNumFrames();
+		/**
+ 		* @return int number of rows of the screens, to create the ALEScreen passed to next
+ 		*/
+		int getHeight();
+		/**
+ 		* @return int number of columns of the screens, to create the ALEScreen passed to next
+ 		*/
+		int getWidth();
+		/**
+ 		* Makes the next call to next return the given frame.
+ 		*
+ 		* @param int frame index of the frame, between 0 and getNumFrames() - 1
+ 		*/
+		void seek(int frame);
+		/**
+ 		* Reads the next frame. The frames are read in the order they were recorded.
+ 		*
+ 		* @param ALEScreen& screen object that receives the screen, of size getHeight() x getWidth()
+ 		* @param ALERAM& ram object that receives the RAM
+ 		* @param int& action receives the action taken
+ 		* @param int& reward receives the reward observed
+ 		*
+ 		* @return bool false if there are no more frames or the file is corrupted
+ 		*/
+		bool next(ALEScreen &screen, ALERAM &ram, int &action, int &reward);
+		/**
+		* Destructor, it closes the file.
+		*/
+		~FrameCorpusReader();
+};
@@ -0,0 +1,54 @@
+/****************************************************************************************
+** Pool of saved emulator states, used to evaluate several branches from the same state
+** in parallel.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef SNAPSHOT_POOL_H
+#define SNAPSHOT_POOL_H
+#include "SnapshotPool.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "ALEFactory.hpp"
+#endif
+
+SnapshotPool::SnapshotPool(Parameters *param, int numThreads) : pool(numThreads){
+	for(int i = 0; i < pool.getNumThreads(); i++){
+		emulators.push_back(ALEFactory::createALE(param, param->getSeed()));
+	}
+}
+
+SnapshotPool::~SnapshotPool(){
+	for(unsigned int i = 0; i < emulators.size(); i++){
+		delete emulators[i];
+	}
+}
+
+int SnapshotPool::save(ALEInterface &ale){
+	snapshots.push_back(ale.cloneSystemState());
+	return snapshots.size() - 1;
+}
+
+void SnapshotPool::restore(int snapshot, ALEInterface &ale){
+	ale.restoreSystemState(snapshots[snapshot]);
+}
+
+void SnapshotPool::runBranches(int snapshot, int numBranches, const std::function<void(int, ALEInterface&)> &branch){
+	pool.parallelFor(numBranches, [&](int b, int worker){
+		ALEInterface &ale = *emulators[worker];
+		ale.restoreSystemState(snapshots[snapshot]);
+		branch(b, ale);
+	});
+}
+
+void SnapshotPool::clear(){
+	snapshots.clear();
+}
+
+int SnapshotPool::getNumSnapshots(){
+	return snapshots.size();
+}
@@ -0,0 +1,87 @@
+/****************************************************************************************
+** Pool of saved emulator states, used to evaluate several branches from the same state
+** in parallel. A snapshot is taken from any emulator (e.g. right after a reset, or at
+** checkpoints along an episode) with the ALE's cloneSystemState, which also saves the
+** emulator's random number generator, so a branch restored from it plays exactly as if it
+** had been run from the original state. Each worker thread owns its own emulator, into
+** which the snapshot is restored before its branch is played.
+**
+** REMARKS: - Snapshots are kept until the pool is destroyed or cleared; an Atari state takes
+**            a few KB, so thousands of checkpoints are cheap.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../common/Parameters.hpp"
+#endif
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "../common/ThreadPool.hpp"
+#endif
+#include <vector>
+#include <functional>
+
+class SnapshotPool{
+	private:
+		ThreadPool pool;
+		std::vector<ALEInterface*> emulators;  //One emulator per worker
+		std::vector<ALEState> snapshots;
+
+		/**
+ 		* Constructor declared as private to force the user to inform the parameters of the emulators.
+ 		*/
+		SnapshotPool();
+	public:
+		/**
+ 		* Constructor. It creates the worker threads and, for each of them, an emulator configured
+ 		* as the one used by the agent (see ALEFactory).
+ 		*
+ 		* @param Parameters *param parameters read from the command line and config file
+ 		* @param int numThreads number of worker threads, each one with its own emulator
+ 		*/
+		SnapshotPool(Parameters *param, int numThreads);
+		/**
+ 		* Destructor, it deletes the workers' emulators.
+ 		*/
+		~SnapshotPool();
+		/**
+ 		* Saves the current state of an emulator, which is not modified.
+ 		*
+ 		* @param ALEInterface& ale emulator whose state is saved
+ 		*
+ 		* @return int index of the snapshot
+ 		*/
+		int save(ALEInterface &ale);
+		/**
+ 		* Restores a snapshot into an emulator, e.g. to continue from a checkpoint.
+ 		*
+ 		* @param int snapshot index returned by save
+ 		* @param ALEInterface& ale emulator that receives the state
+ 		*/
+		void restore(int snapshot, ALEInterface &ale);
+		/**
+ 		* Plays numBranches branches from the same snapshot, in parallel. Each branch is played in
+ 		* the emulator of a worker, into which the snapshot is restored first. It only returns once
+ 		* all branches are done.
+ 		*
+ 		* @param int snapshot index returned by save
+ 		* @param int numBranches number of branches
+ 		* @param std::function<void(int, ALEInterface&)> branch function receiving the index of the
+ 		*        branch and the emulator in which it must be played
+ 		*/
+		void runBranches(int snapshot, int numBranches, const std::function<void(int, ALEInterface&)> &branch);
+		/**
+ 		* Discards all snapshots, the indices returned before become invalid.
+ 		*/
+		void clear();
+		/**
+ 		* @return int number of snapshots saved
+ 		*/
+		int getNumSnapshots();
+};
@@ -0,0 +1,149 @@
+/****************************************************************************************
+** Cache of starting states, used to begin the learning episodes in different states
+** without emulating the frames before them.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef START_STATE_CACHE_H
+#define START_STATE_CACHE_H
+#include "StartStateCache.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "ALEFactory.hpp"
+#endif
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "../common/ThreadPool.hpp"
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define START_STATES_MAGIC "ALES"
+#define START_STATES_VERSION 1
+//Seed of the emulators and of the generator that draws the number of no-ops, the same for all runs:
+#define START_STATES_SEED 1
+
+struct StartStatesHeader{
+	char magic[4];
+	int32_t version;
+	int32_t numStates;
+	int32_t maxNoops;
+	int32_t frameSkip;
+	char romName[64];
+};
+
+StartStateCache::StartStateCache(Parameters *param, int numThreads){
+	maxNoops = param->getNumStartNoops();
+	frameSkip = param->getNumStepsPerAction();
+	std::string romPath = param->getRomPath();
+	romName = romPath.substr(romPath.find_last_of("/") + 1);
+
+	std::string path = param->getStartStatesPath();
+	if(!path.empty() && load(path, param->getNumStartStates())){
+		printf("Loaded %d start states from '%s'.\n", getNumStates(), path.c_str());
+		return;
+	}
+	generate(param, param->getNumStartStates(), numThreads);
+	if(!path.empty()){
+		save(path);
+	}
+}
+
+void StartStateCache::generate(Parameters *param, int numStates, int numThreads){
+	ThreadPool pool(numThreads);
+	std::vector<ALEInterface*> emulators;
+	for(int i = 0; i < pool.getNumThreads(); i++){
+		emulators.push_back(ALEFactory::createALE(param, START_STATES_SEED));
+	}
+	states.resize(numStates);
+	numNoops.resize(numStates);
+	pool.parallelFor(numStates, [&](int s, int worker){
+		ALEInterface &ale = *emulators[worker];
+		Random rng(START_STATES_SEED, s);
+		ale.reset_game();
+		numNoops[s] = rng.nextInt(maxNoops + 1);
+		for(int i = 0; i < numNoops[s] && !ale.game_over(); i++){
+			ale.act(PLAYER_A_NOOP);
+		}
+		states[s] = ale.cloneSystemState();
+	});
+	for(unsigned int i = 0; i < emulators.size(); i++){
+		delete emulators[i];
+	}
+}
+
+bool StartStateCache::load(std::string path, int numStates){
+	FILE *file = fopen(path.c_str(), "rb");
+	if(file == NULL){
+		return false;
+	}
+	StartStatesHeader header;
+	bool isValid = fread(&header, sizeof(StartStatesHeader), 1, file) == 1
+		&& memcmp(header.magic, START_STATES_MAGIC, 4) == 0 && header.version == START_STATES_VERSION
+		&& header.numStates == numStates && header.maxNoops == maxNoops && header.frameSkip == frameSkip
+		&& strncmp(header.romName, romName.c_str(), sizeof(header.romName)) == 0;
+	std::vector<ALEState> loadedStates;
+	std::vector<int> loadedNoops;
+	std::string serialized;
+	for(int s = 0; isValid && s < numStates; s++){
+		int32_t noops;
+		uint32_t size;
+		isValid = fread(&noops, sizeof(int32_t), 1, file) == 1 && fread(&size, sizeof(uint32_t), 1, file) == 1;
+		if(isValid){
+			serialized.resize(size);
+			isValid = size == 0 || fread(&serialized[0], 1, size, file) == size;
+		}
+		if(isValid){
+			loadedNoops.push_back(noops);
+			loadedStates.push_back(ALEState(serialized));
+		}
+	}
+	fclose(file);
+	if(!isValid){
+		printf("The file '%s' does not have the start states requested, they are generated again.\n", path.c_str());
+		return false;
+	}
+	states.swap(loadedStates);
+	numNoops.swap(loadedNoops);
+	return true;
+}
+
+void StartStateCache::save(std::string path){
+	FILE *file = fopen(path.c_str(), "wb");
+	if(file == NULL){
+		printf("Unable to open the file '%s' to save the start states.\n", path.c_str());
+		return;
+	}
+	StartStatesHeader header;
+	memset(&header, 0, sizeof(StartStatesHeader));
+	memcpy(header.magic, START_STATES_MAGIC, 4);
+	header.version = START_STATES_VERSION;
+	header.numStates = states.size();
+	header.maxNoops = maxNoops;
+	header.frameSkip = frameSkip;
+	strncpy(header.romName, romName.c_str(), sizeof(header.romName) - 1);
+	bool isWritten = fwrite(&header, sizeof(StartStatesHeader), 1, file) == 1;
+	for(unsigned int s = 0; isWritten && s < states.size(); s++){
+		std::string serialized = states[s].serialize();
+		int32_t noops = numNoops[s];
+		uint32_t size = serialized.size();
+		isWritten = fwrite(&noops, sizeof(int32_t), 1, file) == 1 && fwrite(&size, sizeof(uint32_t), 1, file) == 1
+			&& fwrite(serialized.data(), 1, size, file) == size;
+	}
+	if(fclose(file) != 0 || !isWritten){
+		printf("Unable to save the start states in '%s'.\n", path.c_str());
+	}
+}
+
+void StartStateCache::restore(ALEInterface &ale, Random &rng){
+	ale.restoreSystemState(states[rng.nextInt(states.size())]);
+}
+
+int StartStateCache::getNumStates(){
+	return states.size();
+}
@@ -0,0 +1,94 @@
+/****************************************************************************************
+** Cache of starting states, used to begin the learning episodes in different states
+** without emulating the frames before them. Each state is obtained by resetting the game
+** and taking a random number of no-op actions, between 0 and START_NOOPS, and is saved with
+** the ALE's cloneSystemState. Starting an episode then costs a restoreSystemState, whose
+** cost only depends on the size of the state.
+**
+** The states are generated in parallel when the cache is created, each worker with its own
+** emulator. The emulators and the number of no-ops of state i use a fixed seed, so the
+** cache does not depend on the seed of the agent nor on the number of threads. It can be
+** saved to START_STATES_FILE, one file per ROM, and is loaded from it in the next runs if
+** the file was created with the same ROM and parameters.
+**
+** REMARKS: - The file stores, after a header, for each state the number of no-ops taken,
+**            the size of the serialized state and the string given by ALEState::serialize.
+**          - States can only be restored into emulators created with the same ROM and
+**            frame skip (see ALEFactory).
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../common/Parameters.hpp"
+#endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../common/Random.hpp"
+#endif
+#include <vector>
+#include <string>
+
+class StartStateCache{
+	private:
+		std::vector<ALEState> states;
+		std::vector<int> numNoops;          //Number of no-ops taken before each state
+		int maxNoops;                       //Maximum number of no-ops before a state
+		std::string romName;                //Name of the ROM, as in the command line, checked when loading
+		int frameSkip;                      //Frames per action, checked when loading
+
+		/**
+ 		* Constructor declared as private to force the user to inform the parameters of the emulators.
+ 		*/
+		StartStateCache();
+		/**
+ 		* Generates the states, numThreads at a time, each thread in its own emulator.
+ 		*
+ 		* @param Parameters *param parameters used to create the emulators
+ 		* @param int numStates number of states to be generated
+ 		* @param int numThreads number of worker threads
+ 		*/
+		void generate(Parameters *param, int numStates, int numThreads);
+		/**
+ 		* Loads the states from a file written by save.
+ 		*
+ 		* @param std::string path path to the file
+ 		* @param int numStates number of states expected in the file
+ 		*
+ 		* @return bool false if the file does not exist or was not created with the same ROM,
+ 		*         number of states, maximum number of no-ops and frame skip
+ 		*/
+		bool load(std::string path, int numStates);
+		/**
+ 		* Saves the states in a file, it is overwritten if it already exists.
+ 		*
+ 		* @param std::string path path to the file
+ 		*/
+		void save(std::string path);
+	public:
+		/**
+ 		* Constructor. It loads the states from START_STATES_FILE if possible, otherwise it
+ 		* generates START_STATES states and, if START_STATES_FILE is set, saves them there.
+ 		*
+ 		* @param Parameters *param parameters read from the command line and config file
+ 		* @param int numThreads number of threads used to generate the states
+ 		*/
+		StartStateCache(Parameters *param, int numThreads);
+		/**
+ 		* Restores one of the states, chosen uniformly at random, into an emulator. It can be
+ 		* called by several threads at the same time, each one with its own generator.
+ 		*
+ 		* @param ALEInterface& ale emulator that receives the state
+ 		* @param Random& rng random number generator owned by the caller
+ 		*/
+		void restore(ALEInterface &ale, Random &rng);
+		/**
+ 		* @return int number of states in the cache
+ 		*/
+		int getNumStates();
+};
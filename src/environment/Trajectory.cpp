@@ -0,0 +1,56 @@
+/****************************************************************************************
+** Binary file with the actions taken by an agent and the rewards observed.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+#include "Trajectory.hpp"
+#endif
+
+//A buffer holds 4096 steps, a few minutes of human play:
+TrajectoryWriter::TrajectoryWriter(const std::string &path, int seed, int numStepsPerAction, int episodeLength,
+	const std::string &romPath) : writer(path, 4096 * sizeof(TrajectoryStep)){
+	TrajectoryHeader header;
+	memset(&header, 0, sizeof(TrajectoryHeader));
+	memcpy(header.magic, TRAJECTORY_MAGIC, 4);
+	header.version = TRAJECTORY_VERSION;
+	header.seed = seed;
+	header.numStepsPerAction = numStepsPerAction;
+	header.episodeLength = episodeLength;
+	size_t slash = romPath.find_last_of("/");
+	std::string rom = slash == std::string::npos ? romPath : romPath.substr(slash + 1);
+	strncpy(header.rom, rom.c_str(), sizeof(header.rom) - 1);
+	writer.write(&header, sizeof(TrajectoryHeader));
+}
+
+void TrajectoryWriter::record(int episode, int frame, int action, int reward){
+	TrajectoryStep step;
+	step.episode = episode;
+	step.frame = frame;
+	step.action = action;
+	step.reward = reward;
+	writer.write(&step, sizeof(TrajectoryStep));
+}
+
+bool TrajectoryWriter::readAll(const std::string &path, TrajectoryHeader &header, std::vector<TrajectoryStep> &steps){
+	FILE *file = fopen(path.c_str(), "rb");
+	if(file == NULL){
+		return false;
+	}
+	if(fread(&header, sizeof(TrajectoryHeader), 1, file) != 1 || memcmp(header.magic, TRAJECTORY_MAGIC, 4) != 0
+		|| header.version != TRAJECTORY_VERSION){
+		fclose(file);
+		return false;
+	}
+	TrajectoryStep step;
+	//An incomplete step at the end (e.g. the agent was killed) is ignored:
+	while(fread(&step, sizeof(TrajectoryStep), 1, file) == 1){
+		steps.push_back(step);
+	}
+	fclose(file);
+	return true;
+}
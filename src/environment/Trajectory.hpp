@@ -0,0 +1,84 @@
+/****************************************************************************************
+** Binary file with the actions taken by an agent and the rewards observed, written in the
+** background. Together with the settings of the emulator, stored in the header, this is
+** enough to regenerate every state visited, since the emulator is deterministic given its
+** seed (see tools/trajectory, which replays such files without SDL).
+**
+** REMARKS: - The records are written in the byte order of the machine that ran the agent.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+#include "../common/AsyncFileWriter.hpp"
+#endif
+#include <string.h>
+#include <stdint.h>
+
+#define TRAJECTORY_MAGIC    "ALET"
+#define TRAJECTORY_VERSION  1
+
+/**
+ * Header at the beginning of the file, with the settings used to create the emulator.
+ */
+struct TrajectoryHeader{
+	char magic[4];              //TRAJECTORY_MAGIC
+	uint32_t version;           //TRAJECTORY_VERSION
+	int32_t seed;               //Seed of the emulator
+	int32_t numStepsPerAction;  //Frame skip of the emulator
+	int32_t episodeLength;      //Maximum number of frames per episode
+	int32_t reserved;
+	char rom[64];               //Name of the ROM played, without the path, truncated if needed
+};
+
+/**
+ * A step of the trajectory.
+ */
+struct TrajectoryStep{
+	int32_t episode;            //Index of the episode, starting at 0
+	int32_t frame;              //Frame of the episode in which the action was taken
+	int32_t action;             //Action taken, as in the enum Action of the ALE
+	int32_t reward;             //Reward given by the emulator
+};
+
+class TrajectoryWriter{
+	private:
+		AsyncFileWriter writer;
+
+		/**
+ 		* Constructor declared as private to force the user to inform the file to be written.
+ 		*/
+		TrajectoryWriter();
+	public:
+		/**
+ 		* Constructor, it creates the file and writes its header.
+ 		*
+ 		* @param string path name of the file to be written
+ 		* @param int seed seed of the emulator
+ 		* @param int numStepsPerAction frame skip of the emulator
+ 		* @param int episodeLength maximum number of frames per episode
+ 		* @param string romPath path to the ROM played
+ 		*/
+		TrajectoryWriter(const std::string &path, int seed, int numStepsPerAction, int episodeLength,
+			const std::string &romPath);
+		/**
+ 		* Appends a step to the trajectory. Nothing is written to the disk in the caller's thread.
+ 		*
+ 		* @param int episode index of the episode, starting at 0
+ 		* @param int frame frame of the episode in which the action was taken
+ 		* @param int action action taken
+ 		* @param int reward reward given by the emulator
+ 		*/
+		void record(int episode, int frame, int action, int reward);
+		/**
+ 		* Reads a file written by this class.
+ 		*
+ 		* @param string path name of the file to be read
+ 		* @param TrajectoryHeader& header object that will receive the header
+ 		* @param vector<TrajectoryStep>& steps vector that will receive the steps
+ 		*
+ 		* @return bool false if the file could not be opened or was not written by this class
+ 		*/
+		static bool readAll(const std::string &path, TrajectoryHeader &header, std::vector<TrajectoryStep> &steps);
+};
@@ -0,0 +1,153 @@
+/****************************************************************************************
+** Vectorized environment: N instances of the Arcade Learning Environment stepped in
+** lockstep, in parallel.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+#include "VecEnv.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "ALEFactory.hpp"
+#endif
+#include <assert.h>
+
+VecEnv::VecEnv(Parameters *param, int numEnvs, int numThreads, Features *features) : pool(numThreads){
+	assert(numEnvs > 0);
+	this->numEnvs = numEnvs;
+
+	for(int i = 0; i < numEnvs; i++){
+		envs.push_back(ALEFactory::createALE(param, param->getSeed() + i));
+		if(features != NULL){
+			featureExtractors.push_back(features->clone());
+		}
+	}
+	//Get the number of effective actions:
+	if(param->isMinimalAction()){
+		actions = envs[0]->getMinimalActionSet();
+	}
+	else{
+		actions = envs[0]->getLegalActionSet();
+	}
+
+	rewards.assign(numEnvs, 0.0);
+	gameOvers.assign(numEnvs, 0);
+	currentReturns.assign(numEnvs, 0.0);
+	lastEpisodeReturns.assign(numEnvs, 0.0);
+	lastEpisodeFrames.assign(numEnvs, 0);
+	totalFrames.assign(numEnvs, 0);
+	numEpisodes.assign(numEnvs, 0);
+	activeFeatures.resize(numEnvs);
+	for(int i = 0; i < numEnvs; i++){
+		extractFeatures(i);
+	}
+}
+
+VecEnv::~VecEnv(){
+	for(unsigned int i = 0; i < envs.size(); i++){
+		delete envs[i];
+	}
+	for(unsigned int i = 0; i < featureExtractors.size(); i++){
+		delete featureExtractors[i];
+	}
+}
+
+void VecEnv::extractFeatures(int env){
+	if(!featureExtractors.empty()){
+		activeFeatures[env].clear();
+		featureExtractors[env]->getActiveFeaturesIndices(envs[env]->getScreen(), envs[env]->getRAM(), activeFeatures[env]);
+	}
+}
+
+void VecEnv::reset(){
+	pool.parallelFor(numEnvs, [&](int env, int worker){
+		envs[env]->reset_game();
+		rewards[env]        = 0.0;
+		gameOvers[env]      = 0;
+		currentReturns[env] = 0.0;
+		extractFeatures(env);
+	});
+}
+
+void VecEnv::step(const vector<int> &actionIndices){
+	assert((int) actionIndices.size() == numEnvs);
+	pool.parallelFor(numEnvs, [&](int env, int worker){
+		ALEInterface &ale = *envs[env];
+		int framesBefore = ale.getEpisodeFrameNumber();
+
+		rewards[env] = ale.act(actions[actionIndices[env]]);
+		currentReturns[env] += rewards[env];
+		totalFrames[env] += ale.getEpisodeFrameNumber() - framesBefore;
+		gameOvers[env] = ale.game_over();
+		//Auto-reset, so the instance is always ready to act:
+		if(gameOvers[env]){
+			lastEpisodeReturns[env] = currentReturns[env];
+			lastEpisodeFrames[env]  = ale.getEpisodeFrameNumber();
+			currentReturns[env]     = 0.0;
+			numEpisodes[env]++;
+			ale.reset_game();
+		}
+		extractFeatures(env);
+	});
+}
+
+int VecEnv::getNumEnvs(){
+	return numEnvs;
+}
+
+ActionVect& VecEnv::getActionSet(){
+	return actions;
+}
+
+const vector<double>& VecEnv::getRewards(){
+	return rewards;
+}
+
+const vector<int>& VecEnv::getGameOvers(){
+	return gameOvers;
+}
+
+const vector<int>& VecEnv::getActiveFeatures(int env){
+	return activeFeatures[env];
+}
+
+const ALEScreen& VecEnv::getScreen(int env){
+	return envs[env]->getScreen();
+}
+
+const ALERAM& VecEnv::getRAM(int env){
+	return envs[env]->getRAM();
+}
+
+double VecEnv::getLastEpisodeReturn(int env){
+	return lastEpisodeReturns[env];
+}
+
+int VecEnv::getLastEpisodeFrames(int env){
+	return lastEpisodeFrames[env];
+}
+
+int VecEnv::getNumEpisodes(int env){
+	return numEpisodes[env];
+}
+
+long long VecEnv::getTotalFrames(int env){
+	return totalFrames[env];
+}
+
+long long VecEnv::getTotalFrames(){
+	long long sum = 0;
+	for(int i = 0; i < numEnvs; i++){
+		sum += totalFrames[i];
+	}
+	return sum;
+}
+
+ALEInterface& VecEnv::getEnv(int env){
+	return *envs[env];
+}
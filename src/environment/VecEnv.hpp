@@ -0,0 +1,149 @@
+/****************************************************************************************
+** Vectorized environment: N instances of the Arcade Learning Environment stepped in
+** lockstep. At each step the caller gives one action per instance and the emulation of all
+** instances is run in parallel, by a persistent pool of threads. The rewards, game-over
+** flags, screens and RAMs of all instances can then be read by the caller, which may batch
+** the computation of Q-values (or anything else) over all instances.
+**
+** Instances that reach the end of an episode are automatically reset, so every instance
+** is always ready to act. The flag returned for that step tells the episode is over, and
+** the return and length of the episode that just finished are kept until the next one ends.
+**
+** Optionally, the active features of each instance are extracted in the same parallel step,
+** each instance using its own copy of the feature extractor.
+**
+** REMARKS: - Actions are indices in the action set of the game (minimal or legal, as defined
+**            by USE_MIN_ACTIONS), as the weights of the learners are indexed.
+**          - Instance i uses the seed passed in the command line plus i.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../common/Parameters.hpp"
+#endif
+#ifndef FEATURES_H
+#define FEATURES_H
+#include "../features/Features.hpp"
+#endif
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "../common/ThreadPool.hpp"
+#endif
+
+class VecEnv{
+	private:
+		int numEnvs;
+		ActionVect actions;
+
+		vector<ALEInterface*> envs;
+		vector<Features*> featureExtractors;     //One per instance, empty if features are not extracted
+		vector<vector<int> > activeFeatures;     //Features active in the current state of each instance
+		ThreadPool pool;
+
+		vector<double> rewards;                  //Reward observed by each instance in the last step
+		vector<int> gameOvers;                   //Whether the last step of each instance ended an episode
+		vector<double> currentReturns;           //Sum of rewards in the current episode of each instance
+		vector<double> lastEpisodeReturns;       //Return of the last episode finished by each instance
+		vector<int> lastEpisodeFrames;           //Length, in frames, of the last episode finished by each instance
+		vector<long long> totalFrames;           //Frames emulated by each instance since it was created
+		vector<int> numEpisodes;                 //Episodes finished by each instance
+
+		/**
+ 		* Constructor declared as private to force the user to inform the number of instances.
+ 		*/
+		VecEnv();
+		/**
+ 		* Extracts the features active in the current state of the given instance, if requested.
+ 		*/
+		void extractFeatures(int env);
+	public:
+		/**
+ 		* Constructor. It creates the emulators, all of them with the ROM informed in the command line.
+ 		*
+ 		* @param Parameters *param parameters read from the command line and config file
+ 		* @param int numEnvs number of instances to be stepped in lockstep
+ 		* @param int numThreads number of threads emulating the instances
+ 		* @param Features *features if not NULL, the active features of each instance are extracted
+ 		*        after each step, with a copy of this feature extractor per instance
+ 		*/
+		VecEnv(Parameters *param, int numEnvs, int numThreads, Features *features = NULL);
+		/**
+ 		* Destructor, it deletes the emulators and the copies of the feature extractor.
+ 		*/
+		~VecEnv();
+		/**
+ 		* Resets all instances to the beginning of an episode.
+ 		*/
+		void reset();
+		/**
+ 		* Acts in all instances at the same time, returning only when all of them are done. An
+ 		* instance whose episode is over is reset in the same step.
+ 		*
+ 		* @param vector<int>& actionIndices action to be taken in each instance, as an index in the
+ 		*        action set returned by getActionSet
+ 		*/
+		void step(const vector<int> &actionIndices);
+		/**
+ 		* @return int number of instances
+ 		*/
+		int getNumEnvs();
+		/**
+ 		* @return ActionVect& actions available, the same for all instances
+ 		*/
+		ActionVect& getActionSet();
+		/**
+ 		* @return vector<double>& reward observed by each instance in the last step
+ 		*/
+		const vector<double>& getRewards();
+		/**
+ 		* @return vector<int>& for each instance, 1 if its episode ended in the last step, in which
+ 		*         case the instance was already reset
+ 		*/
+		const vector<int>& getGameOvers();
+		/**
+ 		* @return vector<int>& features active in the current state of the given instance. It is only
+ 		*         filled if a feature extractor was given in the constructor.
+ 		*/
+		const vector<int>& getActiveFeatures(int env);
+		/**
+ 		* @return ALEScreen& current screen of the given instance
+ 		*/
+		const ALEScreen& getScreen(int env);
+		/**
+ 		* @return ALERAM& current RAM of the given instance
+ 		*/
+		const ALERAM& getRAM(int env);
+		/**
+ 		* @return double return of the last episode finished by the given instance
+ 		*/
+		double getLastEpisodeReturn(int env);
+		/**
+ 		* @return int length, in frames, of the last episode finished by the given instance
+ 		*/
+		int getLastEpisodeFrames(int env);
+		/**
+ 		* @return int number of episodes finished by the given instance
+ 		*/
+		int getNumEpisodes(int env);
+		/**
+ 		* @return long long frames emulated by the given instance
+ 		*/
+		long long getTotalFrames(int env);
+		/**
+ 		* @return long long frames emulated by all instances together
+ 		*/
+		long long getTotalFrames();
+		/**
+ 		* Direct access to an emulator, e.g. to clone its state. It must not be used while a step
+ 		* is running.
+ 		*
+ 		* @return ALEInterface& emulator of the given instance
+ 		*/
+		ALEInterface& getEnv(int env);
+};
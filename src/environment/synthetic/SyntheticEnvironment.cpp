@@ -0,0 +1,415 @@
+/****************************************************************************************
+** Implementation of the ROM-free stand-in for the Arcade Learning Environment. See
+** ale_interface.hpp in this directory for a description of the game being simulated.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include "ale_interface.hpp"
+#include <time.h>
+
+#define PLAYFIELD_TOP     16
+#define PLAYFIELD_BOTTOM 194
+#define PLAYER_SIZE        8
+#define COIN_SIZE          4
+#define ENEMY_SIZE         8
+#define PLAYER_SPEED       2
+
+#define PLAYER_COLOR    0x1E
+#define COIN_COLOR      0x3C
+#define ENEMY_COLOR     0x44
+
+static double monotonicSeconds(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return double(ts.tv_sec) + double(ts.tv_nsec)/1e9;
+}
+
+ALEState::ALEState(const string &serialized){
+	m_serialized = serialized;
+	std::istringstream in(serialized);
+	in >> m_frame_number >> m_episode_frame_number;
+}
+
+string ALEState::serialize(){
+	return m_serialized;
+}
+
+ALEInterface::ALEInterface() : screen(SYNTHETIC_SCREEN_HEIGHT, SYNTHETIC_SCREEN_WIDTH){
+	randomSeed             = 1;
+	maxNumFramesPerEpisode = 0;
+	frameSkip              = 1;
+	numCoins               = 3;
+	numEnemies             = 3;
+	spritePeriod           = 1;
+	coinReward             = 10;
+	numLives               = 3;
+	fps                    = 0;
+	frameNumber            = 0;
+	episodeFrameNumber     = 0;
+	livesLeft              = 0;
+	score                  = 0;
+	isTerminal             = true;
+	rngState               = 1;
+	nextFrameDeadline      = 0;
+	romName                = "synthetic";
+}
+
+ALEInterface::ALEInterface(bool display_screen) : ALEInterface(){}
+
+ALEInterface::~ALEInterface(){}
+
+int ALEInterface::getInt(const string& key){
+	if(key == "random_seed")                return randomSeed;
+	if(key == "max_num_frames_per_episode") return maxNumFramesPerEpisode;
+	if(key == "frame_skip")                 return frameSkip;
+	if(key == "synthetic_num_coins")        return numCoins;
+	if(key == "synthetic_num_enemies")      return numEnemies;
+	if(key == "synthetic_sprite_period")    return spritePeriod;
+	if(key == "synthetic_coin_reward")      return coinReward;
+	if(key == "synthetic_lives")            return numLives;
+	if(key == "synthetic_fps")              return int(fps);
+	return 0;
+}
+
+float ALEInterface::getFloat(const string& key){
+	return float(getInt(key));
+}
+
+bool ALEInterface::getBool(const string& key){
+	return getInt(key) != 0;
+}
+
+string ALEInterface::getString(const string& key){
+	if(key == "rom_file") return romName;
+	std::stringstream ss;
+	ss << getInt(key);
+	return ss.str();
+}
+
+void ALEInterface::setInt(const string& key, const int value){
+	if(key == "random_seed")                randomSeed = value;
+	if(key == "max_num_frames_per_episode") maxNumFramesPerEpisode = value;
+	if(key == "frame_skip")                 frameSkip = value > 0 ? value : 1;
+	if(key == "synthetic_num_coins")        numCoins = value;
+	if(key == "synthetic_num_enemies")      numEnemies = value;
+	if(key == "synthetic_sprite_period")    spritePeriod = value > 0 ? value : 1;
+	if(key == "synthetic_coin_reward")      coinReward = value;
+	if(key == "synthetic_lives")            numLives = value > 0 ? value : 1;
+	if(key == "synthetic_fps")              fps = value;
+}
+
+void ALEInterface::setFloat(const string& key, const float value){
+	//The only float the agents set is "stochasticity", which has no effect here:
+	//the synthetic game is deterministic given the seed.
+	setInt(key, int(nearbyint(value)));
+}
+
+void ALEInterface::setBool(const string& key, const bool value){
+	setInt(key, value);
+}
+
+void ALEInterface::setString(const string& key, const string& value){
+	setInt(key, atoi(value.c_str()));
+}
+
+void ALEInterface::loadROM(string rom_file){
+	//Only the name of the game matters, e.g. "../roms/pong.bin" becomes "pong":
+	size_t slash = rom_file.find_last_of("/");
+	romName = slash == string::npos ? rom_file : rom_file.substr(slash + 1);
+	romName = romName.substr(0, romName.find("."));
+	buildBackground();
+	reset_game();
+}
+
+uint64_t ALEInterface::nextRandom(){
+	//xorshift64*
+	rngState ^= rngState >> 12;
+	rngState ^= rngState << 25;
+	rngState ^= rngState >> 27;
+	return rngState * 2685821657736338717ULL;
+}
+
+int ALEInterface::randomInt(int n){
+	return int((nextRandom() >> 33) % (uint64_t) n);
+}
+
+void ALEInterface::buildBackground(){
+	//The background is a set of horizontal bands whose colors and heights
+	//depend on the name of the game, plus two static platforms:
+	uint64_t h = 1469598103934665603ULL;
+	for(unsigned int i = 0; i < romName.size(); i++){
+		h = (h ^ (unsigned char) romName[i]) * 1099511628211ULL;
+	}
+	background.assign(SYNTHETIC_SCREEN_HEIGHT * SYNTHETIC_SCREEN_WIDTH, 0);
+	int row = 0;
+	while(row < SYNTHETIC_SCREEN_HEIGHT){
+		h = h * 6364136223846793005ULL + 1442695040888963407ULL;
+		int bandHeight = 8 + int((h >> 40) % 40);
+		pixel_t color = pixel_t(((h >> 20) & 0x7F) << 1);
+		for(int r = row; r < row + bandHeight && r < SYNTHETIC_SCREEN_HEIGHT; r++){
+			for(int c = 0; c < SYNTHETIC_SCREEN_WIDTH; c++){
+				background[r * SYNTHETIC_SCREEN_WIDTH + c] = color;
+			}
+		}
+		row += bandHeight;
+	}
+	for(int p = 0; p < 2; p++){
+		h = h * 6364136223846793005ULL + 1442695040888963407ULL;
+		int r0 = PLAYFIELD_TOP + int((h >> 33) % (PLAYFIELD_BOTTOM - PLAYFIELD_TOP - 4));
+		int c0 = int((h >> 13) % (SYNTHETIC_SCREEN_WIDTH / 2));
+		for(int r = r0; r < r0 + 4; r++){
+			for(int c = c0; c < c0 + SYNTHETIC_SCREEN_WIDTH / 2; c++){
+				background[r * SYNTHETIC_SCREEN_WIDTH + c] = 0x0E;
+			}
+		}
+	}
+}
+
+void ALEInterface::spawn(Sprite &sprite){
+	int size = sprite.kind == 1 ? COIN_SIZE : ENEMY_SIZE;
+	sprite.x  = randomInt(SYNTHETIC_SCREEN_WIDTH - size);
+	sprite.y  = PLAYFIELD_TOP + randomInt(PLAYFIELD_BOTTOM - PLAYFIELD_TOP - size);
+	sprite.dx = randomInt(2) ? 1 + randomInt(2) : -1 - randomInt(2);
+	sprite.dy = randomInt(2) ? 1 + randomInt(2) : -1 - randomInt(2);
+	if(sprite.kind == 1){
+		sprite.dx = sprite.dx / 2;
+	}
+}
+
+void ALEInterface::reset_game(){
+	//Every episode starts from the same state, as in the deterministic ALE:
+	rngState = 0x9E3779B97F4A7C15ULL * (uint64_t)(randomSeed + 1);
+	rngState ^= rngState >> 31;
+	if(rngState == 0){
+		rngState = 1;
+	}
+	sprites.clear();
+	Sprite player;
+	player.kind  = 0;
+	player.color = PLAYER_COLOR;
+	player.x  = (SYNTHETIC_SCREEN_WIDTH - PLAYER_SIZE) / 2;
+	player.y  = (PLAYFIELD_TOP + PLAYFIELD_BOTTOM - PLAYER_SIZE) / 2;
+	player.dx = player.dy = 0;
+	sprites.push_back(player);
+	for(int i = 0; i < numCoins + numEnemies; i++){
+		Sprite sprite;
+		sprite.kind  = i < numCoins ? 1 : 2;
+		sprite.color = sprite.kind == 1 ? COIN_COLOR : ENEMY_COLOR;
+		spawn(sprite);
+		sprites.push_back(sprite);
+	}
+	livesLeft          = numLives;
+	score              = 0;
+	episodeFrameNumber = 0;
+	isTerminal         = false;
+	render();
+}
+
+void ALEInterface::step(Action action){
+	Sprite &player = sprites[0];
+	int dx = 0, dy = 0;
+	switch(action){
+		case PLAYER_A_UP:    case PLAYER_A_UPFIRE:    dy = -1; break;
+		case PLAYER_A_DOWN:  case PLAYER_A_DOWNFIRE:  dy =  1; break;
+		case PLAYER_A_LEFT:  case PLAYER_A_LEFTFIRE:  dx = -1; break;
+		case PLAYER_A_RIGHT: case PLAYER_A_RIGHTFIRE: dx =  1; break;
+		case PLAYER_A_UPRIGHT:   case PLAYER_A_UPRIGHTFIRE:   dx =  1; dy = -1; break;
+		case PLAYER_A_UPLEFT:    case PLAYER_A_UPLEFTFIRE:    dx = -1; dy = -1; break;
+		case PLAYER_A_DOWNRIGHT: case PLAYER_A_DOWNRIGHTFIRE: dx =  1; dy =  1; break;
+		case PLAYER_A_DOWNLEFT:  case PLAYER_A_DOWNLEFTFIRE:  dx = -1; dy =  1; break;
+		default: break;
+	}
+	player.x = std::min(std::max(player.x + PLAYER_SPEED * dx, 0), SYNTHETIC_SCREEN_WIDTH - PLAYER_SIZE);
+	player.y = std::min(std::max(player.y + PLAYER_SPEED * dy, PLAYFIELD_TOP), PLAYFIELD_BOTTOM - PLAYER_SIZE);
+
+	//Other sprites only move every spritePeriod frames, bouncing on the borders:
+	if(frameNumber % spritePeriod == 0){
+		for(unsigned int i = 1; i < sprites.size(); i++){
+			Sprite &s = sprites[i];
+			int size = s.kind == 1 ? COIN_SIZE : ENEMY_SIZE;
+			s.x += s.dx;
+			s.y += s.dy;
+			if(s.x < 0 || s.x > SYNTHETIC_SCREEN_WIDTH - size){
+				s.dx = -s.dx;
+				s.x += 2 * s.dx;
+			}
+			if(s.y < PLAYFIELD_TOP || s.y > PLAYFIELD_BOTTOM - size){
+				s.dy = -s.dy;
+				s.y += 2 * s.dy;
+			}
+		}
+	}
+}
+
+void ALEInterface::render(){
+	pixel_t *pixels = screen.getArray();
+	std::copy(background.begin(), background.end(), pixels);
+	for(unsigned int i = sprites.size(); i--;){
+		const Sprite &s = sprites[i];
+		int size = s.kind == 1 ? COIN_SIZE : (s.kind == 2 ? ENEMY_SIZE : PLAYER_SIZE);
+		for(int r = s.y; r < s.y + size; r++){
+			for(int c = s.x; c < s.x + size; c++){
+				pixels[r * SYNTHETIC_SCREEN_WIDTH + c] = s.color;
+			}
+		}
+	}
+	//Lives are drawn at the top of the screen, as most Atari games do:
+	for(int l = 0; l < livesLeft; l++){
+		for(int r = 4; r < 10; r++){
+			for(int c = 4 + 10 * l; c < 10 + 10 * l; c++){
+				pixels[r * SYNTHETIC_SCREEN_WIDTH + c] = PLAYER_COLOR;
+			}
+		}
+	}
+
+	byte_t *mem = ram.array();
+	for(int i = 0; i < RAM_SIZE; i++){
+		mem[i] = 0;
+	}
+	mem[0] = byte_t(livesLeft);
+	mem[1] = byte_t(score & 0xFF);
+	mem[2] = byte_t((score >> 8) & 0xFF);
+	mem[3] = byte_t(episodeFrameNumber & 0xFF);
+	for(unsigned int i = 0; i < sprites.size() && 8 + 2 * i + 1 < RAM_SIZE; i++){
+		mem[8 + 2 * i]     = byte_t(sprites[i].x);
+		mem[8 + 2 * i + 1] = byte_t(sprites[i].y);
+	}
+}
+
+void ALEInterface::throttle(){
+	if(fps <= 0){
+		return;
+	}
+	double now = monotonicSeconds();
+	if(nextFrameDeadline < now){
+		nextFrameDeadline = now;
+	}
+	nextFrameDeadline += 1.0 / fps;
+	while(monotonicSeconds() < nextFrameDeadline){
+		//Busy waiting, as the real emulator would be using the CPU.
+	}
+}
+
+reward_t ALEInterface::act(Action action){
+	reward_t reward = 0;
+	for(int f = 0; f < frameSkip && !isTerminal; f++){
+		step(action);
+		Sprite &player = sprites[0];
+		for(unsigned int i = 1; i < sprites.size(); i++){
+			Sprite &s = sprites[i];
+			int size = s.kind == 1 ? COIN_SIZE : ENEMY_SIZE;
+			bool overlap = player.x < s.x + size && s.x < player.x + PLAYER_SIZE
+						&& player.y < s.y + size && s.y < player.y + PLAYER_SIZE;
+			if(!overlap){
+				continue;
+			}
+			if(s.kind == 1){
+				reward += coinReward;
+				score  += coinReward;
+				spawn(s);
+			}
+			else{
+				livesLeft--;
+				player.x = (SYNTHETIC_SCREEN_WIDTH - PLAYER_SIZE) / 2;
+				player.y = (PLAYFIELD_TOP + PLAYFIELD_BOTTOM - PLAYER_SIZE) / 2;
+				spawn(s);
+				break;
+			}
+		}
+		frameNumber++;
+		episodeFrameNumber++;
+		throttle();
+		if(livesLeft <= 0 || (maxNumFramesPerEpisode > 0 && episodeFrameNumber >= maxNumFramesPerEpisode)){
+			isTerminal = true;
+		}
+	}
+	render();
+	return reward;
+}
+
+bool ALEInterface::game_over() const{
+	return isTerminal;
+}
+
+int ALEInterface::lives() const{
+	return livesLeft;
+}
+
+ActionVect ALEInterface::getLegalActionSet(){
+	ActionVect actions;
+	for(int a = 0; a < PLAYER_A_MAX; a++){
+		actions.push_back((Action) a);
+	}
+	return actions;
+}
+
+ActionVect ALEInterface::getMinimalActionSet(){
+	ActionVect actions;
+	for(int a = PLAYER_A_NOOP; a <= PLAYER_A_DOWNLEFT; a++){
+		actions.push_back((Action) a);
+	}
+	return actions;
+}
+
+int ALEInterface::getFrameNumber() const{
+	return frameNumber;
+}
+
+int ALEInterface::getEpisodeFrameNumber() const{
+	return episodeFrameNumber;
+}
+
+const ALEScreen &ALEInterface::getScreen(){
+	return screen;
+}
+
+const ALERAM &ALEInterface::getRAM(){
+	return ram;
+}
+
+string ALEInterface::serializeGame() const{
+	std::ostringstream out;
+	out << frameNumber << " " << episodeFrameNumber << " " << rngState << " " << livesLeft << " "
+		<< score << " " << isTerminal << " " << sprites.size();
+	for(unsigned int i = 0; i < sprites.size(); i++){
+		const Sprite &s = sprites[i];
+		out << " " << s.x << " " << s.y << " " << s.dx << " " << s.dy << " " << s.kind << " " << int(s.color);
+	}
+	return out.str();
+}
+
+void ALEInterface::deserializeGame(const string &serialized){
+	std::istringstream in(serialized);
+	unsigned int numSprites;
+	in >> frameNumber >> episodeFrameNumber >> rngState >> livesLeft >> score >> isTerminal >> numSprites;
+	sprites.resize(numSprites);
+	for(unsigned int i = 0; i < numSprites; i++){
+		Sprite &s = sprites[i];
+		int color;
+		in >> s.x >> s.y >> s.dx >> s.dy >> s.kind >> color;
+		s.color = pixel_t(color);
+	}
+	render();
+}
+
+ALEState ALEInterface::cloneState(){
+	return ALEState(serializeGame());
+}
+
+void ALEInterface::restoreState(const ALEState& state){
+	//As in the real ALE, the global frame counter is not rewound:
+	int currentFrameNumber = frameNumber;
+	deserializeGame(state.m_serialized);
+	frameNumber = currentFrameNumber;
+}
+
+ALEState ALEInterface::cloneSystemState(){
+	return cloneState();
+}
+
+void ALEInterface::restoreSystemState(const ALEState& state){
+	deserializeGame(state.m_serialized);
+}
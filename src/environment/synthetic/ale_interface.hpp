@@ -0,0 +1,197 @@
+/****************************************************************************************
+** ROM-free stand-in for the Arcade Learning Environment. It implements the subset of the
+** ALEInterface surface used by the agents, features and tools in this repository (act,
+** getScreen, getRAM, game_over, reset_game, action sets, frame counters and state
+** cloning), so everything can be compiled, run and benchmarked without the emulator or
+** any proprietary ROM. It is selected at build time with SYNTHETIC=1 in the Makefiles,
+** which puts this directory in the include path instead of the real ALE.
+**
+** The game is procedural: a set of sprites moves over a static background. The player
+** sprite is controlled by the joystick, touching a coin gives reward, touching an enemy
+** costs a life. Everything is driven by a seeded generator, so runs are deterministic.
+**
+** The dynamics can be tuned with setInt/setFloat, as one would do with the real ALE. The
+** frame rate, the reward and the sprite period are set from SYNTHETIC_FPS, SYNTHETIC_REWARD
+** and SYNTHETIC_SPRITE_PERIOD in the config file:
+**   - synthetic_num_coins / synthetic_num_enemies: number of sprites of each kind;
+**   - synthetic_sprite_period: number of frames between two movements of the sprites;
+**   - synthetic_coin_reward: reward given when a coin is collected;
+**   - synthetic_lives: number of lives at the beginning of an episode;
+**   - synthetic_fps: if larger than zero, act() is throttled to this frame rate, which
+**     is useful to mimic the cost of the real emulator when benchmarking.
+**
+** REMARKS: - The name of the ROM passed to loadROM is only used to define the background,
+**            so different "games" look different. The file does not need to exist.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef SYNTHETIC_ALE_INTERFACE_HPP
+#define SYNTHETIC_ALE_INTERFACE_HPP
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <stdint.h>
+
+using namespace std;
+
+#define SYNTHETIC_SCREEN_HEIGHT 210
+#define SYNTHETIC_SCREEN_WIDTH  160
+#define RAM_SIZE                128
+
+typedef unsigned char pixel_t;
+typedef unsigned char byte_t;
+typedef int reward_t;
+
+enum Action{
+	PLAYER_A_NOOP           = 0,
+	PLAYER_A_FIRE           = 1,
+	PLAYER_A_UP             = 2,
+	PLAYER_A_RIGHT          = 3,
+	PLAYER_A_LEFT           = 4,
+	PLAYER_A_DOWN           = 5,
+	PLAYER_A_UPRIGHT        = 6,
+	PLAYER_A_UPLEFT         = 7,
+	PLAYER_A_DOWNRIGHT      = 8,
+	PLAYER_A_DOWNLEFT       = 9,
+	PLAYER_A_UPFIRE         = 10,
+	PLAYER_A_RIGHTFIRE      = 11,
+	PLAYER_A_LEFTFIRE       = 12,
+	PLAYER_A_DOWNFIRE       = 13,
+	PLAYER_A_UPRIGHTFIRE    = 14,
+	PLAYER_A_UPLEFTFIRE     = 15,
+	PLAYER_A_DOWNRIGHTFIRE  = 16,
+	PLAYER_A_DOWNLEFTFIRE   = 17,
+	RESET                   = 40,
+	UNDEFINED               = 41,
+	LAST_ACTION_INDEX       = 50
+};
+
+#define PLAYER_A_MAX (18)
+
+typedef vector<Action> ActionVect;
+
+class ALEScreen{
+	private:
+		int m_rows, m_columns;
+		vector<pixel_t> m_pixels;
+	public:
+		ALEScreen(int h, int w) : m_rows(h), m_columns(w), m_pixels(h * w, 0) {}
+		pixel_t get(int r, int c) const { return m_pixels[r * m_columns + c]; }
+		pixel_t *getRow(int r) const { return const_cast<pixel_t*>(&m_pixels[r * m_columns]); }
+		pixel_t *getArray() const { return const_cast<pixel_t*>(&m_pixels[0]); }
+		size_t height() const { return m_rows; }
+		size_t width() const { return m_columns; }
+		size_t arraySize() const { return m_rows * m_columns; }
+		bool equals(const ALEScreen &rhs) const { return m_pixels == rhs.m_pixels; }
+};
+
+class ALERAM{
+	private:
+		byte_t m_ram[RAM_SIZE];
+	public:
+		ALERAM(){ for(int i = 0; i < RAM_SIZE; i++){ m_ram[i] = 0; } }
+		byte_t get(unsigned int x) const { return m_ram[x & 0x7F]; }
+		byte_t *byte(unsigned int x) { return &m_ram[x & 0x7F]; }
+		byte_t *array() const { return const_cast<byte_t*>(m_ram); }
+		size_t size() const { return RAM_SIZE; }
+		bool equals(const ALERAM &rhs) const {
+			for(int i = 0; i < RAM_SIZE; i++){ if(m_ram[i] != rhs.m_ram[i]) return false; }
+			return true;
+		}
+};
+
+/**
+* Opaque snapshot of the synthetic game, the counterpart of ALE's ALEState. It can be
+* serialized to a string and rebuilt from it, as in the real ALE.
+*/
+class ALEState{
+	private:
+		string m_serialized;
+		int m_frame_number, m_episode_frame_number;
+		friend class ALEInterface;
+	public:
+		ALEState() : m_frame_number(0), m_episode_frame_number(0) {}
+		ALEState(const string &serialized);
+		string serialize();
+		int getFrameNumber() const { return m_frame_number; }
+		int getEpisodeFrameNumber() const { return m_episode_frame_number; }
+		bool equals(ALEState &state) { return m_serialized == state.m_serialized; }
+};
+
+class ALEInterface{
+	private:
+		struct Sprite{
+			int x, y, dx, dy;
+			int kind;   //0: player, 1: coin, 2: enemy
+			pixel_t color;
+		};
+
+		//Settings:
+		int randomSeed, maxNumFramesPerEpisode, frameSkip;
+		int numCoins, numEnemies, spritePeriod, coinReward, numLives;
+		double fps;
+		string romName;
+		//Game state:
+		uint64_t rngState;
+		vector<Sprite> sprites;
+		int livesLeft, score, frameNumber, episodeFrameNumber;
+		bool isTerminal;
+		//Observations:
+		vector<pixel_t> background;
+		ALEScreen screen;
+		ALERAM ram;
+		double nextFrameDeadline;
+
+		uint64_t nextRandom();
+		int randomInt(int n);
+		void buildBackground();
+		void spawn(Sprite &sprite);
+		void step(Action action);
+		void render();
+		void throttle();
+		string serializeGame() const;
+		void deserializeGame(const string &serialized);
+	public:
+		ALEInterface();
+		ALEInterface(bool display_screen);
+		~ALEInterface();
+
+		int getInt(const string& key);
+		float getFloat(const string& key);
+		bool getBool(const string& key);
+		string getString(const string& key);
+		void setInt(const string& key, const int value);
+		void setFloat(const string& key, const float value);
+		void setBool(const string& key, const bool value);
+		void setString(const string& key, const string& value);
+
+		void loadROM(string rom_file);
+		reward_t act(Action action);
+		bool game_over() const;
+		void reset_game();
+		int lives() const;
+
+		ActionVect getLegalActionSet();
+		ActionVect getMinimalActionSet();
+		int getFrameNumber() const;
+		int getEpisodeFrameNumber() const;
+
+		const ALEScreen &getScreen();
+		const ALERAM &getRAM();
+
+		ALEState cloneState();
+		void restoreState(const ALEState& state);
+		ALEState cloneSystemState();
+		void restoreSystemState(const ALEState& state);
+};
+
+#endif
@@ -16,15 +16,16 @@
 #include "BASSFeatures.hpp"
 #endif
 
-#include "BasicFeatures.hpp"
-
 BASSFeatures::BASSFeatures(Parameters *param){
     this->param = param;
+    basic = new BasicFeatures(param);
     numPureFeatures = this->param->getNumColumns() * this->param->getNumRows() * this->param->getNumColors();
     numPairwiseFeatures = numPureFeatures * (numPureFeatures -1) / 2;
 }
 
-BASSFeatures::~BASSFeatures(){}
+BASSFeatures::~BASSFeatures(){
+    delete basic;
+}
 
 void BASSFeatures::addPairwiseFeatures(vector<int>& features, int size){
     assert(size > 0);
@@ -34,8 +35,10 @@ void BASSFeatures::addPairwiseFeatures(vector<int>& features, int size){
     coordinate = size + row*size + column - (row +1)(1 + row + 1)/2
     The intuition is: index a matrix as a vector and subtract the number of terms
     you skip, which is the sum of terms of an arithmetic progression.*/
-    for(unsigned int i = 0; i < features.size(); i++){
-        for(unsigned int j = i + 1; j < features.size(); j++){
+    //The pairs are appended to the same vector, so only the Basic features are iterated over:
+    unsigned int numBasicActive = features.size();
+    for(unsigned int i = 0; i < numBasicActive; i++){
+        for(unsigned int j = i + 1; j < numBasicActive; j++){
             //First indexing as a vectorization of a matrix:
             offset = size * features[i] + features[j];
             //But only has elements in the diagonal, it makes 
@@ -48,12 +51,11 @@ void BASSFeatures::addPairwiseFeatures(vector<int>& features, int size){
 
 void BASSFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALERAM &ram, vector<int>& features){
     //First get the Basic Features for 8 colors:
-    BasicFeatures basic(this->param);
-    basic.getActiveFeaturesIndices(screen, ram, features);
+    basic->getActiveFeaturesIndices(screen, ram, features);
     //Remove bias to be added at the end:
     features.pop_back();
     //Now obtain its pairwise combinations: 
-    addPairwiseFeatures(features, basic.getNumberOfFeatures());
+    addPairwiseFeatures(features, basic->getNumberOfFeatures());
     //Bias:
     features.push_back(numPureFeatures + numPairwiseFeatures);
 
@@ -62,3 +64,7 @@ void BASSFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALERA
 int BASSFeatures::getNumberOfFeatures(){
     return numPureFeatures + numPairwiseFeatures + 1;
 }
+
+Features* BASSFeatures::clone(){
+    return new BASSFeatures(this->param);
+}
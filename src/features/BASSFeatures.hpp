@@ -19,10 +19,15 @@
 #define FEATURES_H
 #include "Features.hpp"
 #endif
+#ifndef BASIC_FEATURES_H
+#define BASIC_FEATURES_H
+#include "BasicFeatures.hpp"
+#endif
 
 class BASSFeatures : public Features::Features{
 	private:
 		Parameters *param;
+		BasicFeatures *basic;     //Extracts the Basic features, which are then combined
 		int numPureFeatures;
     	int numPairwiseFeatures;
 		/**
@@ -39,7 +44,7 @@ class BASSFeatures : public Features::Features{
 
 	public:
 		/**
-		* Destructor, not necessary in this class.
+		* Destructor, used to delete the Basic feature extractor, which is allocated dynamically.
 		*/
 		~BASSFeatures();
 		/**
@@ -82,4 +87,11 @@ class BASSFeatures : public Features::Features{
  		* @return int number of features generated by this method.
  		*/
 		int getNumberOfFeatures();
+		/**
+ 		* Creates a new BASSFeatures object with the same parameters as this one.
+ 		*
+ 		* @param none.
+ 		* @return Features* new feature extractor, to be deleted by the caller.
+ 		*/
+		Features* clone();
 };
@@ -19,7 +19,7 @@
 
 #include <set>
 #include <assert.h>
-#include <boost/tuple/tuple.hpp> //TODO: I have to remove this to not have to depend on boost
+#include <algorithm>
 
 BPROFeatures::BPROFeatures(Parameters *param){
     this->param = param;
@@ -28,7 +28,7 @@ BPROFeatures::BPROFeatures(Parameters *param){
 	numColors   = param->getNumColors();
 
 	if(this->param->getSubtractBackground()){
-        this->background = new Background(param);
+        this->background = Background::load(param);
     }
 
 	//To get the total number of features:
@@ -36,6 +36,18 @@ BPROFeatures::BPROFeatures(Parameters *param){
     numBasicFeatures = this->param->getNumColumns() * this->param->getNumRows() * this->param->getNumColors();
 	numRelativeFeatures = (2 * this->param->getNumColumns() - 1) * (2 * this->param->getNumRows() - 1) 
 							* this->param->getNumColors() * this->param->getNumColors();
+
+	int numOffsets = (2 * numRows - 1) * (2 * numColumns - 1);
+	whichColors.resize(numColumns, vector<vector<int> >(numRows));
+	//A tile has at most numColors colors, so the lists of colors never grow while extracting:
+	for(int bx = 0; bx < numColumns; bx++){
+		for(int by = 0; by < numRows; by++){
+			whichColors[bx][by].reserve(numColors);
+		}
+	}
+	hasColor.resize(numColors, false);
+	colorPairSeen.resize(numColors * numColors, false);
+	colorOffsets.resize(numOffsets, vector<bool>(numColors * numColors, false));
 }
 
 BPROFeatures::~BPROFeatures(){}
@@ -46,11 +58,10 @@ int BPROFeatures::getBasicFeaturesIndices(const ALEScreen &screen, int blockWidt
 	// For each pixel block
 	for (int by = 0; by < numRows; by++) {
 		for (int bx = 0; bx < numColumns; bx++) {
-			vector<boost::tuple<int, int, int> > posAndColor;
-			
 			int xo = bx * blockWidth;
 			int yo = by * blockHeight;
-			vector<bool> hasColor(numColors, false);
+			std::fill(hasColor.begin(), hasColor.end(), false);
+			whichColors[bx][by].clear();
 			
 			// Determine which colors are present
 			for (int x = xo; x < xo + blockWidth; x++){
@@ -66,7 +77,6 @@ int BPROFeatures::getBasicFeaturesIndices(const ALEScreen &screen, int blockWidt
 						}
 		  				
 		  				hasColor[pixel] = true;
-						posAndColor.push_back(boost::make_tuple(x, y, pixel));
 					}
 				}
 			}
@@ -91,12 +101,7 @@ void BPROFeatures::addRelativeFeaturesIndices(const ALEScreen &screen, int featu
 	int numOffsets = numRowOffsets*numColumnOffsets;
 	int numColorPairs = numColors*numColors;
 
-	vector<bool> colorPairSeen(numColorPairs, false);
-
-	vector<vector<bool> > colorOffsets(numOffsets, vector<bool>(numColorPairs, false));
-	vector<vector<bool> > rowOffsets(numRowOffsets, vector<bool>(numColorPairs, false));
-	vector<vector<bool> > columnOffsets(numColumnOffsets, vector<bool>(numColorPairs, false));
-	vector<vector<bool> > quadrantOffsets(8, vector<bool>(numColorPairs, false));
+	//colorPairSeen and colorOffsets are all false here, the entries set are cleared when read below
 	for(int bx = numColumns; bx--;){
 		for(int by = numRows; by--;){
 			for(int offX = numColumns; offX--;){
@@ -114,32 +119,6 @@ void BPROFeatures::addRelativeFeaturesIndices(const ALEScreen &screen, int featu
 							colorPairSeen[colorPair] = true;
 
 							colorOffsets[offset][colorPair] = true;
-							rowOffsets[yOff][colorPair] = true;
-							columnOffsets[xOff][colorPair] = true;
-							if(offX - bx > 0){
-								quadrantOffsets[0][colorPair] = true;
-								if(offY - by > 0){
-			     					quadrantOffsets[1][colorPair] = true;
-			   					}
-								else if(offY - by < 0){
-									quadrantOffsets[2][colorPair] = true;
-								}
-							}
-							else if(offX - bx < 0){
-								quadrantOffsets[3][colorPair] = true;
-								if(offY - by > 0){
-									quadrantOffsets[4][colorPair] = true;
-								}
-								else if(offY - by < 0){
-									quadrantOffsets[5][colorPair] = true;
-								}
-							}
-							if(offY - by > 0){
-								quadrantOffsets[6][colorPair] = true;
-							}
-							else if(offY - by < 0){
-								quadrantOffsets[7][colorPair] = true;
-							}
 						}
 					}
 				}
@@ -147,10 +126,11 @@ void BPROFeatures::addRelativeFeaturesIndices(const ALEScreen &screen, int featu
 		}
 	}
 
-	vector<int> seenColorPairs;
+	seenColorPairs.clear();
 	for(int i = 0; i < numColorPairs; i++){
 		if(colorPairSeen[i]){
 			seenColorPairs.push_back(i);
+			colorPairSeen[i] = false;
 		}
 	}
 
@@ -159,6 +139,7 @@ void BPROFeatures::addRelativeFeaturesIndices(const ALEScreen &screen, int featu
 			int colorPair = seenColorPairs[i];
 			if(colorOffsets[o][colorPair]){
 				features.push_back(featureIndex + colorPair);
+				colorOffsets[o][colorPair] = false;
 			}
 		}
 		featureIndex += numColorPairs;
@@ -172,7 +153,6 @@ void BPROFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALERA
 	int blockHeight = screenHeight / numRows;
 
 	assert(features.size() == 0); //If the vector is not empty this can be a mess
-	vector<vector<vector<int> > > whichColors(numColumns, vector<vector<int> >(numRows));
 
     //Before generating features we must check whether we can subtract the background:
     if(this->param->getSubtractBackground()){
@@ -191,4 +171,8 @@ void BPROFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALERA
 
 int BPROFeatures::getNumberOfFeatures(){
     return numBasicFeatures + numRelativeFeatures + 1;
+}
+
+Features* BPROFeatures::clone(){
+    return new BPROFeatures(this->param);
 }
\ No newline at end of file
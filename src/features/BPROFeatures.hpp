@@ -20,19 +20,25 @@
 class BPROFeatures : public Features::Features{
 	private:
 		Parameters *param;
-		Background *background;
+		std::shared_ptr<Background> background; //Shared by all extractors using the same file
 		
 		int numBasicFeatures;
     	int numRelativeFeatures;
     	int rowLess0Shift, row0Shift, rowMore0Shift;
         int numColumns, numRows, numColors;
+        //Buffers reused at every call, so features are extracted without allocating memory:
+        vector<vector<vector<int> > > whichColors;  //Colors present in each tile
+        vector<bool> hasColor;                      //Colors present in the current tile
+        vector<bool> colorPairSeen;                 //Pairs of colors present in any two tiles
+        vector<int> seenColorPairs;                 //Indices of the pairs set in colorPairSeen
+        vector<vector<bool> > colorOffsets;         //Pairs of colors present at each offset
         int getBasicFeaturesIndices(const ALEScreen &screen, int blockWidth, int blockHeight, 
         							vector<vector<vector<int> > > &whichColors, vector<int>& features);
 		void addRelativeFeaturesIndices(const ALEScreen &screen, int featureIndex,
 									vector<vector<vector<int> > > &whichColors, vector<int>& features);
 	public:
 		/**
-		* Destructor, used to delete the background, which is allocated dynamically.
+		* Destructor, not necessary in this class: the background is shared and released by its last user.
 		*/
 		~BPROFeatures();
 		/**
@@ -72,4 +78,11 @@ class BPROFeatures : public Features::Features{
  		* @return int number of features generated by this method.
  		*/
 		int getNumberOfFeatures();
+		/**
+ 		* Creates a new BPROFeatures object with the same parameters as this one.
+ 		*
+ 		* @param none.
+ 		* @return Features* new feature extractor, to be deleted by the caller.
+ 		*/
+		Features* clone();
 };
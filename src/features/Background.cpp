@@ -10,6 +10,8 @@
 #endif
 #include <fstream>
 #include <stdlib.h>
+#include <map>
+#include <mutex>
 
 Background::Background(){}
 
@@ -59,6 +61,20 @@ Background::Background(Parameters *param){
 	}
 }
 
+std::shared_ptr<Background> Background::load(Parameters *param){
+	static std::mutex mutex;
+	static std::map<std::string, std::weak_ptr<Background> > loaded;
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::weak_ptr<Background> &cached = loaded[param->getPathToBackground()];
+	std::shared_ptr<Background> background = cached.lock();
+	if(!background){
+		background = std::make_shared<Background>(param);
+		cached = background;
+	}
+	return background;
+}
+
 int Background::getPixel(int x, int y){
 	return this->background[x][y];
 }
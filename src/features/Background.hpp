@@ -2,6 +2,10 @@
 ** This class is used to store the background, which may be subtracted from screen to
 ** generate features. This approach was suggested in the JAIR paper and drastically
 ** reduces the number of features in the problem.
+**
+** A background is only read once per file: the feature extractors obtain it with load,
+** so all of them (e.g. the copies used by parallel workers, or the runs of a sweep) share
+** the same object, which is only read after being created.
 ** 
 ** Author: Marlos C. Machado
 ***************************************************************************************/
@@ -10,6 +14,7 @@
 #define PARAMETERS_H
 #include "../common/Parameters.hpp"
 #endif
+#include <memory>
 
 class Background{
 	private:
@@ -34,6 +39,16 @@ class Background{
 		*/
 		~Background();
 		/**
+		* Returns the background of the file informed in the parameters. The file is only read if
+		* no other object is using its background, otherwise the same object is returned. It can be
+		* called by several threads at the same time.
+		*
+		* @param Parameters param contains the path to the background file
+		*
+		* @return std::shared_ptr<Background> background, deleted when nobody uses it anymore
+		*/
+		static std::shared_ptr<Background> load(Parameters *param);
+		/**
 		* Method used to retrieve a pixel from the background.
 		* 
 		* TODO: Make it return an unsigned char, it is more efficient.
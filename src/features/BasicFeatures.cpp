@@ -14,37 +14,26 @@
 #define BASIC_FEATURES_H
 #include "BasicFeatures.hpp"
 #endif
+#include <algorithm>
 
 BasicFeatures::BasicFeatures(Parameters *param){
     this->param = param;
     numberOfFeatures = this->param->getNumColumns() * this->param->getNumRows() * this->param->getNumColors();
+    hasColor.resize(this->param->getNumColors());
 
     if(this->param->getSubtractBackground()){
-        this->background = new Background(param);
+        this->background = Background::load(param);
     }
 }
 
-BasicFeatures::~BasicFeatures(){
-    if(this->param->getSubtractBackground()){
-        delete this->background;
-    }
-}
+BasicFeatures::~BasicFeatures(){}
 
 /* This method was adapted from Sriram Srinivasan's code */
 void BasicFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALERAM &ram, vector<int>& features){
-    vector<vector<int> > img;
-    
-    for(unsigned int i = 0; i < screen.height(); i++){
-        img.push_back(vector<int>(screen.width(), 0));
-        for(unsigned int j = 0; j < screen.width(); j++){
-            img[i][j] = screen.get(i,j);
-        }
-    }
-
     assert(features.size() == 0); //If the vector is not empty this can be a mess
 
-    int screenHeight = img.size();
-    int screenWidth  = img[0].size();
+    int screenHeight = screen.height();
+    int screenWidth  = screen.width();
     //The width and height of the screen are expanded to avoid mistakes due to boundaries:
     int expandedHeight = screenHeight % this->param->getNumRows() ? 
         this->param->getNumRows() * (screenHeight / this->param->getNumRows() + 1) : screenHeight;
@@ -66,7 +55,7 @@ void BasicFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALER
         int firstPositionRow =  r      * numColumnPixelsInTile;
         int lastPositionRow  = (r + 1) * numColumnPixelsInTile;
         for(int c = 0; c < this->param->getNumColumns(); c++){
-            vector<bool> hasColor(this->param->getNumColors(), false); //It is a bool vector because these features are binaries
+            std::fill(hasColor.begin(), hasColor.end(), false); //It is a bool vector because these features are binaries
             int firstPositionCol =  c      * numRowPixelsInTile;
             int lastPositionCol  = (c + 1) * numRowPixelsInTile;
             //Now that we know the limits for the tile we iterate over all
@@ -74,7 +63,7 @@ void BasicFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALER
             for(int x = firstPositionCol; x < lastPositionCol; x++){
                 for(int y = firstPositionRow; y < lastPositionRow; y++){
                     if(x < screenWidth && y < screenHeight){
-                        unsigned char pixel = img[y][x];
+                        unsigned char pixel = screen.get(y, x);
                         if(this->param->getNumColors() <= 9){ //SECAM, considering only 8 colors
                             if(!this->param->getSubtractBackground() || (this->background->getPixel(y, x) >> 4) != (int) (pixel >> 4)){
                                 hasColor[(pixel) >> 4] = true;
@@ -106,3 +95,7 @@ void BasicFeatures::getActiveFeaturesIndices(const ALEScreen &screen, const ALER
 int BasicFeatures::getNumberOfFeatures(){
     return numberOfFeatures + 1;
 }
+
+Features* BasicFeatures::clone(){
+    return new BasicFeatures(this->param);
+}
@@ -22,12 +22,13 @@
 class BasicFeatures : public Features::Features{
 	private:
 		Parameters *param;
-		Background *background;
+		std::shared_ptr<Background> background; //Shared by all extractors using the same file
 
 		int numberOfFeatures;
+		vector<bool> hasColor;    //Colors present in the current tile, kept to not be allocated at every call
 	public:
 		/**
-		* Destructor, used to delete the background, which is allocated dynamically.
+		* Destructor, not necessary in this class: the background is shared and released by its last user.
 		*/
 		~BasicFeatures();
 		/**
@@ -69,4 +70,11 @@ class BasicFeatures : public Features::Features{
  		* @return int number of features generated by this method.
  		*/
 		int getNumberOfFeatures();
+		/**
+ 		* Creates a new BasicFeatures object with the same parameters as this one.
+ 		*
+ 		* @param none.
+ 		* @return Features* new feature extractor, to be deleted by the caller.
+ 		*/
+		Features* clone();
 };
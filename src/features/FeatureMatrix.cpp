@@ -0,0 +1,91 @@
+/****************************************************************************************
+** Sparse matrix with the indices of the active features of a sequence of frames.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef FEATURE_MATRIX_H
+#define FEATURE_MATRIX_H
+#include "FeatureMatrix.hpp"
+#endif
+
+FeatureMatrixWriter::FeatureMatrixWriter(const std::string &path, int numFeatures){
+	memset(&header, 0, sizeof(FeatureMatrixHeader));
+	memcpy(header.magic, FEATURE_MATRIX_MAGIC, 4);
+	header.version = FEATURE_MATRIX_VERSION;
+	header.numColumns = numFeatures;
+	indptr.push_back(0);
+
+	file = fopen(path.c_str(), "wb");
+	if(file == NULL){
+		printf("Unable to open the file '%s' to be written.\n", path.c_str());
+		return;
+	}
+	//The header is written again when the file is closed, with the final sizes:
+	fwrite(&header, sizeof(FeatureMatrixHeader), 1, file);
+}
+
+FeatureMatrixWriter::~FeatureMatrixWriter(){
+	close();
+}
+
+bool FeatureMatrixWriter::isOpen(){
+	return file != NULL;
+}
+
+void FeatureMatrixWriter::addRow(const std::vector<int> &features, int action, int reward){
+	if(file == NULL){
+		return;
+	}
+	if(!features.empty()){
+		fwrite(&features[0], sizeof(int32_t), features.size(), file);
+	}
+	header.numNonZeros += features.size();
+	indptr.push_back(header.numNonZeros);
+	actions.push_back(action);
+	rewards.push_back(reward);
+}
+
+void FeatureMatrixWriter::close(){
+	if(file == NULL){
+		return;
+	}
+	header.numRows = actions.size();
+	header.indptrOffset = sizeof(FeatureMatrixHeader) + header.numNonZeros * sizeof(int32_t);
+	fwrite(&indptr[0], sizeof(uint64_t), indptr.size(), file);
+	if(!actions.empty()){
+		fwrite(&actions[0], sizeof(int32_t), actions.size(), file);
+		fwrite(&rewards[0], sizeof(int32_t), rewards.size(), file);
+	}
+	fseek(file, 0, SEEK_SET);
+	fwrite(&header, sizeof(FeatureMatrixHeader), 1, file);
+	fclose(file);
+	file = NULL;
+}
+
+bool FeatureMatrix::read(const std::string &path){
+	FILE *file = fopen(path.c_str(), "rb");
+	if(file == NULL){
+		return false;
+	}
+	FeatureMatrixHeader header;
+	if(fread(&header, sizeof(FeatureMatrixHeader), 1, file) != 1 || memcmp(header.magic, FEATURE_MATRIX_MAGIC, 4) != 0
+		|| header.version != FEATURE_MATRIX_VERSION){
+		fclose(file);
+		return false;
+	}
+	numColumns = header.numColumns;
+	indices.resize(header.numNonZeros);
+	indptr.resize(header.numRows + 1);
+	actions.resize(header.numRows);
+	rewards.resize(header.numRows);
+	//Empty arrays are skipped, indptr always has at least one element:
+	bool isComplete = (header.numNonZeros == 0 || fread(&indices[0], sizeof(int32_t), indices.size(), file) == indices.size())
+		&& fread(&indptr[0], sizeof(uint64_t), indptr.size(), file) == indptr.size()
+		&& (header.numRows == 0 || (fread(&actions[0], sizeof(int32_t), actions.size(), file) == actions.size()
+		&& fread(&rewards[0], sizeof(int32_t), rewards.size(), file) == rewards.size()));
+	fclose(file);
+	return isComplete;
+}
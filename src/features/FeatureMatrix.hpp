@@ -0,0 +1,106 @@
+/****************************************************************************************
+** Sparse matrix, in the CSR (compressed sparse row) format, with the indices of the active
+** features of a sequence of frames, one row per frame, and the action taken and the reward
+** observed in each frame. It is how features extracted offline (see tools/features) are
+** stored, so batch learners and analysis scripts do not need the emulator. The file is:
+**
+**   FeatureMatrixHeader | indices (int32, numNonZeros) | indptr (uint64, numRows + 1)
+**                       | actions (int32, numRows)     | rewards (int32, numRows)
+**
+** The active features of row i are indices[indptr[i]], ..., indices[indptr[i + 1] - 1], in
+** the order the Features object returned them. The format is the one used by scipy, e.g.
+** scipy.sparse.csr_matrix((ones, indices, indptr), shape=(numRows, numColumns)).
+**
+** REMARKS: - All integers are in the byte order of the machine that wrote the file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define FEATURE_MATRIX_MAGIC    "ALEF"
+#define FEATURE_MATRIX_VERSION  1
+
+/**
+ * Header at the beginning of the file, written when the file is closed.
+ */
+struct FeatureMatrixHeader{
+	char magic[4];              //FEATURE_MATRIX_MAGIC
+	uint32_t version;           //FEATURE_MATRIX_VERSION
+	uint32_t numRows;           //Number of frames
+	uint32_t numColumns;        //Number of features of the representation
+	uint64_t numNonZeros;       //Total number of active features
+	uint64_t indptrOffset;      //Position of indptr in the file, the other arrays follow it
+};
+
+class FeatureMatrixWriter{
+	private:
+		FILE *file;
+		FeatureMatrixHeader header;
+		std::vector<uint64_t> indptr;
+		std::vector<int32_t> actions;
+		std::vector<int32_t> rewards;
+
+		/**
+ 		* Constructor declared as private to force the user to inform the file to be written.
+ 		*/
+		FeatureMatrixWriter();
+	public:
+		/**
+ 		* Constructor, it creates the file.
+ 		*
+ 		* @param string path name of the file to be written
+ 		* @param int numFeatures number of features of the representation, i.e., of columns
+ 		*/
+		FeatureMatrixWriter(const std::string &path, int numFeatures);
+		/**
+ 		* @return bool false if the file could not be created
+ 		*/
+		bool isOpen();
+		/**
+ 		* Appends a row to the matrix. The indices are written right away, the rest of the
+ 		* rows is kept in memory (16 bytes per row) until the file is closed.
+ 		*
+ 		* @param vector<int>& features indices of the active features of the frame
+ 		* @param int action action taken in the frame
+ 		* @param int reward reward observed in the frame
+ 		*/
+		void addRow(const std::vector<int> &features, int action, int reward);
+		/**
+ 		* Writes indptr, the actions and the rewards, and the header with the final sizes.
+ 		* It is called by the destructor if it was not called before.
+ 		*/
+		void close();
+		/**
+		* Destructor, it closes the file.
+		*/
+		~FeatureMatrixWriter();
+};
+
+class FeatureMatrix{
+	public:
+		int numColumns;                 //Number of features of the representation
+		std::vector<uint64_t> indptr;   //Row i is indices[indptr[i]] to indices[indptr[i + 1] - 1]
+		std::vector<int32_t> indices;   //Indices of the active features of all rows
+		std::vector<int32_t> actions;   //Action of each row
+		std::vector<int32_t> rewards;   //Reward of each row
+
+		/**
+ 		* @return int number of rows, i.e., of frames
+ 		*/
+		int getNumRows(){
+			return actions.size();
+		}
+		/**
+ 		* Reads a file written by FeatureMatrixWriter.
+ 		*
+ 		* @param string path name of the file to be read
+ 		*
+ 		* @return bool false if the file could not be opened or was not written by FeatureMatrixWriter
+ 		*/
+		bool read(const std::string &path);
+};
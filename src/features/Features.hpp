@@ -73,6 +73,16 @@ class Features{
  		*/
 		virtual int getNumberOfFeatures() = 0;
 		/**
+ 		* This pure virtual method must be implemented by every class inhereting from this one.
+ 		* It returns a new object of the same representation, with the same parameters. It is
+ 		* used when several threads extract features at the same time, each thread owning its
+ 		* own copy. The caller is responsible for deleting the returned object.
+ 		*
+ 		* @param none
+ 		* @return Features* new feature extractor equivalent to this one.
+ 		*/
+		virtual Features* clone() = 0;
+		/**
 		* Destructor, not necessary in this class.
 		*/
 		virtual ~Features();
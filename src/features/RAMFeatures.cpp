@@ -54,4 +54,8 @@ int RAMFeatures::getNumberOfFeatures(){
 	return BITS_RAM + 1;
 }
 
+Features* RAMFeatures::clone(){
+	return new RAMFeatures();
+}
+
 RAMFeatures::~RAMFeatures(){}
@@ -48,6 +48,13 @@ class RAMFeatures : public Features::Features{
  		*/
 		int getNumberOfFeatures();
 		/**
+ 		* Creates a new RAMFeatures object with the same parameters as this one.
+ 		*
+ 		* @param none.
+ 		* @return Features* new feature extractor, to be deleted by the caller.
+ 		*/
+		Features* clone();
+		/**
 		* Destructor, not necessary in this class.
 		*/
 		~RAMFeatures();
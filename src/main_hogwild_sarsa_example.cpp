@@ -0,0 +1,79 @@
+/****************************************************************************************
+** Starting point for running the multi-threaded Sarsa algorithm. Here the parameters are set, the algorithm
+** is started, as well as the features used. In fact, in order to create a new learning
+** algorithm, once its class is implementend, the main file just need to instantiate
+** Parameters, the Learner and the type of Features to be used. This file is a good 
+** example of how to do it. A parameters file example can be seen in ../conf/sarsa.cfg.
+** This is an example for other people to use: multi-threaded (Hogwild!) Sarsa with Basic
+** Features. The number of workers is defined by NUM_THREADS in the configuration file.
+** 
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "common/Parameters.hpp"
+#endif
+#ifndef HOGWILD_SARSA_H
+#define HOGWILD_SARSA_H
+#include "agents/rl/hogwild_sarsa/HogwildSarsaLearner.hpp"
+#endif
+#ifndef BASIC_H
+#define BASIC_H
+#include "features/BasicFeatures.hpp"
+#endif
+
+void printBasicInfo(Parameters param){
+	printf("Seed: %d\n", param.getSeed());
+	printf("\nCommand Line Arguments:\nPath to Config. File: %s\nPath to ROM File: %s\nPath to Backg. File: %s\n", 
+		param.getConfigPath().c_str(), param.getRomPath().c_str(), param.getPathToBackground().c_str());
+	if(param.getSubtractBackground()){
+		printf("\nBackground will be subtracted...\n");
+	}
+	printf("\nParameters read from Configuration File:\n");
+	printf("alpha:   %f\ngamma:   %f\nepsilon: %f\nlambda:  %f\nep. length: %d\nworkers: %d\n\n", 
+		param.getAlpha(), param.getGamma(), param.getEpsilon(), param.getLambda(), 
+		param.getEpisodeLength(), param.getNumThreads());
+}
+
+
+int main(int argc, char** argv){
+	//Reading parameters from file defined as input in the run command:
+	Parameters param(argc, argv);
+	
+	//Using Basic features:
+	BasicFeatures features(&param);
+	//Reporting parameters read:
+	printBasicInfo(param);
+	
+	ALEInterface ale(param.getDisplay());
+
+	ale.setFloat("stochasticity", 0.00);
+	ale.setInt("random_seed", param.getSeed());
+	ale.setFloat("frame_skip", param.getNumStepsPerAction());
+	ale.setInt("max_num_frames_per_episode", param.getEpisodeLength());
+#ifdef __SYNTHETIC
+	ale.setInt("synthetic_fps", param.getSyntheticFps());
+	ale.setInt("synthetic_coin_reward", param.getSyntheticReward());
+	ale.setInt("synthetic_sprite_period", param.getSyntheticSpritePeriod());
+#endif
+
+	ale.loadROM(param.getRomPath().c_str());
+
+	//Instantiating the learning algorithm:
+	HogwildSarsaLearner sarsaLearner(ale, &features, &param);
+    //Learn a policy:
+    sarsaLearner.learnPolicy(ale, &features);
+    if(sarsaLearner.hasDiverged()){
+        return 0;
+    }
+
+    printf("\n\n== Evaluation without Learning == \n\n");
+    sarsaLearner.evaluatePolicy(ale, &features);
+	
+    return 0;
+}
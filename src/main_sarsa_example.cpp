@@ -43,7 +43,6 @@ void printBasicInfo(Parameters param){
 int main(int argc, char** argv){
 	//Reading parameters from file defined as input in the run command:
 	Parameters param(argc, argv);
-	srand(param.getSeed());
 	
 	//Using Basic features:
 	BasicFeatures features(&param);
@@ -56,6 +55,11 @@ int main(int argc, char** argv){
 	ale.setInt("random_seed", param.getSeed());
 	ale.setFloat("frame_skip", param.getNumStepsPerAction());
 	ale.setInt("max_num_frames_per_episode", param.getEpisodeLength());
+#ifdef __SYNTHETIC
+	ale.setInt("synthetic_fps", param.getSyntheticFps());
+	ale.setInt("synthetic_coin_reward", param.getSyntheticReward());
+	ale.setInt("synthetic_sprite_period", param.getSyntheticSpritePeriod());
+#endif
 
 	ale.loadROM(param.getRomPath().c_str());
 
@@ -63,6 +67,9 @@ int main(int argc, char** argv){
 	SarsaLearner sarsaLearner(ale, &features, &param);
     //Learn a policy:
     sarsaLearner.learnPolicy(ale, &features);
+    if(sarsaLearner.hasDiverged()){
+        return 0;
+    }
 
     printf("\n\n== Evaluation without Learning == \n\n");
     sarsaLearner.evaluatePolicy(ale, &features);
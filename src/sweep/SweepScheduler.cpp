@@ -0,0 +1,133 @@
+/****************************************************************************************
+** Expansion of a grid of parameters into runs, and scheduling of these runs in a pool of
+** threads with a memory budget.
+**
+** REMARKS: - All methods' high-level comments are in the .hpp file.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef SWEEP_SCHEDULER_H
+#define SWEEP_SCHEDULER_H
+#include "SweepScheduler.hpp"
+#endif
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "../common/ThreadPool.hpp"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <algorithm>
+
+SweepScheduler::SweepScheduler(std::string path){
+	numThreads = 1;
+	memoryBudget = 0;
+	memoryInUse = 0;
+
+	std::ifstream file(path.c_str());
+	if(!file.is_open()){
+		printf("Unable to open the file '%s', defined as the grid of the sweep.\n", path.c_str());
+		return;
+	}
+	std::string line;
+	while(getline(file, line)){
+		//White spaces are ignored, as in the configuration files:
+		line.erase(std::remove(line.begin(), line.end(), ' '), line.end());
+		line.erase(std::remove(line.begin(), line.end(), '\t'), line.end());
+		size_t pos = line.find("=");
+		if(line.empty() || line[0] == '#' || pos == std::string::npos){
+			continue;
+		}
+		std::string key = line.substr(0, pos);
+		std::string list = line.substr(pos + 1);
+		if(key == "SWEEP_THREADS"){
+			numThreads = std::max(1, atoi(list.c_str()));
+		}
+		else if(key == "SWEEP_MEMORY_MB"){
+			memoryBudget = (size_t) atol(list.c_str()) << 20;
+		}
+		else{
+			std::vector<std::string> keyValues;
+			while((pos = list.find(",")) != std::string::npos){
+				keyValues.push_back(list.substr(0, pos));
+				list.erase(0, pos + 1);
+			}
+			keyValues.push_back(list);
+			keys.push_back(key);
+			values.push_back(keyValues);
+		}
+	}
+	file.close();
+}
+
+std::vector<SweepRun> SweepScheduler::expand(){
+	std::vector<SweepRun> runs;
+	//Counter in which each digit is the index of the value of a key, the last key changing the fastest:
+	std::vector<unsigned int> digits(keys.size(), 0);
+	bool isDone = false;
+	while(!isDone){
+		SweepRun run;
+		run.index = runs.size();
+		run.memoryBytes = 0;
+		for(unsigned int k = 0; k < keys.size(); k++){
+			run.values[keys[k]] = values[k][digits[k]];
+		}
+		runs.push_back(run);
+
+		isDone = true;
+		for(int k = keys.size() - 1; k >= 0 && isDone; k--){
+			digits[k]++;
+			if(digits[k] < values[k].size()){
+				isDone = false;
+			}
+			else{
+				digits[k] = 0;
+			}
+		}
+	}
+	return runs;
+}
+
+void SweepScheduler::reserveMemory(size_t memoryBytes){
+	std::unique_lock<std::mutex> lock(mutex);
+	memoryReleased.wait(lock, [&]{
+		return memoryBudget == 0 || memoryInUse == 0 || memoryInUse + memoryBytes <= memoryBudget;
+	});
+	memoryInUse += memoryBytes;
+}
+
+void SweepScheduler::releaseMemory(size_t memoryBytes){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		memoryInUse -= memoryBytes;
+	}
+	memoryReleased.notify_all();
+}
+
+void SweepScheduler::run(std::vector<SweepRun> &runs, const std::function<void(SweepRun&)> &execute){
+	//The largest runs are started first, the grid order is kept among runs of the same size:
+	std::vector<int> order(runs.size());
+	for(unsigned int i = 0; i < runs.size(); i++){
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b){
+		return runs[a].memoryBytes > runs[b].memoryBytes;
+	});
+
+	ThreadPool pool(numThreads);
+	pool.parallelFor(runs.size(), [&](int i, int worker){
+		SweepRun &run = runs[order[i]];
+		reserveMemory(run.memoryBytes);
+		execute(run);
+		releaseMemory(run.memoryBytes);
+	});
+}
+
+const std::vector<std::string>& SweepScheduler::getKeys(){
+	return keys;
+}
+
+int SweepScheduler::getNumThreads(){
+	return numThreads;
+}
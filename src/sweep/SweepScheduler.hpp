@@ -0,0 +1,95 @@
+/****************************************************************************************
+** Expansion of a grid of parameters into runs, and scheduling of these runs in a pool of
+** threads with a memory budget. The grid is read from a file with the same syntax as the
+** configuration files, but each key receives a list of values separated by commas, e.g.:
+**
+**     ALPHA    = 0.5, 0.1, 0.05
+**     LAMBDA   = 0.5, 0.9
+**     SEED     = 1, 2, 3
+**
+** Each run takes one value of each key, and all combinations are run (18 runs above), the
+** first key of the file changing the slowest. Keys starting with SWEEP_ are not part of the
+** grid, they configure the scheduler:
+**   - SWEEP_THREADS: number of runs executed at the same time (1 by default);
+**   - SWEEP_MEMORY_MB: memory the runs executed at the same time may use, 0 for no limit.
+**
+** The runs are started in decreasing order of estimated memory and the threads pick the next
+** run as soon as they are done with the previous one, so the large runs (e.g. with B-PRO
+** features) do not end up alone at the end of the sweep. A run only starts when its estimate
+** fits in what is left of the budget; a run larger than the whole budget runs alone.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * A point of the grid.
+ */
+struct SweepRun{
+	int index;                                   //Position of the run in the grid
+	std::map<std::string, std::string> values;   //Value of each key of the grid
+	size_t memoryBytes;                          //Estimated memory used by the run, 0 if unknown
+};
+
+class SweepScheduler{
+	private:
+		std::vector<std::string> keys;                   //Keys of the grid, in the order of the file
+		std::vector<std::vector<std::string> > values;   //Values of each key of the grid
+		int numThreads;
+		size_t memoryBudget;                             //0 means there is no limit
+		size_t memoryInUse;                              //Estimated memory of the runs being executed
+		std::mutex mutex;
+		std::condition_variable memoryReleased;
+
+		/**
+ 		* Constructor declared as private to force the user to inform the grid.
+ 		*/
+		SweepScheduler();
+		/**
+ 		* Waits until the estimated memory of a run fits in the budget and reserves it.
+ 		*
+ 		* @param size_t memoryBytes estimated memory of the run
+ 		*/
+		void reserveMemory(size_t memoryBytes);
+		/**
+ 		* Gives back the memory reserved for a run.
+ 		*
+ 		* @param size_t memoryBytes estimated memory of the run
+ 		*/
+		void releaseMemory(size_t memoryBytes);
+	public:
+		/**
+ 		* Constructor. It reads the grid and the settings of the scheduler.
+ 		*
+ 		* @param std::string path path to the file with the grid
+ 		*/
+		SweepScheduler(std::string path);
+		/**
+ 		* @return std::vector<SweepRun> all points of the grid, with unknown memory
+ 		*/
+		std::vector<SweepRun> expand();
+		/**
+ 		* Executes all runs, SWEEP_THREADS at a time, respecting the memory budget. It only
+ 		* returns once all runs are done.
+ 		*
+ 		* @param std::vector<SweepRun>& runs runs to be executed, with their estimated memory
+ 		* @param std::function<void(SweepRun&)> execute function that executes a run, it is
+ 		*        called by several threads at the same time
+ 		*/
+		void run(std::vector<SweepRun> &runs, const std::function<void(SweepRun&)> &execute);
+		/**
+ 		* @return std::vector<std::string> keys of the grid, in the order of the file
+ 		*/
+		const std::vector<std::string>& getKeys();
+		/**
+ 		* @return int number of runs executed at the same time
+ 		*/
+		int getNumThreads();
+};
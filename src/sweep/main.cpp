@@ -0,0 +1,279 @@
+/****************************************************************************************
+** Sweep over a grid of parameters in a single process. The configuration file and the
+** ROM are the ones informed in the command line, as for the learner, and the grid is given
+** with -g (see SweepScheduler.hpp for its syntax and ../conf/sweep.cfg for an example), e.g.:
+**     ./sweeper -s 1 -c ../conf/sarsa.cfg -r pong.bin -g ../conf/sweep.cfg > results.csv
+**
+** Besides the keys of the configuration file, the grid may have the keys LEARNER (SARSA,
+** QLEARNING or TRUE_ONLINE_SARSA, SARSA by default) and FEATURES (BASIC, BASS, BPRO or RAM,
+** BASIC by default). The configuration file is only read once and each run receives a copy
+** of the parameters with the values of the grid. The runs with the same background file
+** share it (see features/Background.hpp).
+**
+** The memory of a run is estimated as the weights and traces of the linear learners, one of
+** each per feature and action, which dominates when using B-PRO features.
+**
+** REMARKS: - The episodes of each run are not printed, they are saved in the binary file
+**            EPISODE_LOG_FILE.<run> (sweep_<run>.log if EPISODE_LOG_FILE is not set). The
+**            summary of each run is printed as CSV to stdout and the progress to stderr.
+**          - Every file a run writes has the index of the run in its name, since runs that only
+**            differ in ALPHA, LAMBDA or EPSILON have the same seed: START_STATES_FILE becomes
+**            <name>.<run>.<extension>, and the weights saved with -w <name>.<run>.<seed>.wgt.
+**            The start states are then generated once per run and reused by later sweeps over
+**            the same grid.
+**          - The online evaluation and the recording of frames are disabled in the runs,
+**            since all runs would write to the same file. So is the profile (PROFILE_FILE):
+**            the profiler keeps the times of every thread of the process, so the profile of a
+**            run would also have those of the runs before it and of the ones running with it.
+**          - The ALE reads the ROM from its path, so it is not shared between the runs.
+**          - A run whose Q-values diverge stops without ending the others, its summary covers the
+**            episodes completed before and has 1 in the column diverged.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../common/Parameters.hpp"
+#endif
+#ifndef METRICS_LOG_H
+#define METRICS_LOG_H
+#include "../common/MetricsLog.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "../environment/ALEFactory.hpp"
+#endif
+#ifndef SWEEP_SCHEDULER_H
+#define SWEEP_SCHEDULER_H
+#include "SweepScheduler.hpp"
+#endif
+#ifndef BASIC_FEATURES_H
+#define BASIC_FEATURES_H
+#include "../features/BasicFeatures.hpp"
+#endif
+#ifndef BASS_FEATURES_H
+#define BASS_FEATURES_H
+#include "../features/BASSFeatures.hpp"
+#endif
+#ifndef BPRO_FEATURES_H
+#define BPRO_FEATURES_H
+#include "../features/BPROFeatures.hpp"
+#endif
+#ifndef RAM_FEATURES_H
+#define RAM_FEATURES_H
+#include "../features/RAMFeatures.hpp"
+#endif
+#ifndef SARSA_H
+#define SARSA_H
+#include "../agents/rl/sarsa/SarsaLearner.hpp"
+#endif
+#ifndef Q_H
+#define Q_H
+#include "../agents/rl/qlearning/QLearner.hpp"
+#endif
+#ifndef TRUE_ONLINE_SARSA_H
+#define TRUE_ONLINE_SARSA_H
+#include "../agents/rl/true_online_sarsa/TrueOnlineSarsaLearner.hpp"
+#endif
+#include <stdio.h>
+#include <sstream>
+#include <chrono>
+#include <mutex>
+
+using namespace std;
+
+/**
+ * Summary of a run, computed from the metrics of its episodes.
+ */
+struct SweepResult{
+	int numEpisodes;
+	int numFrames;
+	double avgReturn;           //Average return of all learning episodes
+	double finalReturn;         //Average return of the last 10% of the learning episodes
+	double seconds;
+	bool diverged;              //The learner stopped because its Q-values diverged
+};
+
+/**
+ * @return string path with ".<run>" before its extension, or at its end if it has none
+ */
+string runPath(const string &path, int run){
+	stringstream ss;
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of('/');
+	if(dot == string::npos || (slash != string::npos && dot < slash)){
+		ss << path << "." << run;
+	}
+	else{
+		ss << path.substr(0, dot) << "." << run << path.substr(dot);
+	}
+	return ss.str();
+}
+
+/**
+ * @return Features* new feature extractor, NULL if the name is unknown
+ */
+Features* createFeatures(const string &name, Parameters *param){
+	if(name == "BASIC"){
+		return new BasicFeatures(param);
+	}
+	else if(name == "BASS"){
+		return new BASSFeatures(param);
+	}
+	else if(name == "BPRO"){
+		return new BPROFeatures(param);
+	}
+	else if(name == "RAM"){
+		return new RAMFeatures();
+	}
+	return NULL;
+}
+
+/**
+ * @return bool true if the Q-values of the learner diverged
+ */
+template<class Learner>
+bool learn(ALEInterface &ale, Features *features, Parameters *param){
+	Learner learner(ale, features, param);
+	learner.learnPolicy(ale, features);
+	return learner.hasDiverged();
+}
+
+/**
+ * Learns with the parameters of a run and summarizes its episodes.
+ */
+SweepResult executeRun(const string &learnerName, const string &featuresName, Parameters *param){
+	double begin = chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+	ALEInterface *ale = ALEFactory::createALE(param, param->getSeed());
+	Features *features = createFeatures(featuresName, param);
+	SweepResult result;
+	if(learnerName == "QLEARNING"){
+		result.diverged = learn<QLearner>(*ale, features, param);
+	}
+	else if(learnerName == "TRUE_ONLINE_SARSA"){
+		result.diverged = learn<TrueOnlineSarsaLearner>(*ale, features, param);
+	}
+	else{
+		result.diverged = learn<SarsaLearner>(*ale, features, param);
+	}
+	delete features;
+	delete ale;
+
+	vector<EpisodeMetrics> episodes;
+	MetricsLog::readAll(param->getEpisodeLogPath(), episodes);
+	result.numEpisodes = episodes.size();
+	result.numFrames = episodes.empty() ? 0 : episodes.back().totalFrames;
+	result.avgReturn = result.finalReturn = 0;
+	int numFinal = max(1, result.numEpisodes / 10);
+	for(int i = 0; i < result.numEpisodes; i++){
+		result.avgReturn += episodes[i].episodeReturn / result.numEpisodes;
+		if(i >= result.numEpisodes - numFinal){
+			result.finalReturn += episodes[i].episodeReturn / numFinal;
+		}
+	}
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count() - begin;
+	return result;
+}
+
+int main(int argc, char** argv){
+	Parameters param(argc, argv);
+	if(param.getSweepPath().empty()){
+		fprintf(stderr, "The grid of the sweep must be informed with -g.\n");
+		return 1;
+	}
+	SweepScheduler sweep(param.getSweepPath());
+	vector<SweepRun> runs = sweep.expand();
+	const vector<string> &keys = sweep.getKeys();
+
+	//The number of actions is needed to estimate the memory of each run:
+	ALEInterface *ale = ALEFactory::createALE(&param, param.getSeed());
+	int numMinimalActions = ale->getMinimalActionSet().size();
+	int numLegalActions = ale->getLegalActionSet().size();
+	delete ale;
+
+	vector<Parameters> variants;
+	vector<string> learnerNames, featuresNames;
+	for(unsigned int r = 0; r < runs.size(); r++){
+		map<string, string> values = runs[r].values;
+		learnerNames.push_back(values.count("LEARNER") ? values["LEARNER"] : "SARSA");
+		featuresNames.push_back(values.count("FEATURES") ? values["FEATURES"] : "BASIC");
+		values.erase("LEARNER");
+		values.erase("FEATURES");
+		//Each run has its own file of episodes, and nothing that would be shared by the runs is written:
+		stringstream episodeLog;
+		if(param.getEpisodeLogPath().empty()){
+			episodeLog << "sweep_" << r << ".log";
+		}
+		else{
+			episodeLog << param.getEpisodeLogPath() << "." << r;
+		}
+		values["EPISODE_LOG_FILE"] = episodeLog.str();
+		//The other files are also written by each run, even when they are given in the grid:
+		string startStatesPath = values.count("START_STATES_FILE") ? values["START_STATES_FILE"] : param.getStartStatesPath();
+		if(!startStatesPath.empty()){
+			values["START_STATES_FILE"] = runPath(startStatesPath, r);
+		}
+		if(param.getToSaveWeightsAfterLearning()){
+			stringstream weights;
+			weights << param.getFileWithWeights() << "." << r << ".";
+			values["WEIGHTS_FILE"] = weights.str();
+		}
+		values["PRINT_EPISODES"] = "0";
+		values["ONLINE_EVAL_FREQUENCY"] = "0";
+		values["CORPUS_FILE"] = "";
+		values["PROFILE_FILE"] = "";
+		variants.push_back(param.withValues(values));
+	}
+	//The backgrounds are kept loaded during the whole sweep, so each file is only read once:
+	vector<shared_ptr<Background> > backgrounds;
+	for(unsigned int r = 0; r < runs.size(); r++){
+		if(variants[r].getSubtractBackground()){
+			backgrounds.push_back(Background::load(&variants[r]));
+		}
+		Features *features = createFeatures(featuresNames[r], &variants[r]);
+		if(features == NULL || (learnerNames[r] != "SARSA" && learnerNames[r] != "QLEARNING"
+			&& learnerNames[r] != "TRUE_ONLINE_SARSA")){
+			fprintf(stderr, "Unknown learner '%s' or features '%s' in the grid.\n",
+				learnerNames[r].c_str(), featuresNames[r].c_str());
+			return 1;
+		}
+		int numActions = variants[r].isMinimalAction() ? numMinimalActions : numLegalActions;
+		//The linear learners keep a weight and a trace per feature and action:
+		runs[r].memoryBytes = (sizeof(weight_t) + sizeof(trace_t)) * (size_t) numActions * features->getNumberOfFeatures();
+		delete features;
+	}
+	fprintf(stderr, "Sweep with %d runs, %d at a time.\n", (int) runs.size(), sweep.getNumThreads());
+
+	vector<SweepResult> results(runs.size());
+	mutex progressMutex;
+	int numDone = 0;
+	sweep.run(runs, [&](SweepRun &run){
+		int r = run.index;
+		results[r] = executeRun(learnerNames[r], featuresNames[r], &variants[r]);
+		lock_guard<mutex> lock(progressMutex);
+		numDone++;
+		fprintf(stderr, "[%d/%d] run %d: %d episodes, avg. return: %.1f, final return: %.1f, %.0f s%s\n", numDone,
+			(int) runs.size(), r, results[r].numEpisodes, results[r].avgReturn, results[r].finalReturn, results[r].seconds,
+			results[r].diverged ? ", diverged" : "");
+	});
+
+	printf("run");
+	for(unsigned int k = 0; k < keys.size(); k++){
+		printf(",%s", keys[k].c_str());
+	}
+	printf(",episodes,frames,avg_return,final_return,memory_mb,seconds,diverged\n");
+	for(unsigned int r = 0; r < runs.size(); r++){
+		printf("%d", r);
+		for(unsigned int k = 0; k < keys.size(); k++){
+			printf(",%s", runs[r].values[keys[k]].c_str());
+		}
+		printf(",%d,%d,%f,%f,%.1f,%.3f,%d\n", results[r].numEpisodes, results[r].numFrames, results[r].avgReturn,
+			results[r].finalReturn, runs[r].memoryBytes / 1048576.0, results[r].seconds, results[r].diverged ? 1 : 0);
+	}
+	return 0;
+}
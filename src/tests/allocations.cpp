@@ -0,0 +1,215 @@
+/****************************************************************************************
+** Checks that the learners and the feature extractors do not allocate memory in their
+** steps once they are warmed up (make check_allocations). operator new is replaced by one
+** that counts the allocations, and:
+**   - Sarsa, Q-learning and True Online Sarsa learn on the synthetic game with Basic
+**     features for TOTAL_FRAMES_LEARN frames, the allocations being counted between two
+**     consecutive extractions of features, which the learners do once per step;
+**   - the BASS and B-PRO extractors are called on every screen of a game played with a
+**     uniformly random policy, as these features are too many to learn with them here.
+** After the first WARM_UP_STEPS steps of each of them, no step can allocate memory, e.g.:
+**     ./allocations -s 1 -c tests/allocations.cfg -r pong.bin
+**
+** REMARKS: - The first extraction of an episode is not counted, since the end of an
+**            episode (metrics, reset of the game, saving the weights) may allocate.
+**          - Only what is allocated with new is counted, that is, the STL containers.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../common/Parameters.hpp"
+#endif
+#ifndef RANDOM_H
+#define RANDOM_H
+#include "../common/Random.hpp"
+#endif
+#ifndef ALE_FACTORY_H
+#define ALE_FACTORY_H
+#include "../environment/ALEFactory.hpp"
+#endif
+#ifndef BASIC_FEATURES_H
+#define BASIC_FEATURES_H
+#include "../features/BasicFeatures.hpp"
+#endif
+#ifndef BASS_FEATURES_H
+#define BASS_FEATURES_H
+#include "../features/BASSFeatures.hpp"
+#endif
+#ifndef BPRO_FEATURES_H
+#define BPRO_FEATURES_H
+#include "../features/BPROFeatures.hpp"
+#endif
+#ifndef SARSA_H
+#define SARSA_H
+#include "../agents/rl/sarsa/SarsaLearner.hpp"
+#endif
+#ifndef Q_H
+#define Q_H
+#include "../agents/rl/qlearning/QLearner.hpp"
+#endif
+#ifndef TRUE_ONLINE_SARSA_H
+#define TRUE_ONLINE_SARSA_H
+#include "../agents/rl/true_online_sarsa/TrueOnlineSarsaLearner.hpp"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+#define WARM_UP_STEPS       500   //Steps in which the allocations are not checked
+#define NUM_FEATURES_STEPS  2000  //Screens the BASS and B-PRO features are extracted from
+
+using namespace std;
+
+static atomic<long> numAllocations(0);
+
+void* operator new(size_t size){
+	numAllocations++;
+	void *memory = malloc(size == 0 ? 1 : size);
+	if(memory == NULL){
+		throw bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void *memory) noexcept{
+	free(memory);
+}
+
+/**
+ * Allocations of the steps of a learner or extractor, after it is warmed up.
+ */
+struct AllocationCount{
+	int numSteps;
+	int numStepsAllocating;     //Steps in which something was allocated
+	long numAllocations;
+
+	AllocationCount(){
+		numSteps = numStepsAllocating = 0;
+		numAllocations = 0;
+	}
+	/**
+	 * @param long allocations number of allocations of a step
+	 */
+	void addStep(long allocations){
+		numSteps++;
+		if(allocations > 0){
+			numStepsAllocating++;
+			numAllocations += allocations;
+		}
+	}
+	/**
+	 * Prints the count and whether it passed.
+	 *
+	 * @return bool true if nothing was allocated
+	 */
+	bool report(const char *name){
+		printf("%-16s %6d steps after the warm-up, %6d allocating, %8ld allocations  %s\n", name, numSteps,
+			numStepsAllocating, numAllocations, numStepsAllocating == 0 && numSteps > 0 ? "OK" : "FAILED");
+		return numStepsAllocating == 0 && numSteps > 0;
+	}
+};
+
+/**
+ * Features that count what is allocated between two extractions. The learners extract the
+ * features of the next state once per step, so this is what a step allocates, including the
+ * extraction itself.
+ */
+class CountingFeatures : public Features{
+	private:
+		Features *features;
+		ALEInterface *ale;
+		AllocationCount *count;
+		long allocationsBefore;
+		int numExtractions;
+	public:
+		CountingFeatures(Features *features, ALEInterface *ale, AllocationCount *count){
+			this->features = features;
+			this->ale = ale;
+			this->count = count;
+			allocationsBefore = numAllocations;
+			numExtractions = 0;
+		}
+		void getActiveFeaturesIndices(const ALEScreen &screen, const ALERAM &ram, vector<int>& F){
+			long allocations = numAllocations - allocationsBefore;
+			numExtractions++;
+			if(numExtractions > WARM_UP_STEPS && ale->getEpisodeFrameNumber() > 0){
+				count->addStep(allocations);
+			}
+			allocationsBefore = numAllocations;
+			features->getActiveFeaturesIndices(screen, ram, F);
+		}
+		int getNumberOfFeatures(){
+			return features->getNumberOfFeatures();
+		}
+		Features* clone(){
+			return new CountingFeatures(features->clone(), ale, count);
+		}
+};
+
+/**
+ * Learns with Basic features, counting the allocations of each step.
+ */
+template<class Learner>
+bool checkLearner(const char *name, Parameters *param){
+	ALEInterface *ale = ALEFactory::createALE(param, param->getSeed());
+	BasicFeatures basic(param);
+	AllocationCount count;
+	CountingFeatures features(&basic, ale, &count);
+	Learner learner(*ale, &features, param);
+	learner.learnPolicy(*ale, &features);
+	delete ale;
+	return count.report(name);
+}
+
+/**
+ * Extracts the features of the screens of a game played with a uniformly random policy,
+ * counting the allocations of each extraction.
+ */
+bool checkFeatures(const char *name, Features *features, Parameters *param){
+	ALEInterface *ale = ALEFactory::createALE(param, param->getSeed());
+	ActionVect actions = ale->getMinimalActionSet();
+	Random rng(param->getSeed());
+	AllocationCount count;
+	vector<int> F;
+	for(int step = 0; step < NUM_FEATURES_STEPS; step++){
+		if(ale->game_over()){
+			ale->reset_game();
+		}
+		ale->act(actions[rng.nextInt(actions.size())]);
+		long allocationsBefore = numAllocations;
+		F.clear();
+		features->getActiveFeaturesIndices(ale->getScreen(), ale->getRAM(), F);
+		if(step >= WARM_UP_STEPS){
+			count.addStep(numAllocations - allocationsBefore);
+		}
+	}
+	delete ale;
+	return count.report(name);
+}
+
+int main(int argc, char** argv){
+	Parameters param(argc, argv);
+
+	bool passed = true;
+	passed = checkLearner<SarsaLearner>("Sarsa", &param) && passed;
+	passed = checkLearner<QLearner>("QLearning", &param) && passed;
+	passed = checkLearner<TrueOnlineSarsaLearner>("TrueOnlineSarsa", &param) && passed;
+
+	BASSFeatures bass(&param);
+	BPROFeatures bpro(&param);
+	passed = checkFeatures("BASS", &bass, &param) && passed;
+	passed = checkFeatures("BPRO", &bpro, &param) && passed;
+
+	if(!passed){
+		printf("Memory was allocated in the steps after the warm-up.\n");
+		return 1;
+	}
+	return 0;
+}
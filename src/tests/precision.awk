@@ -0,0 +1,184 @@
+# Compares the learning curves of the sweeps of the precision check (make check_precision). The files are,
+# for each precision, the summary printed by the sweeper followed by the episodes of each of its runs
+# converted to CSV by metrics2csv (<name>.<run>.csv), the sweep with doubles first, e.g.:
+#     awk -v binFrames=10000 -v tolerance=3 -v binTolerance=4 -f precision.awk \
+#         double.csv double.*.csv float.csv float.*.csv half.csv half.*.csv
+#
+# The frames learned are split in blocks of binFrames frames, only over the blocks all runs complete, and
+# each run has two curves: the average return of the episodes that end in each block, and the points per
+# thousand frames of these episodes, since a learner may get more points per episode only by surviving
+# longer. As all sweeps are over the same grid, each run is compared with the run with doubles of the same
+# index, that is, of the same learner and seed. For each learner, precision and curve, the averages over
+# the runs are printed and the check fails if:
+#   - the average difference between the curves is larger than tolerance standard errors;
+#   - the difference in a single block is larger than binTolerance standard errors;
+#   - the number of runs is not the same or a run diverged.
+#
+# REMARKS: - A single rounding difference changes the actions taken from then on, so the runs of the same
+#            seed only take the same actions in the beginning. Comparing them in pairs still removes most
+#            of the spread of the returns from one seed to the other, which is larger than the effect of
+#            the precision.
+#          - The runs are deterministic, so the result only changes with the code or the compiler.
+#
+# Author: Marlos C. Machado
+
+BEGIN {
+	FS = ","
+	curveNames[1] = "average return of the episodes"
+	curveNames[2] = "points per thousand frames of the episodes"
+}
+
+FNR == 1 {
+	delete column
+	for(i = 1; i <= NF; i++){
+		column[$i] = i
+	}
+	isSummary = ("run" in column)
+	if(isSummary){
+		file++
+		names[file] = FILENAME
+	}
+	else{
+		match(FILENAME, /\.[0-9]+\.csv$/)
+		run = substr(FILENAME, RSTART + 1, RLENGTH - 5)
+	}
+	next
+}
+
+isSummary {
+	run = $column["run"]
+	learner = $column["LEARNER"]
+	learners[learner] = 1
+	learnerOf[file, run] = learner
+	runs[file, learner]++
+	if($column["diverged"] == 1){
+		diverged[file, learner] = 1
+	}
+	else if(minFrames == 0 || $column["frames"] < minFrames){
+		minFrames = $column["frames"]
+	}
+	next
+}
+
+{
+	bin = int(($column["total_frames"] - 1) / binFrames)
+	returns[file, run, bin] += $column["return"]
+	frames[file, run, bin] += $column["frames"]
+	episodes[file, run, bin]++
+}
+
+# Value of a curve of a run in a block, -1 if no episode of the run ends in it:
+function curve(c, f, r, b){
+	if(episodes[f, r, b] == 0){
+		return -1
+	}
+	return c == 1 ? returns[f, r, b] / episodes[f, r, b] : 1000 * returns[f, r, b] / frames[f, r, b]
+}
+
+# Standard error of the mean of n values, given their sum and sum of squares:
+function standardError(n, total, squares,    mean, variance){
+	if(n < 2){
+		return 0
+	}
+	mean = total / n
+	variance = (squares - n * mean * mean) / (n - 1)
+	return sqrt((variance > 0 ? variance : 0) / n)
+}
+
+# Whether a difference is within limit standard errors; with no spread, only no difference is:
+function isWithin(difference, error, limit){
+	return error > 0 ? difference <= limit * error && -difference <= limit * error : difference == 0
+}
+
+# Prints a curve of a learner with every precision and compares them with the one with doubles:
+function compareCurves(learner, c,    f, b, r, n, total, squares, baseSum, valueSum, difference, base, value,
+		blockDifference, blockError, area, areaDifference, areaError, ok, worstBlock, allOk){
+	for(f = 2; f <= file; f++){
+		delete area
+		for(b = 0; b < numBins; b++){
+			n = total = squares = baseSum = valueSum = 0
+			for(r = 0; (1, r) in learnerOf; r++){
+				if(learnerOf[1, r] != learner || curve(c, 1, r, b) < 0 || curve(c, f, r, b) < 0){
+					continue
+				}
+				difference = curve(c, f, r, b) - curve(c, 1, r, b)
+				n++
+				total += difference
+				squares += difference * difference
+				baseSum += curve(c, 1, r, b)
+				valueSum += curve(c, f, r, b)
+				area[r] += difference / numBins
+			}
+			base[b] = n > 0 ? baseSum / n : 0
+			value[f, b] = n > 0 ? valueSum / n : 0
+			blockDifference[f, b] = n > 0 ? total / n : 0
+			blockError[f, b] = standardError(n, total, squares)
+		}
+		n = total = squares = 0
+		for(r in area){
+			n++
+			total += area[r]
+			squares += area[r] * area[r]
+		}
+		areaDifference[f] = n > 0 ? total / n : 0
+		areaError[f] = standardError(n, total, squares)
+		ok[f] = isWithin(areaDifference[f], areaError[f], tolerance)
+		worstBlock[f] = -1
+		for(b = 0; b < numBins; b++){
+			if(!isWithin(blockDifference[f, b], blockError[f, b], binTolerance)){
+				ok[f] = 0
+				if(worstBlock[f] < 0){
+					worstBlock[f] = b
+				}
+			}
+		}
+	}
+
+	printf("\n%s, %s ending in each block of %d frames:\n", learner, curveNames[c], binFrames)
+	printf("%16s %10s", "frames", "doubles")
+	for(f = 2; f <= file; f++){
+		printf("   %-31s", names[f])
+	}
+	printf("\n")
+	for(b = 0; b < numBins; b++){
+		printf("%7d - %6d %10.2f", b * binFrames, (b + 1) * binFrames, base[b])
+		for(f = 2; f <= file; f++){
+			printf("   %8.2f %+7.2f +- %-10.2f", value[f, b], blockDifference[f, b], blockError[f, b])
+		}
+		printf("\n")
+	}
+	allOk = 1
+	for(f = 2; f <= file; f++){
+		printf("%s: difference over the whole curve %+.2f +- %.2f (allowed %.2f)  %s\n",
+			names[f], areaDifference[f], areaError[f], tolerance * areaError[f], ok[f] ? "OK" : "FAILED")
+		if(worstBlock[f] >= 0){
+			printf("    the block starting at frame %d differs by more than %s standard errors\n",
+				worstBlock[f] * binFrames, binTolerance)
+		}
+		allOk = allOk && ok[f]
+	}
+	return allOk
+}
+
+END {
+	numBins = int(minFrames / binFrames)
+	failed = 0
+	for(learner in learners){
+		for(f = 2; f <= file; f++){
+			if(runs[f, learner] != runs[1, learner] || diverged[1, learner] || diverged[f, learner]){
+				printf("\n%s: %s has %d runs instead of %d, or a run diverged  FAILED\n", learner, names[f],
+					runs[f, learner], runs[1, learner])
+				failed = 1
+			}
+		}
+		for(c = 1; c <= 2; c++){
+			if(!compareCurves(learner, c)){
+				failed = 1
+			}
+		}
+	}
+	if(failed){
+		printf("\nThe learning curves with less precision differ from the ones with doubles.\n")
+	}
+	exit failed
+}
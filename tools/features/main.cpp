@@ -0,0 +1,244 @@
+/****************************************************************************************
+** Extracts the features of recorded frames and saves them in a sparse matrix (see
+** src/features/FeatureMatrix.hpp), so batch learners and analysis do not need the emulator.
+** The input is either:
+**   - a trajectory saved by the HumanAgent (see src/environment/Trajectory.hpp), which is
+**     replayed in an emulator without display to regenerate the frames; or
+**   - a corpus of frames recorded while learning (see src/environment/FrameCorpus.hpp).
+** The kind of input is detected from the file. The features are defined by the config file,
+** as for the learners, and extracted by NUM_THREADS threads, each with its own Features.
+**
+** Usage: ./dump_features -i input -o output -f BASS -s 1 -c ../../conf/sarsa.cfg -r pong.bin
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#ifndef ALE_INTERFACE_H
+#define ALE_INTERFACE_H
+#include <ale_interface.hpp>
+#endif
+#include "../../src/common/Graphics.hpp"
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+#include "../../src/common/Parameters.hpp"
+#endif
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include "../../src/common/ThreadPool.hpp"
+#endif
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+#include "../../src/environment/Trajectory.hpp"
+#endif
+#ifndef FRAME_CORPUS_H
+#define FRAME_CORPUS_H
+#include "../../src/environment/FrameCorpus.hpp"
+#endif
+#ifndef BASIC_FEATURES_H
+#define BASIC_FEATURES_H
+#include "../../src/features/BasicFeatures.hpp"
+#endif
+#ifndef BASS_FEATURES_H
+#define BASS_FEATURES_H
+#include "../../src/features/BASSFeatures.hpp"
+#endif
+#ifndef BPRO_FEATURES_H
+#define BPRO_FEATURES_H
+#include "../../src/features/BPROFeatures.hpp"
+#endif
+#ifndef RAM_FEATURES_H
+#define RAM_FEATURES_H
+#include "../../src/features/RAMFeatures.hpp"
+#endif
+#ifndef FEATURE_MATRIX_H
+#define FEATURE_MATRIX_H
+#include "../../src/features/FeatureMatrix.hpp"
+#endif
+
+#define FRAMES_PER_BATCH 1024   //Frames read before the threads extract their features
+
+using namespace std;
+string inputPath;
+string outputPath;
+string featuresName = "Basic";
+
+void printHelp(char** argv){
+	printf("Usage:    %s[OPTIONS]\n", argv[0]);
+	printf("   -i     %s[REQUIRED]%s path to the trajectory or corpus of frames to be read.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -o     %s[REQUIRED]%s path to the sparse matrix to be written.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -f     features to be extracted: Basic (default), BASS, BPRO or RAM.\n");
+	printf("   -s, -c, -r as in the learners, the config file defines the features and the number of threads.\n");
+	printf("   -h     print this help and exit\n");
+	printf("\n");
+}
+
+/**
+ * Reads the options of this tool, leaving in paramArgv the ones that must be given to Parameters.
+ */
+void readParameters(int argc, char** argv, vector<char*> &paramArgv){
+	paramArgv.push_back(argv[0]);
+	for(int i = 1; i < argc; i++){
+		string option = argv[i];
+		if(option == "-h"){
+			printHelp(argv);
+			exit(-1);
+		}
+		else if((option == "-i" || option == "-o" || option == "-f") && i + 1 < argc){
+			string &value = option == "-i" ? inputPath : (option == "-o" ? outputPath : featuresName);
+			value = argv[++i];
+		}
+		else{
+			paramArgv.push_back(argv[i]);
+		}
+	}
+	//Check if all parameters were properly set, otherwise interrupt
+	if(inputPath.compare("") == 0 || outputPath.compare("") == 0){
+		printHelp(argv);
+		exit(-1);
+	}
+}
+
+Features* createFeatures(Parameters *param){
+	if(featuresName == "Basic"){
+		return new BasicFeatures(param);
+	}
+	else if(featuresName == "BASS"){
+		return new BASSFeatures(param);
+	}
+	else if(featuresName == "BPRO"){
+		return new BPROFeatures(param);
+	}
+	else if(featuresName == "RAM"){
+		return new RAMFeatures();
+	}
+	return NULL;
+}
+
+/**
+ * Source of frames, either a trajectory replayed in the emulator or a corpus of frames.
+ */
+class FrameSource{
+	private:
+		ALEInterface *ale;
+		FrameCorpusReader *corpus;
+		TrajectoryHeader header;
+		vector<TrajectoryStep> steps;
+		unsigned int nextStep;
+		int episode;
+	public:
+		FrameSource(const string &path, Parameters *param){
+			ale = NULL;
+			corpus = NULL;
+			nextStep = 0;
+			if(TrajectoryWriter::readAll(path, header, steps)){
+				//Same settings used by main, with the values stored in the trajectory:
+				ale = new ALEInterface(false);
+				ale->setFloat("stochasticity", 0.00);
+				ale->setInt("random_seed", header.seed);
+				ale->setFloat("frame_skip", header.numStepsPerAction);
+				ale->setInt("max_num_frames_per_episode", header.episodeLength);
+				ale->loadROM(param->getRomPath().c_str());
+				episode = steps.empty() ? 0 : steps[0].episode;
+			}
+			else{
+				corpus = new FrameCorpusReader(path);
+			}
+		}
+		~FrameSource(){
+			delete ale;
+			delete corpus;
+		}
+		bool isOpen(){
+			return ale != NULL || corpus->isOpen();
+		}
+		int getHeight(){
+			return ale != NULL ? ale->getScreen().height() : corpus->getHeight();
+		}
+		int getWidth(){
+			return ale != NULL ? ale->getScreen().width() : corpus->getWidth();
+		}
+		bool next(ALEScreen &screen, ALERAM &ram, int &action, int &reward){
+			if(corpus != NULL){
+				return corpus->next(screen, ram, action, reward);
+			}
+			if(nextStep >= steps.size()){
+				return false;
+			}
+			TrajectoryStep &step = steps[nextStep++];
+			if(step.episode != episode){
+				ale->reset_game();
+				episode = step.episode;
+			}
+			action = step.action;
+			reward = ale->act((Action) step.action);
+			screen = ale->getScreen();
+			ram = ale->getRAM();
+			return true;
+		}
+};
+
+int main(int argc, char** argv){
+	vector<char*> paramArgv;
+	readParameters(argc, argv, paramArgv);
+	Parameters param(paramArgv.size(), &paramArgv[0]);
+
+	Features *features = createFeatures(&param);
+	if(features == NULL){
+		fprintf(stderr, "Unknown features '%s', they must be Basic, BASS, BPRO or RAM.\n", featuresName.c_str());
+		return -1;
+	}
+	FrameSource source(inputPath, &param);
+	if(!source.isOpen()){
+		fprintf(stderr, "Unable to read '%s', it is neither a trajectory nor a corpus of frames.\n", inputPath.c_str());
+		return -1;
+	}
+	FeatureMatrixWriter output(outputPath, features->getNumberOfFeatures());
+	if(!output.isOpen()){
+		return -1;
+	}
+
+	//Each thread owns its Features, since they keep internal buffers:
+	ThreadPool pool(param.getNumThreads());
+	vector<Features*> threadFeatures(pool.getNumThreads());
+	threadFeatures[0] = features;
+	for(unsigned int t = 1; t < threadFeatures.size(); t++){
+		threadFeatures[t] = features->clone();
+	}
+
+	vector<ALEScreen> screens(FRAMES_PER_BATCH, ALEScreen(source.getHeight(), source.getWidth()));
+	vector<ALERAM> rams(FRAMES_PER_BATCH);
+	vector<int> actions(FRAMES_PER_BATCH), rewards(FRAMES_PER_BATCH);
+	vector<vector<int> > F(FRAMES_PER_BATCH);
+	int numFrames = 0, numInBatch = 0;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	do{
+		numInBatch = 0;
+		while(numInBatch < FRAMES_PER_BATCH
+			&& source.next(screens[numInBatch], rams[numInBatch], actions[numInBatch], rewards[numInBatch])){
+			numInBatch++;
+		}
+		pool.parallelFor(numInBatch, [&](int i, int worker){
+			F[i].clear();
+			threadFeatures[worker]->getActiveFeaturesIndices(screens[i], rams[i], F[i]);
+		});
+		for(int i = 0; i < numInBatch; i++){
+			output.addRow(F[i], actions[i], rewards[i]);
+		}
+		numFrames += numInBatch;
+	}while(numInBatch == FRAMES_PER_BATCH);
+	output.close();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+	printf("%s features of %d frames written in %.2f seconds (%.0f frames per second).\n",
+		featuresName.c_str(), numFrames, seconds, numFrames / seconds);
+	for(unsigned int t = 0; t < threadFeatures.size(); t++){
+		delete threadFeatures[t];
+	}
+	return 0;
+}
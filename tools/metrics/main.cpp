@@ -0,0 +1,92 @@
+/****************************************************************************************
+** Converts the binary file written by the learners when EPISODE_LOG_FILE is set in the
+** configuration file (see src/common/MetricsLog.hpp) to CSV, with one line per episode.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include "../../src/common/Graphics.hpp"
+#include "../../src/common/MetricsLog.hpp"
+
+using namespace std;
+string inputPath;
+string outputPath;
+
+void printHelp(char** argv){
+	printf("Usage:    %s[OPTIONS]\n", argv[0]);
+	printf("   -i     %s[REQUIRED]%s path to the binary file written by the learner.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -o     path to the CSV file to be written, if not informed the CSV is printed.\n");
+	printf("   -h     print this help and exit\n");
+	printf("\n");
+}
+
+void readParameters(int argc, char** argv){
+	int option = 0;
+	while ((option = getopt(argc, argv, "i:o:h")) != -1)
+	{
+		switch(option)
+		{
+			case 'h':
+				printHelp(argv);
+				exit(-1);
+			case 'i':
+				inputPath = optarg;
+				break;
+			case 'o':
+				outputPath = optarg;
+				break;
+			case ':':
+			case '?':
+				fprintf(stderr, "Try `%s -h' for more information.\n", argv[0]);
+				exit(-1);
+			default:
+				break;
+		}
+	}
+	//Check if all parameters were properly set, otherwise interrupt
+	if(inputPath.compare("") == 0){
+		printHelp(argv);
+		exit(-1);
+	}
+}
+
+int main(int argc, char** argv){
+	readParameters(argc, argv);
+
+	vector<EpisodeMetrics> records;
+	if(!MetricsLog::readAll(inputPath, records)){
+		fprintf(stderr, "Unable to read '%s', it is not a file written by this version of the learners.\n",
+			inputPath.c_str());
+		return -1;
+	}
+
+	FILE *output = stdout;
+	if(outputPath.compare("") != 0){
+		output = fopen(outputPath.c_str(), "w");
+		if(output == NULL){
+			fprintf(stderr, "Unable to open the file '%s' to be written.\n", outputPath.c_str());
+			return -1;
+		}
+	}
+
+	fprintf(output, "episode,worker,frames,total_frames,steps,return,seconds,fps,avg_active_features,"
+		"max_active_features,avg_trace_size,max_trace_size,max_feat_vector_norm\n");
+	for(unsigned int i = 0; i < records.size(); i++){
+		EpisodeMetrics &m = records[i];
+		double fps = m.seconds > 0 ? m.frames / m.seconds : 0.0;
+		fprintf(output, "%d,%d,%d,%d,%d,%.1f,%.6f,%.0f,%.2f,%d,%.2f,%d,%d\n", m.episode, m.worker, m.frames,
+			m.totalFrames, m.numSteps, m.episodeReturn, m.seconds, fps, m.avgActiveFeatures,
+			m.maxActiveFeatures, m.avgTraceSize, m.maxTraceSize, m.maxFeatVectorNorm);
+	}
+
+	if(output != stdout){
+		fclose(output);
+	}
+	return 0;
+}
@@ -5,6 +5,8 @@
 
 #include "BPROFeatures.hpp"
 #include "../../src/common/Graphics.hpp"
+#include "../../src/common/Random.hpp"
+#include "../../src/agents/rl/QuantizedWeights.hpp"
 
 #define NUM_ROWS    14
 #define NUM_COLUMNS 16 
@@ -17,12 +19,15 @@
 using namespace std;
 string romPath;
 string wgtPath;
+string quantizedPath;
 int    seed;
+Random rng;                          //Random number generator, seeded with the seed from the command line
 
 ActionVect              actions;
 vector<int>             F;		     //Set of features active
 vector<double>          Q;           //Q(a) entries
 vector<vector<double> > w;           //Theta, weights vector
+QuantizedWeights *quantized = NULL;  //Used instead of w when the weights were quantized
 
 //Algorithm related:
 int currentAction;
@@ -34,14 +39,15 @@ void printHelp(char** argv){
 	printf("Usage:    %s[OPTIONS]\n", argv[0]);
 	printf("   -s     %s[REQUIRED]%s seed to random number generator.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
 	printf("   -r     %s[REQUIRED]%s path to the rom to be played by the agent.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
-	printf("   -w     %s[REQUIRED]%s path to file containing the weights to be loaded.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -w     %s[REQUIRED]%s path to file containing the weights to be loaded (or -q).\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -q     path to file containing quantized weights (saved when QUANTIZE_BITS is set), used instead of -w.\n");
 	printf("   -h     print this help and exit\n");
 	printf("\n");
 }
 
 void readParameters(int argc, char** argv){
 	int option = 0;
-	while ((option = getopt(argc, argv, "s:r:w:h")) != -1)
+	while ((option = getopt(argc, argv, "s:r:w:q:h")) != -1)
 	{
 		if (option == -1){
 			break;
@@ -57,6 +63,9 @@ void readParameters(int argc, char** argv){
 			case 'w':
 				wgtPath = optarg;
 				break;
+			case 'q':
+				quantizedPath = optarg;
+				break;
 			case 's':
 				seed = atoi(optarg);
 				break;
@@ -72,7 +81,7 @@ void readParameters(int argc, char** argv){
 		}
 	}
 	//Check if all parameters were properly set, otherwise interrupt	
-	if(romPath.compare("") == 0 || wgtPath.compare("") == 0 || seed == 0){
+	if(romPath.compare("") == 0 || (wgtPath.compare("") == 0 && quantizedPath.compare("") == 0) || seed == 0){
 		printHelp(argv);
 		exit(-1);
 	}
@@ -95,6 +104,10 @@ void loadWeights(string pathWeightsFileToLoad){
 }
 
 void updateQValues(){
+	if(quantized != NULL){
+		quantized->computeQValues(F, Q);
+		return;
+	}
 	for(int a = 0; a < numActions; a++){
 		double sumW = 0;
 		for(unsigned int i = 0; i < F.size(); i++){
@@ -123,16 +136,15 @@ int argmax(std::vector<double> array){
 	}
 	assert(indices.size() > 0);
 	//Now we randomly pick one of the best
-	return indices[rand()%indices.size()];
+	return indices[rng.nextInt(indices.size())];
 }
 
 int epsilonGreedy(){
 
 	int action = argmax(Q);
 	//With probability epsilon: a <- random action in A(s)
-	int random = rand();
-	if((random % int(nearbyint(1.0/epsilon))) == 0) {
-		action = rand() % numActions;
+	if(rng.nextDouble() < epsilon){
+		action = rng.nextInt(numActions);
 	}
 	return action;
 }
@@ -140,7 +152,7 @@ int epsilonGreedy(){
 int main(int argc, char** argv){
 
 	readParameters(argc, argv);
-	srand(seed);
+	rng = Random(seed);
 
 	//Initializing ALE:
 	ALEInterface ale(1);
@@ -157,13 +169,20 @@ int main(int argc, char** argv){
 	numFeatures = NUM_COLUMNS * NUM_ROWS * NUM_COLORS 
 					+ (2 * NUM_COLUMNS - 1) * (2 * NUM_ROWS - 1) * NUM_COLORS * NUM_COLORS + 1;
 
-	for(int i = 0; i < numActions; i++){
-		//Initialize Q;
-		Q.push_back(0);
-		w.push_back(vector<double>(numFeatures, 0.0));
+	Q.assign(numActions, 0);
+	//The quantized weights are sparse, so the full table of weights is never allocated:
+	if(quantizedPath.compare("") != 0){
+		quantized = new QuantizedWeights(quantizedPath);
+		assert(quantized->getNumActions() == numActions);
+		assert(quantized->getNumFeatures() == numFeatures);
+		printf("Quantized weights: %d bits, %.1f MB\n", quantized->getNumBits(), quantized->getNumBytes() / 1048576.0);
+	}
+	else{
+		for(int i = 0; i < numActions; i++){
+			w.push_back(vector<double>(numFeatures, 0.0));
+		}
+		loadWeights(wgtPath);
 	}
-
-	loadWeights(wgtPath);
 	int reward = 0;
 
 	while(!ale.game_over()){
@@ -0,0 +1,129 @@
+/****************************************************************************************
+** Replays a trajectory saved by the HumanAgent (see src/environment/Trajectory.hpp) in an
+** emulator without display, as fast as possible. The emulator is created with the settings
+** stored in the trajectory, so the same states are visited again. The rewards observed are
+** compared to the saved ones, which tells whether the replay diverged. Optionally the screens
+** and RAMs visited are saved in a corpus (see src/environment/FrameCorpus.hpp), to extract
+** features or to learn by imitation without running the emulator again.
+**
+** Author: Marlos C. Machado
+***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <getopt.h>
+
+#include <ale_interface.hpp>
+#include "../../src/common/Graphics.hpp"
+#include "../../src/environment/Trajectory.hpp"
+#include "../../src/environment/FrameCorpus.hpp"
+
+using namespace std;
+string inputPath;
+string romPath;
+string corpusPath;
+
+void printHelp(char** argv){
+	printf("Usage:    %s[OPTIONS]\n", argv[0]);
+	printf("   -i     %s[REQUIRED]%s path to the trajectory saved by the agent.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -r     %s[REQUIRED]%s path to the rom played when the trajectory was saved.\n", ANSI_COLOR_RED, ANSI_COLOR_RESET);
+	printf("   -o     path to the corpus of frames to be written, if not informed nothing is written.\n");
+	printf("   -h     print this help and exit\n");
+	printf("\n");
+}
+
+void readParameters(int argc, char** argv){
+	int option = 0;
+	while ((option = getopt(argc, argv, "i:r:o:h")) != -1)
+	{
+		switch(option)
+		{
+			case 'h':
+				printHelp(argv);
+				exit(-1);
+			case 'i':
+				inputPath = optarg;
+				break;
+			case 'r':
+				romPath = optarg;
+				break;
+			case 'o':
+				corpusPath = optarg;
+				break;
+			case ':':
+			case '?':
+				fprintf(stderr, "Try `%s -h' for more information.\n", argv[0]);
+				exit(-1);
+			default:
+				break;
+		}
+	}
+	//Check if all parameters were properly set, otherwise interrupt
+	if(inputPath.compare("") == 0 || romPath.compare("") == 0){
+		printHelp(argv);
+		exit(-1);
+	}
+}
+
+int main(int argc, char** argv){
+	readParameters(argc, argv);
+
+	TrajectoryHeader header;
+	vector<TrajectoryStep> steps;
+	if(!TrajectoryWriter::readAll(inputPath, header, steps)){
+		fprintf(stderr, "Unable to read '%s', it is not a trajectory written by this version of the agents.\n",
+			inputPath.c_str());
+		return -1;
+	}
+	if(romPath.find(header.rom) == string::npos){
+		fprintf(stderr, "Warning: the trajectory was saved playing '%s'.\n", header.rom);
+	}
+
+	//Same settings used by main, with the values stored in the trajectory:
+	ALEInterface ale(false);
+	ale.setFloat("stochasticity", 0.00);
+	ale.setInt("random_seed", header.seed);
+	ale.setFloat("frame_skip", header.numStepsPerAction);
+	ale.setInt("max_num_frames_per_episode", header.episodeLength);
+	ale.loadROM(romPath.c_str());
+
+	FrameCorpusWriter *corpus = NULL;
+	if(corpusPath.compare("") != 0){
+		corpus = new FrameCorpusWriter(corpusPath);
+	}
+
+	int episode = steps.empty() ? 0 : steps[0].episode;
+	int numEpisodes = steps.empty() ? 0 : 1, numDivergences = 0, firstDivergence = -1;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for(unsigned int i = 0; i < steps.size(); i++){
+		if(steps[i].episode != episode){
+			ale.reset_game();
+			episode = steps[i].episode;
+			numEpisodes++;
+		}
+		int frame = ale.getEpisodeFrameNumber();
+		int reward = ale.act((Action) steps[i].action);
+		if(reward != steps[i].reward || frame != steps[i].frame){
+			numDivergences++;
+			if(firstDivergence < 0){
+				firstDivergence = i;
+			}
+		}
+		if(corpus != NULL){
+			corpus->record(ale.getScreen(), ale.getRAM(), steps[i].action, reward);
+		}
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	delete corpus;
+
+	printf("%d steps in %d episodes replayed in %.2f seconds (%.0f steps per second).\n",
+		(int) steps.size(), numEpisodes, seconds, steps.size() / seconds);
+	if(numDivergences > 0){
+		printf("%d steps diverged from the trajectory, the first one is step %d.\n", numDivergences, firstDivergence);
+		return 1;
+	}
+	return 0;
+}